@@ -2875,6 +2875,20 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}, expectFail: true}
           ]
         },
+        {
+          testname: "lockWaitGraph",
+          command: {lockWaitGraph: 1},
+          skipSharded: true,
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [{resource: {cluster: true}, actions: ["serverStatus"]}]
+              },
+              {runOnDb: firstDbName, roles: {}, expectFail: true},
+              {runOnDb: secondDbName, roles: {}, expectFail: true}
+          ]
+        },
         {
           testname: "dataSize_1",
           command: {dataSize: firstDbName + ".x"},
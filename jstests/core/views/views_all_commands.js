@@ -245,6 +245,7 @@
         flushRouterConfig: {skip: isUnrelated},
         fsync: {skip: isUnrelated},
         fsyncUnlock: {skip: isUnrelated},
+        getChunkWriteHeat: {skip: isUnrelated},
         getDatabaseVersion: {skip: isUnrelated},
         geoNear: {
             command:
@@ -371,6 +372,7 @@
         listIndexes: {command: {listIndexes: "view"}, expectFailure: true},
         listShards: {skip: isUnrelated},
         lockInfo: {skip: isUnrelated},
+        lockWaitGraph: {skip: isUnrelated},
         logApplicationMessage: {skip: isUnrelated},
         logRotate: {skip: isUnrelated},
         logout: {skip: isUnrelated},
@@ -0,0 +1,71 @@
+/**
+ * Tests that a read on a secondary does not run at the storage engine's local snapshot when the
+ * collection has catalog changes newer than that snapshot. The read must instead wait for the batch
+ * applying those changes to complete, and is counted in
+ * metrics.repl.secondaryReads.retriedWithPBWM.
+ *
+ * This test uses a failpoint to block right before batch application finishes, while holding the
+ * PBWM lock, and before the local snapshot moves to the end of the batch.
+ */
+(function() {
+    "use strict";
+
+    load('jstests/replsets/libs/secondary_reads_test.js');
+
+    const name = "secondaryReadsWaitForLocalSnapshot";
+    const collName = "testColl";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+    let replSet = secondaryReadsTest.getReplset();
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    assert.commandWorked(primaryDB.runCommand({create: collName}));
+    assert.writeOK(primaryDB.getCollection(collName).insert({_id: 0, x: 0}));
+    replSet.awaitReplication();
+
+    function retriedWithPBWM() {
+        const status = assert.commandWorked(secondaryDB.adminCommand({serverStatus: 1}));
+        return status.metrics.repl.secondaryReads.retriedWithPBWM;
+    }
+
+    // Reads of a collection without pending catalog changes are served at the local snapshot.
+    const retriedBefore = retriedWithPBWM();
+    assert.eq(secondaryDB.getCollection(collName).find().itcount(), 1);
+    assert.eq(retriedWithPBWM(), retriedBefore);
+
+    // Prevent a batch that builds an index, and so changes the catalog of the collection, from
+    // completing on the secondary.
+    let pauseAwait = secondaryReadsTest.pauseSecondaryBatchApplication();
+    assert.commandWorked(primaryDB.runCommand(
+        {createIndexes: collName, indexes: [{key: {x: 1}, name: "x_1"}]}));
+    pauseAwait();
+
+    // The local snapshot is behind the index build, so the read must not be served from it.
+    const awaitRead = startParallelShell(function() {
+        db.getMongo().setSlaveOk();
+        const coll = db.getSiblingDB("secondaryReadsWaitForLocalSnapshot").testColl;
+        assert.eq(coll.find().hint({x: 1}).itcount(), 1);
+    }, secondaryDB.getMongo().port);
+
+    assert.soon(function() {
+        return retriedWithPBWM() > retriedBefore;
+    }, "the read did not retry under the PBWM lock");
+
+    // While the batch is paused, the read is blocked on the PBWM lock.
+    assert.soon(function() {
+        const ops = secondaryDB.getSiblingDB("admin")
+                        .aggregate([
+                            {$currentOp: {}},
+                            {$match: {ns: secondaryDB.getName() + "." + collName}}
+                        ])
+                        .toArray();
+        return ops.length === 1 && ops[0].waitingForLock;
+    }, "the read was not waiting for the batch to complete");
+
+    // Once the batch completes, the read can use the index it built.
+    secondaryReadsTest.resumeSecondaryBatchApplication();
+    awaitRead();
+
+    secondaryReadsTest.stop();
+})();
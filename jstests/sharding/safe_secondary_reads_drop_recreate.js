@@ -184,6 +184,7 @@
             behavior: "versioned"
         },
         geoSearch: {skip: "not supported in mongos"},
+        getChunkWriteHeat: {skip: "primary only"},
         getCmdLineOpts: {skip: "does not return user data"},
         getDiagnosticData: {skip: "does not return user data"},
         getLastError: {skip: "primary only"},
@@ -230,6 +231,7 @@
         listIndexes: {skip: "primary only"},
         listShards: {skip: "does not return user data"},
         lockInfo: {skip: "primary only"},
+        lockWaitGraph: {skip: "primary only"},
         logApplicationMessage: {skip: "primary only"},
         logRotate: {skip: "does not return user data"},
         logout: {skip: "does not return user data"},
@@ -208,14 +208,140 @@ Future<Message> AsyncDBClient::_call(Message request, const transport::BatonHand
                     "ResponseId did not match sent message ID.",
                     response.header().getResponseToMsgId() == msgId);
 
-            if (response.operation() == dbCompressed) {
-                return _compressorManager.decompressMessage(response);
-            } else {
-                return response;
-            }
+            return _decompressReply(std::move(response));
         });
 }
 
+StatusWith<Message> AsyncDBClient::_decompressReply(Message response) {
+    if (response.operation() == dbCompressed) {
+        return _compressorManager.decompressMessage(response);
+    } else {
+        return response;
+    }
+}
+
+Future<Message> AsyncDBClient::_pipelinedCall(Message request) {
+    auto swm = _compressorManager.compressMessage(request);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    request = std::move(swm.getValue());
+    auto msgId = nextMessageId();
+    request.header().setId(msgId);
+    request.header().setResponseToMsgId(0);
+
+    Promise<Message> promise;
+    auto future = promise.getFuture();
+
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    if (!_pipelineStatus.isOK()) {
+        return _pipelineStatus;
+    }
+
+    _pipelineReplies.emplace(msgId, std::move(promise));
+    _pipelineSends.push_back(std::move(request));
+    _sendPipelined(std::move(lk));
+
+    lk = stdx::unique_lock<stdx::mutex>(_pipelineMutex);
+    _receivePipelined(std::move(lk));
+
+    return future;
+}
+
+void AsyncDBClient::_sendPipelined(stdx::unique_lock<stdx::mutex> lk) {
+    while (!_pipelineSending && !_pipelineSends.empty() && _pipelineStatus.isOK()) {
+        // Everything that queued up while the last write was in progress goes out in one write.
+        std::vector<Message> batch;
+        batch.swap(_pipelineSends);
+        _pipelineSending = true;
+        lk.unlock();
+
+        auto future = _session->asyncSinkMessages(std::move(batch));
+        if (!future.isReady()) {
+            std::move(future).getAsync([self = shared_from_this()](Status status) {
+                self->_sendPipelined(self->_onPipelinedSend(std::move(status)));
+            });
+            return;
+        }
+
+        // Writes which complete right away are followed up in this loop rather than from their
+        // callbacks, so that a long run of them doesn't grow the stack.
+        lk = _onPipelinedSend(std::move(future).getNoThrow());
+    }
+}
+
+stdx::unique_lock<stdx::mutex> AsyncDBClient::_onPipelinedSend(Status status) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    _pipelineSending = false;
+    if (!status.isOK()) {
+        _failPipeline(std::move(lk), std::move(status));
+        lk = stdx::unique_lock<stdx::mutex>(_pipelineMutex);
+    }
+    return lk;
+}
+
+void AsyncDBClient::_receivePipelined(stdx::unique_lock<stdx::mutex> lk) {
+    while (!_pipelineReceiving && !_pipelineReplies.empty() && _pipelineStatus.isOK()) {
+        _pipelineReceiving = true;
+        lk.unlock();
+
+        auto future = _session->asyncSourceMessage();
+        if (!future.isReady()) {
+            std::move(future).getAsync([self = shared_from_this()](StatusWith<Message> swResponse) {
+                self->_receivePipelined(self->_onPipelinedReply(std::move(swResponse)));
+            });
+            return;
+        }
+
+        // Replies the session has already received are handled in this loop rather than from
+        // their callbacks, so that a long run of them doesn't grow the stack.
+        lk = _onPipelinedReply(std::move(future).getNoThrow());
+    }
+}
+
+stdx::unique_lock<stdx::mutex> AsyncDBClient::_onPipelinedReply(StatusWith<Message> swResponse) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    _pipelineReceiving = false;
+
+    auto status = swResponse.getStatus();
+    if (status.isOK()) {
+        auto& response = swResponse.getValue();
+        auto it = _pipelineReplies.find(response.header().getResponseToMsgId());
+        if (it != _pipelineReplies.end()) {
+            auto promise = std::move(it->second);
+            _pipelineReplies.erase(it);
+            lk.unlock();
+
+            promise.setFromStatusWith(_decompressReply(std::move(response)));
+            return stdx::unique_lock<stdx::mutex>(_pipelineMutex);
+        }
+
+        status = Status(ErrorCodes::ProtocolError,
+                        str::stream() << "Received a reply to message "
+                                      << response.header().getResponseToMsgId()
+                                      << " which has no pipelined request");
+    }
+
+    _failPipeline(std::move(lk), std::move(status));
+    return stdx::unique_lock<stdx::mutex>(_pipelineMutex);
+}
+
+void AsyncDBClient::_failPipeline(stdx::unique_lock<stdx::mutex> lk, Status status) {
+    if (_pipelineStatus.isOK()) {
+        _pipelineStatus = status;
+    }
+
+    auto replies = std::move(_pipelineReplies);
+    _pipelineReplies.clear();
+    _pipelineSends.clear();
+    lk.unlock();
+
+    for (auto& reply : replies) {
+        reply.second.setError(status);
+    }
+}
+
 Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
                                                    const transport::BatonHandle& baton) {
     invariant(_negotiatedProtocol);
@@ -228,11 +354,36 @@ Future<rpc::UniqueReply> AsyncDBClient::runCommand(OpMsgRequest request,
 
 Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
     executor::RemoteCommandRequest request, const transport::BatonHandle& baton) {
+    return _runCommandRequest(std::move(request), baton, false);
+}
+
+Future<executor::RemoteCommandResponse> AsyncDBClient::runPipelinedCommandRequest(
+    executor::RemoteCommandRequest request) {
+    return _runCommandRequest(std::move(request), nullptr, true);
+}
+
+Future<executor::RemoteCommandResponse> AsyncDBClient::_runCommandRequest(
+    executor::RemoteCommandRequest request, const transport::BatonHandle& baton, bool pipelined) {
     auto clkSource = _svcCtx->getPreciseClockSource();
     auto start = clkSource->now();
     auto opMsgRequest = OpMsgRequest::fromDBAndBody(
         std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata));
-    return runCommand(std::move(opMsgRequest), baton)
+
+    Future<rpc::UniqueReply> reply = [&]() -> Future<rpc::UniqueReply> {
+        if (!pipelined) {
+            return runCommand(std::move(opMsgRequest), baton);
+        }
+
+        invariant(_negotiatedProtocol);
+        auto requestMsg =
+            rpc::messageFromOpMsgRequest(*_negotiatedProtocol, std::move(opMsgRequest));
+        return _pipelinedCall(std::move(requestMsg))
+            .then([](Message response) -> Future<rpc::UniqueReply> {
+                return rpc::UniqueReply(response, rpc::makeReply(&response));
+            });
+    }();
+
+    return std::move(reply)
         .then([start, clkSource, this](rpc::UniqueReply response) {
             auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
             return executor::RemoteCommandResponse(*response, duration);
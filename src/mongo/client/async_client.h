@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/service_context.h"
 #include "mongo/executor/network_connection_hook.h"
@@ -36,6 +38,7 @@
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -62,6 +65,18 @@ public:
     Future<rpc::UniqueReply> runCommand(OpMsgRequest request,
                                         const transport::BatonHandle& baton = nullptr);
 
+    /**
+     * Runs a command without waiting for the replies to commands already outstanding on this
+     * client. Requests are written in the order they are made, several to a write when they queue
+     * up, and replies are matched back to their requests by responseTo. A network error fails
+     * every outstanding pipelined command and every later one.
+     *
+     * Pipelined commands must not be mixed with runCommand() or runCommandRequest() on the same
+     * client.
+     */
+    Future<executor::RemoteCommandResponse> runPipelinedCommandRequest(
+        executor::RemoteCommandRequest request);
+
     Future<void> authenticate(const BSONObj& params);
 
     Future<void> initWireVersion(const std::string& appName,
@@ -77,7 +92,18 @@ public:
     const HostAndPort& local() const;
 
 private:
+    Future<executor::RemoteCommandResponse> _runCommandRequest(
+        executor::RemoteCommandRequest request,
+        const transport::BatonHandle& baton,
+        bool pipelined);
     Future<Message> _call(Message request, const transport::BatonHandle& baton = nullptr);
+    Future<Message> _pipelinedCall(Message request);
+    void _sendPipelined(stdx::unique_lock<stdx::mutex> lk);
+    stdx::unique_lock<stdx::mutex> _onPipelinedSend(Status status);
+    void _receivePipelined(stdx::unique_lock<stdx::mutex> lk);
+    stdx::unique_lock<stdx::mutex> _onPipelinedReply(StatusWith<Message> swResponse);
+    void _failPipeline(stdx::unique_lock<stdx::mutex> lk, Status status);
+    StatusWith<Message> _decompressReply(Message response);
     BSONObj _buildIsMasterRequest(const std::string& appName);
     void _parseIsMasterResponse(BSONObj request,
                                 const std::unique_ptr<rpc::ReplyInterface>& response);
@@ -87,6 +113,15 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    // State for runPipelinedCommandRequest(). At most one write and one read are in progress on
+    // the session at a time; requests queue in _pipelineSends while a write is in progress.
+    stdx::mutex _pipelineMutex;
+    Status _pipelineStatus = Status::OK();
+    std::vector<Message> _pipelineSends;
+    std::map<int32_t, Promise<Message>> _pipelineReplies;
+    bool _pipelineSending = false;
+    bool _pipelineReceiving = false;
 };
 
 }  // namespace mongo
@@ -0,0 +1,264 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/async_client.h"
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/service_context_noop.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/legacy_reply_builder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/op_msg.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A session whose remote is driven by the test. The isMaster of the connection handshake is
+ * answered right away; the requests of all other commands are recorded, and their replies are
+ * delivered by the test in whatever order it chooses.
+ */
+class MockRemoteSession : public transport::MockSession {
+public:
+    MockRemoteSession() : MockSession(nullptr) {}
+
+    Future<Message> asyncSourceMessage(const transport::BatonHandle& baton = nullptr) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_received.empty()) {
+            auto reply = std::move(_received.front());
+            _received.pop_front();
+            return Future<Message>::makeReady(std::move(reply));
+        }
+
+        invariant(!_reader);
+        Promise<Message> promise;
+        auto future = promise.getFuture();
+        _reader.emplace(std::move(promise));
+        return future;
+    }
+
+    Future<void> asyncSinkMessage(Message message,
+                                  const transport::BatonHandle& baton = nullptr) override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (message.operation() == dbQuery) {
+            _received.push_back(makeIsMasterReply(message));
+        } else {
+            _requests.push_back(std::move(message));
+        }
+        return Future<void>::makeReady();
+    }
+
+    void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
+        deliver(Status(ErrorCodes::CallbackCanceled, "Canceled"));
+    }
+
+    /**
+     * Hands the reply, or the error, to the read in progress, or queues it for the next read if
+     * there is none.
+     */
+    void deliver(StatusWith<Message> reply) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (!_reader) {
+            _received.push_back(std::move(reply));
+            return;
+        }
+
+        auto reader = std::move(*_reader);
+        _reader = boost::none;
+        lk.unlock();
+        reader.setFromStatusWith(std::move(reply));
+    }
+
+    /**
+     * Queues the reply for a later read, even if a read is in progress.
+     */
+    void queue(Message reply) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _received.push_back(std::move(reply));
+    }
+
+    Message makeReply(size_t requestIndex, BSONObj body) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        OpMsgBuilder builder;
+        builder.setBody(body);
+        auto reply = builder.finish();
+        reply.header().setId(nextMessageId());
+        reply.header().setResponseToMsgId(_requests.at(requestIndex).header().getId());
+        return reply;
+    }
+
+    std::vector<BSONObj> requestBodies() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        std::vector<BSONObj> bodies;
+        for (const auto& request : _requests) {
+            bodies.push_back(OpMsg::parse(request).body.getOwned());
+        }
+        return bodies;
+    }
+
+private:
+    static Message makeIsMasterReply(const Message& request) {
+        rpc::LegacyReplyBuilder builder;
+        builder.setRawCommandReply(BSON("ok" << 1 << "ismaster" << true << "minWireVersion" << 0
+                                             << "maxWireVersion"
+                                             << WireVersion::LATEST_WIRE_VERSION));
+        builder.setMetadata(BSONObj());
+        auto reply = builder.done();
+        reply.header().setId(nextMessageId());
+        reply.header().setResponseToMsgId(request.header().getId());
+        return reply;
+    }
+
+    stdx::mutex _mutex;
+    std::vector<Message> _requests;
+    std::deque<StatusWith<Message>> _received;
+    boost::optional<Promise<Message>> _reader;
+};
+
+class AsyncClientPipelineTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _session = std::make_shared<MockRemoteSession>();
+        _client = std::make_shared<AsyncDBClient>(_target, _session, &_serviceContext);
+        _client->initWireVersion("AsyncClientPipelineTest", nullptr).get();
+    }
+
+    Future<executor::RemoteCommandResponse> runPing(int seq) {
+        return _client->runPipelinedCommandRequest(executor::RemoteCommandRequest(
+            _target, "admin", BSON("ping" << 1 << "seq" << seq), nullptr));
+    }
+
+    const HostAndPort _target{"localhost", 27017};
+    ServiceContextNoop _serviceContext;
+    std::shared_ptr<MockRemoteSession> _session;
+    std::shared_ptr<AsyncDBClient> _client;
+};
+
+TEST_F(AsyncClientPipelineTest, RepliesAreMatchedToTheirRequests) {
+    std::vector<Future<executor::RemoteCommandResponse>> futures;
+    for (int i = 0; i < 3; ++i) {
+        futures.push_back(runPing(i));
+    }
+
+    // The requests go out in order, without waiting for any reply.
+    auto bodies = _session->requestBodies();
+    ASSERT_EQ(3UL, bodies.size());
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(i, bodies[i]["seq"].numberInt());
+    }
+
+    for (int i : {2, 0, 1}) {
+        _session->deliver(_session->makeReply(i, BSON("ok" << 1 << "seq" << i)));
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        auto response = std::move(futures[i]).get();
+        ASSERT_OK(response.status);
+        ASSERT_EQ(i, response.data["seq"].numberInt());
+    }
+}
+
+TEST_F(AsyncClientPipelineTest, CommandFailureOnlyFailsThatCommand) {
+    auto first = runPing(0);
+    auto second = runPing(1);
+
+    _session->deliver(_session->makeReply(0,
+                                          BSON("ok" << 0 << "errmsg"
+                                                    << "failed"
+                                                    << "code"
+                                                    << ErrorCodes::BadValue)));
+    _session->deliver(_session->makeReply(1, BSON("ok" << 1)));
+
+    ASSERT_EQ(ErrorCodes::BadValue, getStatusFromCommandResult(std::move(first).get().data));
+    ASSERT_OK(getStatusFromCommandResult(std::move(second).get().data));
+
+    // The connection is still usable.
+    auto third = runPing(2);
+    _session->deliver(_session->makeReply(2, BSON("ok" << 1)));
+    ASSERT_OK(getStatusFromCommandResult(std::move(third).get().data));
+}
+
+TEST_F(AsyncClientPipelineTest, NetworkErrorFailsTheOutstandingCommands) {
+    auto first = runPing(0);
+    auto second = runPing(1);
+    auto third = runPing(2);
+
+    _session->deliver(_session->makeReply(0, BSON("ok" << 1)));
+    _session->deliver(Status(ErrorCodes::HostUnreachable, "Connection reset"));
+
+    ASSERT_OK(std::move(first).get().status);
+    ASSERT_EQ(ErrorCodes::HostUnreachable, std::move(second).getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::HostUnreachable, std::move(third).getNoThrow().getStatus());
+
+    // Nothing more is sent on the broken connection.
+    ASSERT_EQ(ErrorCodes::HostUnreachable, runPing(3).getNoThrow().getStatus());
+    ASSERT_EQ(3UL, _session->requestBodies().size());
+}
+
+TEST_F(AsyncClientPipelineTest, CancelFailsTheCommandsStillWaiting) {
+    auto first = runPing(0);
+    auto second = runPing(1);
+    auto third = runPing(2);
+
+    _session->deliver(_session->makeReply(0, BSON("ok" << 1)));
+    _client->cancel();
+
+    ASSERT_OK(std::move(first).get().status);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, std::move(second).getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, std::move(third).getNoThrow().getStatus());
+}
+
+TEST_F(AsyncClientPipelineTest, BufferedRepliesAreHandledWithoutRecursion) {
+    // Enough replies, which are all ready at once, to overflow the stack if each of them were
+    // handled from the callback of the previous one.
+    const int kCommands = 100 * 1000;
+
+    std::vector<Future<executor::RemoteCommandResponse>> futures;
+    for (int i = 0; i < kCommands; ++i) {
+        futures.push_back(runPing(i));
+    }
+
+    for (int i = 1; i < kCommands; ++i) {
+        _session->queue(_session->makeReply(i, BSON("ok" << 1 << "seq" << i)));
+    }
+    _session->deliver(_session->makeReply(0, BSON("ok" << 1 << "seq" << 0)));
+
+    for (int i = 0; i < kCommands; ++i) {
+        ASSERT_EQ(i, std::move(futures[i]).get().data["seq"].numberInt());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
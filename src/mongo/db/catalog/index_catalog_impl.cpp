@@ -1361,17 +1361,17 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
-    for (auto bsonRecord : bsonRecords) {
-        int64_t inserted;
-        invariant(bsonRecord.id != RecordId());
-        Status status = index->accessMethod()->insert(
-            opCtx, *bsonRecord.docPtr, bsonRecord.id, options, &inserted);
-        if (!status.isOK())
-            return status;
+    // Insert the keys of all the documents in index order, rather than document by document.
+    int64_t inserted;
+    Status status = bsonRecords.size() == 1
+        ? index->accessMethod()->insert(
+              opCtx, *bsonRecords.front().docPtr, bsonRecords.front().id, options, &inserted)
+        : index->accessMethod()->insertMany(opCtx, bsonRecords, options, &inserted);
+    if (!status.isOK())
+        return status;
 
-        if (keysInsertedOut) {
-            *keysInsertedOut += inserted;
-        }
+    if (keysInsertedOut) {
+        *keysInsertedOut += inserted;
     }
     return Status::OK();
 }
@@ -34,16 +34,59 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
 using std::string;
 using std::stringstream;
 
+namespace {
+
+/**
+ * Maps the locker of every running operation to the description of its client and operation.
+ */
+std::map<LockerId, BSONObj> getLockToClientMap(ServiceContext* serviceContext) {
+    std::map<LockerId, BSONObj> lockToClientMap;
+
+    for (ServiceContext::LockedClientsCursor cursor(serviceContext);
+         Client* client = cursor.next();) {
+        invariant(client);
+
+        stdx::lock_guard<Client> lk(*client);
+        const OperationContext* clientOpCtx = client->getOperationContext();
+
+        // Operation context specific information
+        if (clientOpCtx) {
+            BSONObjBuilder infoBuilder;
+            // The client information
+            client->reportState(infoBuilder);
+
+            infoBuilder.append("opid", clientOpCtx->getOpID());
+            LockerId lockerId = clientOpCtx->lockState()->getId();
+            lockToClientMap.insert({lockerId, infoBuilder.obj()});
+        }
+    }
+
+    return lockToClientMap;
+}
+
+void appendClientInfo(const std::map<LockerId, BSONObj>& lockToClientMap,
+                      LockerId lockerId,
+                      BSONObjBuilder* builder) {
+    auto it = lockToClientMap.find(lockerId);
+    if (it != lockToClientMap.end()) {
+        builder->appendElements(it->second);
+    }
+}
+
+}  // namespace
+
 /**
  * Admin command to display global lock information
  */
@@ -79,29 +122,93 @@ public:
              const string& dbname,
              const BSONObj& jsobj,
              BSONObjBuilder& result) {
-        std::map<LockerId, BSONObj> lockToClientMap;
+        const auto lockToClientMap = getLockToClientMap(opCtx->getClient()->getServiceContext());
 
-        for (ServiceContext::LockedClientsCursor cursor(opCtx->getClient()->getServiceContext());
-             Client* client = cursor.next();) {
-            invariant(client);
+        getGlobalLockManager()->getLockInfoBSON(lockToClientMap, &result);
+        return true;
+    }
+} cmdLockInfo;
 
-            stdx::lock_guard<Client> lk(*client);
-            const OperationContext* clientOpCtx = client->getOperationContext();
+/**
+ * Admin command to display which lock requests are waiting and which requests they are waiting
+ * for, that is the current wait-for graph of the lock manager.
+ */
+class CmdLockWaitGraph : public BasicCommand {
+public:
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
 
-            // Operation context specific information
-            if (clientOpCtx) {
-                BSONObjBuilder infoBuilder;
-                // The client information
-                client->reportState(infoBuilder);
+    bool adminOnly() const override {
+        return true;
+    }
 
-                infoBuilder.append("opid", clientOpCtx->getOpID());
-                LockerId lockerId = clientOpCtx->lockState()->getId();
-                lockToClientMap.insert({lockerId, infoBuilder.obj()});
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "show the lock requests which are waiting and what they are waiting for";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const final {
+        bool isAuthorized = AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::serverStatus);
+        return isAuthorized ? Status::OK() : Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    CmdLockWaitGraph() : BasicCommand("lockWaitGraph") {}
+
+    bool run(OperationContext* opCtx,
+             const string& dbname,
+             const BSONObj& jsobj,
+             BSONObjBuilder& result) override {
+        const auto lockToClientMap = getLockToClientMap(opCtx->getClient()->getServiceContext());
+        const LockManager& lockManager = *getGlobalLockManager();
+
+        const auto waiters = lockManager.getWaitForGraph();
+
+        // The graph is not a consistent snapshot, so check each cycle in its edges again through
+        // the lock manager.
+        stdx::unordered_set<LockerId> lockersInCycles;
+        for (const auto& cycle : LockManager::findWaitCycles(waiters)) {
+            const auto& first = waiters[cycle.front()];
+            DeadlockDetector wfg(lockManager, first.lockerId, first.resourceId);
+            if (!wfg.check().hasCycle()) {
+                continue;
+            }
+
+            for (size_t i : cycle) {
+                lockersInCycles.insert(waiters[i].lockerId);
             }
         }
 
-        getGlobalLockManager()->getLockInfoBSON(lockToClientMap, &result);
+        BSONArrayBuilder waitersBuilder(result.subarrayStart("waiters"));
+        for (const auto& waiter : waiters) {
+            BSONObjBuilder waiterBuilder(waitersBuilder.subobjStart());
+            waiterBuilder.append("lockerId", static_cast<long long>(waiter.lockerId));
+            waiterBuilder.append("resourceId", waiter.resourceId.toString());
+            waiterBuilder.append("mode", modeName(waiter.mode));
+            waiterBuilder.append("converting", waiter.converting);
+            waiterBuilder.append("inCycle", lockersInCycles.count(waiter.lockerId) > 0);
+
+            appendClientInfo(lockToClientMap, waiter.lockerId, &waiterBuilder);
+
+            BSONArrayBuilder blockersBuilder(waiterBuilder.subarrayStart("waitingFor"));
+            for (const auto& blocker : waiter.blockers) {
+                BSONObjBuilder blockerBuilder(blockersBuilder.subobjStart());
+                blockerBuilder.append("lockerId", static_cast<long long>(blocker.lockerId));
+                blockerBuilder.append("mode", modeName(blocker.mode));
+                blockerBuilder.append("granted", blocker.granted);
+                appendClientInfo(lockToClientMap, blocker.lockerId, &blockerBuilder);
+            }
+        }
+        waitersBuilder.doneFast();
+
         return true;
     }
-} cmdLockInfo;
-}
+} cmdLockWaitGraph;
+
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/db/concurrency/global_lock_acquisition_tracker.h"
+#include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
@@ -230,6 +231,7 @@ Lock::DBLock::DBLock(OperationContext* opCtx, StringData db, LockMode mode, Date
 
     _result = _opCtx->lockState()->lock(_opCtx, _id, _mode, deadline);
     invariant(_result == LOCK_OK || deadline != Date_t::max());
+    noteGlobalLockWaitResourceName(_id, db);
 }
 
 Lock::DBLock::DBLock(DBLock&& otherLock)
@@ -278,6 +280,7 @@ Lock::CollectionLock::CollectionLock(Locker* lockState,
 
     _result = _lockState->lock(_id, actualLockMode, deadline);
     invariant(_result == LOCK_OK || deadline != Date_t::max());
+    noteGlobalLockWaitResourceName(_id, ns);
 }
 
 Lock::CollectionLock::CollectionLock(CollectionLock&& otherLock)
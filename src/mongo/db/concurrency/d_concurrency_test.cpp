@@ -1211,6 +1211,39 @@ TEST_F(DConcurrencyTestFixture, ReleaseAndReacquireTicket) {
     }
 }
 
+TEST_F(DConcurrencyTestFixture, InternalOperationsUsePriorityTicketsWhenTicketsRunOut) {
+    auto clientOpctxPairs = makeKClientsWithLockers<DefaultLockerImpl>(3);
+    auto opctx1 = clientOpctxPairs[0].second.get();
+    auto opctx2 = clientOpctxPairs[1].second.get();
+    auto opctx3 = clientOpctxPairs[2].second.get();
+    // Limit the lockers to 1 ticket at a time, plus 1 reserved for internal operations. The test
+    // clients do not come from user connections, so all of them count as internal.
+    UseGlobalThrottling throttle(opctx1, 1);
+    TicketHolder priorityHolder(1);
+    Locker::setGlobalPriorityThrottling(&priorityHolder, &priorityHolder);
+    ON_BLOCK_EXIT([] { Locker::setGlobalPriorityThrottling(nullptr, nullptr); });
+
+    {
+        Lock::GlobalRead R1(opctx1, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(R1.isLocked());
+        ASSERT_EQ(priorityHolder.used(), 0);
+
+        {
+            // The second Locker falls back to the priority ticket.
+            Lock::GlobalRead R2(opctx2, Date_t::now(), Lock::InterruptBehavior::kThrow);
+            ASSERT(R2.isLocked());
+            ASSERT_EQ(priorityHolder.used(), 1);
+
+            // Once both are taken, a third Locker times out.
+            Lock::GlobalRead R3(opctx3, Date_t::now(), Lock::InterruptBehavior::kThrow);
+            ASSERT(!R3.isLocked());
+        }
+
+        // The priority ticket went back to where it came from.
+        ASSERT_EQ(priorityHolder.used(), 0);
+    }
+}
+
 TEST_F(DConcurrencyTestFixture, LockerWithReleasedTicketCanBeUnlocked) {
     auto clientOpctxPairs = makeKClientsWithLockers<DefaultLockerImpl>(2);
     auto opctx1 = clientOpctxPairs[0].second.get();
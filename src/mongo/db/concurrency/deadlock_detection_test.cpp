@@ -26,6 +26,8 @@
  *    it in the license file.
  */
 
+#include <algorithm>
+
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
 
@@ -188,4 +190,127 @@ TEST(Deadlock, IndirectWithUpgrade) {
     writer.unlock(resIdFlush);
 }
 
+TEST(Deadlock, WaitForGraphReportsWaitersAndBlockers) {
+    const ResourceId resId(RESOURCE_DATABASE, std::string("A"));
+
+    LockerForTests locker1(MODE_IX);
+    LockerForTests locker2(MODE_IS);
+
+    ASSERT_EQUALS(LOCK_OK, locker1.lockBegin(nullptr, resId, MODE_X));
+    ASSERT_EQUALS(LOCK_WAITING, locker2.lockBegin(nullptr, resId, MODE_S));
+
+    int numWaiters = 0;
+    for (const auto& waiter : getGlobalLockManager()->getWaitForGraph()) {
+        if (waiter.resourceId != resId) {
+            continue;
+        }
+
+        numWaiters++;
+        ASSERT_EQUALS(locker2.getId(), waiter.lockerId);
+        ASSERT_EQUALS(MODE_S, waiter.mode);
+        ASSERT_FALSE(waiter.converting);
+
+        ASSERT_EQUALS(1U, waiter.blockers.size());
+        ASSERT_EQUALS(locker1.getId(), waiter.blockers[0].lockerId);
+        ASSERT_EQUALS(MODE_X, waiter.blockers[0].mode);
+        ASSERT(waiter.blockers[0].granted);
+    }
+    ASSERT_EQUALS(1, numWaiters);
+
+    locker2.unlock(resId);
+    locker1.unlock(resId);
+}
+
+TEST(Deadlock, CycleFoundFromWaitForGraph) {
+    const ResourceId resIdA(RESOURCE_DATABASE, std::string("A"));
+    const ResourceId resIdB(RESOURCE_DATABASE, std::string("B"));
+
+    LockerForTests locker1(MODE_IX);
+    LockerForTests locker2(MODE_IX);
+
+    ASSERT_EQUALS(LOCK_OK, locker1.lockBegin(nullptr, resIdA, MODE_X));
+    ASSERT_EQUALS(LOCK_OK, locker2.lockBegin(nullptr, resIdB, MODE_X));
+
+    // 1 -> 2
+    ASSERT_EQUALS(LOCK_WAITING, locker1.lockBegin(nullptr, resIdB, MODE_X));
+
+    // 2 -> 1
+    ASSERT_EQUALS(LOCK_WAITING, locker2.lockBegin(nullptr, resIdA, MODE_X));
+
+    // Every waiter is found to be part of the cycle, without access to its locker
+    int numWaiters = 0;
+    for (const auto& waiter : getGlobalLockManager()->getWaitForGraph()) {
+        if (waiter.resourceId != resIdA && waiter.resourceId != resIdB) {
+            continue;
+        }
+
+        numWaiters++;
+        DeadlockDetector wfg(*getGlobalLockManager(), waiter.lockerId, waiter.resourceId);
+        ASSERT(wfg.check().hasCycle());
+
+        const auto lockerIds = wfg.getWaitingLockerIds();
+        ASSERT_EQUALS(2U, lockerIds.size());
+        ASSERT(std::find(lockerIds.begin(), lockerIds.end(), locker1.getId()) != lockerIds.end());
+        ASSERT(std::find(lockerIds.begin(), lockerIds.end(), locker2.getId()) != lockerIds.end());
+    }
+    ASSERT_EQUALS(2, numWaiters);
+
+    // A single pass over the edges of the graph finds the same cycle
+    const auto waiters = getGlobalLockManager()->getWaitForGraph();
+    const auto cycles = LockManager::findWaitCycles(waiters);
+    ASSERT_EQUALS(1U, cycles.size());
+    ASSERT_EQUALS(2U, cycles[0].size());
+    for (size_t i : cycles[0]) {
+        ASSERT(waiters[i].lockerId == locker1.getId() || waiters[i].lockerId == locker2.getId());
+    }
+
+    // Cleanup, so that LockerImpl doesn't complain about leaked locks
+    locker1.unlock(resIdB);
+    locker2.unlock(resIdA);
+}
+
+TEST(Deadlock, FindWaitCyclesOnlyReportsCycles) {
+    using WaitingRequest = LockManager::WaitingRequest;
+    auto waiter = [](LockerId lockerId, std::vector<LockerId> blockers) {
+        WaitingRequest request;
+        request.lockerId = lockerId;
+        request.resourceId = ResourceId(RESOURCE_DATABASE, lockerId);
+        request.mode = MODE_X;
+        request.converting = false;
+        for (LockerId blocker : blockers) {
+            request.blockers.push_back({blocker, MODE_X, true});
+        }
+        return request;
+    };
+
+    // 1 -> 2 -> 3 -> 1 is a cycle, 4 waits on it and 5 waits on a locker which is not waiting,
+    // 6 -> 7 -> 6 is a second cycle.
+    const std::vector<WaitingRequest> waiters{waiter(1, {2}),
+                                              waiter(2, {3}),
+                                              waiter(3, {1, 100}),
+                                              waiter(4, {1}),
+                                              waiter(5, {100}),
+                                              waiter(6, {7}),
+                                              waiter(7, {6})};
+
+    auto cycles = LockManager::findWaitCycles(waiters);
+    ASSERT_EQUALS(2U, cycles.size());
+
+    std::vector<std::vector<LockerId>> lockerIds;
+    for (const auto& cycle : cycles) {
+        std::vector<LockerId> ids;
+        for (size_t i : cycle) {
+            ids.push_back(waiters[i].lockerId);
+        }
+        std::sort(ids.begin(), ids.end());
+        lockerIds.push_back(ids);
+    }
+    std::sort(lockerIds.begin(), lockerIds.end());
+
+    ASSERT(lockerIds[0] == std::vector<LockerId>({1, 2, 3}));
+    ASSERT(lockerIds[1] == std::vector<LockerId>({6, 7}));
+
+    ASSERT(LockManager::findWaitCycles({waiter(1, {2}), waiter(2, {})}).empty());
+}
+
 }  // namespace mongo
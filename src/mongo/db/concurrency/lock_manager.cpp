@@ -32,6 +32,8 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 
+#include <algorithm>
+#include <limits>
 #include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/base/data_type_endian.h"
@@ -41,6 +43,7 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -73,6 +76,10 @@ static const int LockConflictsTable[] = {
 // Mask of modes
 const uint64_t intentModes = (1 << MODE_IS) | (1 << MODE_IX);
 
+// Set on a fast path slot while some thread other than the owner of the request published there
+// inspects it. The owner may not remove the request from a pinned slot.
+const uintptr_t kFastPathSlotPinned = 1;
+
 // Ensure we do not add new modes without updating the conflicts table
 MONGO_STATIC_ASSERT((sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount);
 
@@ -98,6 +105,17 @@ uint32_t modeMask(LockMode mode) {
     return 1 << mode;
 }
 
+bool isIntentMode(LockMode mode) {
+    return (modeMask(mode) & intentModes) != 0;
+}
+
+// Nearly every operation takes intent locks on these resources, so they are the ones worth
+// granting without touching a mutex.
+bool isFastPathResource(ResourceId resId) {
+    const ResourceType type = resId.getType();
+    return type == RESOURCE_GLOBAL || type == RESOURCE_DATABASE || type == RESOURCE_COLLECTION;
+}
+
 uint64_t hashStringData(StringData str) {
     char hash[16];
     MurmurHash3_x64_128(str.rawData(), str.size(), 0, hash);
@@ -403,6 +421,59 @@ void LockHead::migratePartitionedLockHeads() {
     }
 }
 
+namespace {
+
+/**
+ * Calls 'callback' for every request on 'lock' which the waiting or converting 'request' has to
+ * wait for: the granted requests it conflicts with and, for a waiting request, the conflicting
+ * requests queued ahead of it. Must be called with the bucket holding 'lock' locked.
+ */
+template <typename Callback>
+void forEachBlockingRequest(const LockHead* lock, const LockRequest* request, Callback&& callback) {
+    bool seen = false;
+    for (LockRequest* it = lock->grantedList._back; it != nullptr; it = it->prev) {
+        // We can't conflict with ourselves
+        if (it == request) {
+            seen = true;
+            continue;
+        }
+
+        // If we are a regular conflicting request, both granted and conversion modes need to
+        // be checked for conflict, since conversions will be granted first.
+        if (request->status == LockRequest::STATUS_WAITING) {
+            if (conflicts(request->mode, modeMask(it->mode)) ||
+                conflicts(request->mode, modeMask(it->convertMode))) {
+                callback(it);
+            }
+
+            continue;
+        }
+
+        // If we are a conversion request, only requests, which are before us need to be
+        // accounted for.
+        invariant(request->status == LockRequest::STATUS_CONVERTING);
+
+        if (conflicts(request->convertMode, modeMask(it->mode)) ||
+            (seen && conflicts(request->convertMode, modeMask(it->convertMode)))) {
+            callback(it);
+        }
+    }
+
+    // All conflicting waits, which would be granted before us
+    for (LockRequest* it = request->prev;
+         (request->status == LockRequest::STATUS_WAITING) && (it != nullptr);
+         it = it->prev) {
+        // We started from the previous element, so we should never see ourselves
+        invariant(it != request);
+
+        if (conflicts(request->mode, modeMask(it->mode))) {
+            callback(it);
+        }
+    }
+}
+
+}  // namespace
+
 //
 // LockManager
 //
@@ -414,9 +485,16 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// A locker whose group of fast path slots is full takes the regular path.
+constexpr unsigned LockManager::_numFastPathSlotGroups;
+constexpr unsigned LockManager::_numFastPathSlotsPerGroup;
+
+const unsigned LockManager::_numFastPathBlockCounts = 1024;
+
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastPathBlockCounts = new AtomicWord<uint32_t>[_numFastPathBlockCounts];
 }
 
 LockManager::~LockManager() {
@@ -429,6 +507,7 @@ LockManager::~LockManager() {
 
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastPathBlockCounts;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -439,8 +518,13 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
     request->mode = mode;
 
-    // For intent modes, try the PartitionedLockHead
+    // For intent modes, try the lock-free fast path and then the PartitionedLockHead
     if (request->partitioned) {
+        LockResult result;
+        if (_lockFastPath(resId, request, &result)) {
+            return result;
+        }
+
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -462,6 +546,10 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     LockHead* lock = bucket->findOrInsert(resId);
 
+    if (!isIntentMode(mode)) {
+        _blockFastPath(lock, request);
+    }
+
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
         Partition* partition = _getPartition(request);
@@ -508,15 +596,25 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
-    LockBucket::Map::iterator it = bucket->data.find(resId);
-    invariant(it != bucket->data.end());
-
-    LockHead* const lock = it->second;
+    LockHead* lock;
+    if (request->fastPathSlot >= 0) {
+        // The request may be the only one on the resource, so there might not be a LockHead yet
+        lock = bucket->findOrInsert(resId);
+        _leaveFastPath(lock, request);
+    } else {
+        LockBucket::Map::iterator it = bucket->data.find(resId);
+        invariant(it != bucket->data.end());
+        lock = it->second;
+    }
 
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
 
+    if (!isIntentMode(newMode)) {
+        _blockFastPath(lock, request);
+    }
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -567,6 +665,16 @@ bool LockManager::unlock(LockRequest* request) {
         return false;
     }
 
+    if (request->fastPathSlot >= 0) {
+        // Fast path: nothing conflicting has shown up since the request was granted
+        if (_releaseFastPathSlot(request)) {
+            return true;
+        }
+
+        // Moved onto the LockHead, fall through to regular case
+        request->fastPathSlot = -1;
+    }
+
     if (request->partitioned) {
         // Unlocking a lock that was acquired as partitioned. The lock request may since have
         // moved to the lock head, but there is no safe way to find out without synchronizing
@@ -604,6 +712,7 @@ bool LockManager::unlock(LockRequest* request) {
             invariant(lock->compatibleFirstCount == 0 || !lock->grantedList.empty());
         }
 
+        _unblockFastPath(lock->resourceId, request);
         _onLockModeChanged(lock, lock->grantedCounts[request->mode] == 0);
     } else if (request->status == LockRequest::STATUS_WAITING) {
         // This cancels a pending lock request
@@ -612,6 +721,7 @@ bool LockManager::unlock(LockRequest* request) {
         lock->conflictList.remove(request);
         lock->decConflictModeCount(request->mode);
 
+        _unblockFastPath(lock->resourceId, request);
         _onLockModeChanged(lock, true);
     } else if (request->status == LockRequest::STATUS_CONVERTING) {
         // This cancels a pending convert request
@@ -627,6 +737,10 @@ bool LockManager::unlock(LockRequest* request) {
 
         request->convertMode = MODE_NONE;
 
+        if (isIntentMode(request->mode)) {
+            _unblockFastPath(lock->resourceId, request);
+        }
+
         _onLockModeChanged(lock, lock->grantedCounts[request->convertMode] == 0);
     } else {
         // Invalid request status
@@ -655,6 +769,10 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     lock->decGrantedModeCount(request->mode);
     request->mode = newMode;
 
+    if (isIntentMode(newMode)) {
+        _unblockFastPath(lock->resourceId, request);
+    }
+
     _onLockModeChanged(lock, true);
 }
 
@@ -805,6 +923,161 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
     invariant((lock->conflictModes == 0) ^ (lock->conflictList._front != nullptr));
 }
 
+bool LockManager::_lockFastPath(ResourceId resId, LockRequest* request, LockResult* result) {
+    if (!isFastPathResource(resId)) {
+        return false;
+    }
+
+    AtomicWord<uint32_t>& blockCount = _fastPathBlockCounts[resId % _numFastPathBlockCounts];
+    if (blockCount.load() != 0) {
+        return false;
+    }
+
+    // The request must be complete before it is published, because a conflicting request may
+    // move it onto the LockHead as soon as it shows up in a slot.
+    request->fastPathResId = resId;
+    request->partitioned = false;
+    request->status = LockRequest::STATUS_GRANTED;
+
+    const uintptr_t published = reinterpret_cast<uintptr_t>(request);
+    const unsigned firstSlot =
+        (request->locker->getId() % _numFastPathSlotGroups) * _numFastPathSlotsPerGroup;
+    for (unsigned i = firstSlot; i < firstSlot + _numFastPathSlotsPerGroup; i++) {
+        if (_getFastPathSlot(i).compareAndSwap(0, published) == 0) {
+            request->fastPathSlot = i;
+            break;
+        }
+    }
+
+    if (request->fastPathSlot < 0) {
+        request->partitioned = true;
+        request->status = LockRequest::STATUS_NEW;
+        return false;
+    }
+
+    // A conflicting request increments the block count before it scans the slots and we publish
+    // before checking the count, so at least one of the two sees the other.
+    if (blockCount.load() == 0) {
+        *result = LOCK_OK;
+        return true;
+    }
+
+    if (_releaseFastPathSlot(request)) {
+        request->fastPathSlot = -1;
+        request->partitioned = true;
+        request->status = LockRequest::STATUS_NEW;
+        return false;
+    }
+
+    // The conflicting request already moved this one onto the LockHead, where it was queued like
+    // any other new request.
+    request->fastPathSlot = -1;
+
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+    *result = (request->status == LockRequest::STATUS_GRANTED) ? LOCK_OK : LOCK_WAITING;
+    return true;
+}
+
+bool LockManager::_releaseFastPathSlot(LockRequest* request) {
+    AtomicWord<uintptr_t>& slot = _getFastPathSlot(request->fastPathSlot);
+    const uintptr_t published = reinterpret_cast<uintptr_t>(request);
+
+    while (true) {
+        const uintptr_t current = slot.compareAndSwap(published, 0);
+        if (current == published) {
+            return true;
+        }
+
+        // Anything other than our own pinned request means it has been moved onto the LockHead.
+        // Pins are only held for a few instructions.
+        if (current != (published | kFastPathSlotPinned)) {
+            return false;
+        }
+
+        stdx::this_thread::yield();
+    }
+}
+
+void LockManager::_leaveFastPath(LockHead* lock, LockRequest* request) {
+    if (_releaseFastPathSlot(request)) {
+        // Anything that conflicts with a request granted on the fast path would have moved it
+        // onto the LockHead, so it can go straight to the granted queue.
+        request->lock = lock;
+        lock->grantedList.push_back(request);
+        lock->incGrantedModeCount(request->mode);
+    }
+
+    request->fastPathSlot = -1;
+}
+
+void LockManager::_blockFastPath(LockHead* lock, LockRequest* request) {
+    if (request->blocksFastPath || !isFastPathResource(lock->resourceId)) {
+        return;
+    }
+
+    request->blocksFastPath = true;
+    _fastPathBlockCounts[lock->resourceId % _numFastPathBlockCounts].fetchAndAdd(1);
+
+    // From here on no request for the resource stays on the fast path, so move the ones which are
+    // already there.
+    const unsigned numSlots = _numFastPathSlotGroups * _numFastPathSlotsPerGroup;
+    for (unsigned i = 0; i < numSlots; i++) {
+        AtomicWord<uintptr_t>& slot = _getFastPathSlot(i);
+
+        // The owner cannot remove the request while it is pinned, so it is safe to read.
+        LockRequest* fastPathRequest = _pinFastPathSlot(slot);
+        if (!fastPathRequest) {
+            continue;
+        }
+
+        if (fastPathRequest->fastPathResId != lock->resourceId) {
+            slot.store(reinterpret_cast<uintptr_t>(fastPathRequest));
+            continue;
+        }
+
+        // Requests granted before this one are granted on the LockHead too. One which was
+        // published after the block count went up is queued instead and its owner finds out when
+        // it sees that the slot no longer references it.
+        lock->newRequest(fastPathRequest);
+        slot.store(0);
+    }
+}
+
+AtomicWord<uintptr_t>& LockManager::_getFastPathSlot(unsigned index) {
+    return _fastPathSlotGroups[index / _numFastPathSlotsPerGroup]
+        .slots[index % _numFastPathSlotsPerGroup];
+}
+
+LockRequest* LockManager::_pinFastPathSlot(AtomicWord<uintptr_t>& slot) {
+    while (true) {
+        const uintptr_t published = slot.load();
+        if (published == 0) {
+            return nullptr;
+        }
+
+        // Another thread is looking at this request on behalf of a resource in a different
+        // bucket. It either puts the request back or moves it, so wait and look again.
+        if (published & kFastPathSlotPinned) {
+            stdx::this_thread::yield();
+            continue;
+        }
+
+        if (slot.compareAndSwap(published, published | kFastPathSlotPinned) == published) {
+            return reinterpret_cast<LockRequest*>(published);
+        }
+    }
+}
+
+void LockManager::_unblockFastPath(ResourceId resId, LockRequest* request) {
+    if (!request->blocksFastPath) {
+        return;
+    }
+
+    request->blocksFastPath = false;
+    _fastPathBlockCounts[resId % _numFastPathBlockCounts].fetchAndSubtract(1);
+}
+
 LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
@@ -828,11 +1101,13 @@ void LockManager::dump() const {
 
 void LockManager::_dumpBucketToBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                                     const LockBucket* bucket,
+                                    std::map<ResourceId, std::vector<BSONObj>>* fastPathLocks,
                                     BSONObjBuilder* result) {
     for (auto& bucketEntry : bucket->data) {
         const LockHead* lock = bucketEntry.second;
 
-        if (lock->grantedList.empty()) {
+        auto fastPathIt = fastPathLocks->find(lock->resourceId);
+        if (lock->grantedList.empty() && fastPathIt == fastPathLocks->end()) {
             // If there are no granted requests, this lock is empty, so no need to print it
             continue;
         }
@@ -844,6 +1119,12 @@ void LockManager::_dumpBucketToBSON(const std::map<LockerId, BSONObj>& lockToCli
              iter = iter->next) {
             _buildBucketBSON(iter, lockToClientMap, bucket, &grantedLocks);
         }
+        if (fastPathIt != fastPathLocks->end()) {
+            for (const auto& info : fastPathIt->second) {
+                grantedLocks.append(info);
+            }
+            fastPathLocks->erase(fastPathIt);
+        }
         result->append("granted", grantedLocks.arr());
 
         BSONArrayBuilder pendingLocks;
@@ -859,22 +1140,40 @@ void LockManager::_buildBucketBSON(const LockRequest* iter,
                                    const std::map<LockerId, BSONObj>& lockToClientMap,
                                    const LockBucket* bucket,
                                    BSONArrayBuilder* locks) {
+    locks->append(_lockRequestToBSON(iter, lockToClientMap));
+}
+
+BSONObj LockManager::_lockRequestToBSON(const LockRequest* request,
+                                        const std::map<LockerId, BSONObj>& lockToClientMap) {
     BSONObjBuilder info;
-    info.append("mode", modeName(iter->mode));
-    info.append("convertMode", modeName(iter->convertMode));
-    info.append("enqueueAtFront", iter->enqueueAtFront);
-    info.append("compatibleFirst", iter->compatibleFirst);
+    info.append("mode", modeName(request->mode));
+    info.append("convertMode", modeName(request->convertMode));
+    info.append("enqueueAtFront", request->enqueueAtFront);
+    info.append("compatibleFirst", request->compatibleFirst);
 
-    LockerId lockerId = iter->locker->getId();
+    LockerId lockerId = request->locker->getId();
     std::map<LockerId, BSONObj>::const_iterator it = lockToClientMap.find(lockerId);
     if (it != lockToClientMap.end()) {
         info.appendElements(it->second);
     }
-    locks->append(info.obj());
+    return info.obj();
 }
 
 void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                                   BSONObjBuilder* result) {
+    // Collect the requests granted on the fast path first, without holding any bucket mutex, as
+    // pinning a slot may have to wait for a thread which moves requests under one.
+    std::map<ResourceId, std::vector<BSONObj>> fastPathLocks;
+    const unsigned numSlots = _numFastPathSlotGroups * _numFastPathSlotsPerGroup;
+    for (unsigned i = 0; i < numSlots; i++) {
+        AtomicWord<uintptr_t>& slot = _getFastPathSlot(i);
+        if (LockRequest* request = _pinFastPathSlot(slot)) {
+            fastPathLocks[request->fastPathResId].push_back(
+                _lockRequestToBSON(request, lockToClientMap));
+            slot.store(reinterpret_cast<uintptr_t>(request));
+        }
+    }
+
     BSONArrayBuilder lockInfo;
     for (unsigned i = 0; i < _numLockBuckets; i++) {
         LockBucket* bucket = &_lockBuckets[i];
@@ -883,13 +1182,165 @@ void LockManager::getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClien
         _cleanupUnusedLocksInBucket(bucket);
         if (!bucket->data.empty()) {
             BSONObjBuilder b;
-            _dumpBucketToBSON(lockToClientMap, bucket, &b);
+            _dumpBucketToBSON(lockToClientMap, bucket, &fastPathLocks, &b);
             lockInfo.append(b.obj());
         }
     }
+
+    // Resources which are only locked on the fast path have no LockHead.
+    for (const auto& entry : fastPathLocks) {
+        BSONObjBuilder b;
+        b.append("resourceId", entry.first.toString());
+
+        BSONArrayBuilder grantedLocks;
+        for (const auto& info : entry.second) {
+            grantedLocks.append(info);
+        }
+        b.append("granted", grantedLocks.arr());
+        b.append("pending", BSONArray());
+        lockInfo.append(b.obj());
+    }
     result->append("lockInfo", lockInfo.arr());
 }
 
+std::vector<LockManager::WaitingRequest> LockManager::getWaitForGraph() const {
+    std::vector<WaitingRequest> waiters;
+
+    auto addWaiter = [&waiters](const LockHead* lock, const LockRequest* request) {
+        const bool converting = (request->status == LockRequest::STATUS_CONVERTING);
+
+        WaitingRequest waiter;
+        waiter.lockerId = request->locker->getId();
+        waiter.resourceId = lock->resourceId;
+        waiter.mode = converting ? request->convertMode : request->mode;
+        waiter.converting = converting;
+
+        forEachBlockingRequest(lock, request, [&](const LockRequest* blocker) {
+            waiter.blockers.push_back({blocker->locker->getId(),
+                                       blocker->mode,
+                                       blocker->status != LockRequest::STATUS_WAITING});
+        });
+
+        waiters.push_back(std::move(waiter));
+    };
+
+    for (unsigned i = 0; i < _numLockBuckets; i++) {
+        LockBucket* bucket = &_lockBuckets[i];
+        stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+        for (const auto& bucketEntry : bucket->data) {
+            const LockHead* lock = bucketEntry.second;
+
+            // Conversions wait on the granted list, everything else on the conflict list
+            if (lock->conversionsCount > 0) {
+                for (const LockRequest* it = lock->grantedList._front; it != nullptr;
+                     it = it->next) {
+                    if (it->status == LockRequest::STATUS_CONVERTING) {
+                        addWaiter(lock, it);
+                    }
+                }
+            }
+
+            for (const LockRequest* it = lock->conflictList._front; it != nullptr; it = it->next) {
+                addWaiter(lock, it);
+            }
+        }
+    }
+
+    return waiters;
+}
+
+std::vector<std::vector<size_t>> LockManager::findWaitCycles(
+    const std::vector<WaitingRequest>& waiters) {
+    const size_t numWaiters = waiters.size();
+
+    // A locker waits for one request at a time, so it is one node of the graph. Should the graph
+    // list a locker twice because it was collected one bucket at a time, its first entry is used.
+    stdx::unordered_map<LockerId, size_t> nodeOfLocker;
+    for (size_t i = 0; i < numWaiters; i++) {
+        nodeOfLocker.emplace(waiters[i].lockerId, i);
+    }
+
+    // Only blockers which are waiting themselves can be part of a cycle
+    std::vector<std::vector<size_t>> successors(numWaiters);
+    for (size_t i = 0; i < numWaiters; i++) {
+        for (const auto& blocker : waiters[i].blockers) {
+            auto it = nodeOfLocker.find(blocker.lockerId);
+            if (it != nodeOfLocker.end()) {
+                successors[i].push_back(it->second);
+            }
+        }
+    }
+
+    // Tarjan's algorithm, with an explicit stack rather than recursion, as there may be thousands
+    // of waiters
+    const size_t kUnvisited = std::numeric_limits<size_t>::max();
+    std::vector<size_t> index(numWaiters, kUnvisited);
+    std::vector<size_t> lowLink(numWaiters, 0);
+    std::vector<bool> onStack(numWaiters, false);
+    std::vector<size_t> stack;
+    size_t nextIndex = 0;
+
+    // Each frame is a node being visited and the position of its next successor to visit
+    std::vector<std::pair<size_t, size_t>> frames;
+    std::vector<std::vector<size_t>> cycles;
+
+    auto visit = [&](size_t node) {
+        index[node] = lowLink[node] = nextIndex++;
+        stack.push_back(node);
+        onStack[node] = true;
+        frames.emplace_back(node, 0);
+    };
+
+    for (size_t root = 0; root < numWaiters; root++) {
+        if (index[root] != kUnvisited) {
+            continue;
+        }
+
+        visit(root);
+        while (!frames.empty()) {
+            const size_t node = frames.back().first;
+            if (frames.back().second < successors[node].size()) {
+                const size_t next = successors[node][frames.back().second++];
+                if (index[next] == kUnvisited) {
+                    visit(next);
+                } else if (onStack[next]) {
+                    lowLink[node] = std::min(lowLink[node], index[next]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            if (!frames.empty()) {
+                const size_t parent = frames.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+
+            if (lowLink[node] != index[node]) {
+                continue;
+            }
+
+            std::vector<size_t> component;
+            size_t member;
+            do {
+                member = stack.back();
+                stack.pop_back();
+                onStack[member] = false;
+                component.push_back(member);
+            } while (member != node);
+
+            const bool waitsForItself =
+                std::find(successors[node].begin(), successors[node].end(), node) !=
+                successors[node].end();
+            if (component.size() > 1 || waitsForItself) {
+                cycles.push_back(std::move(component));
+            }
+        }
+    }
+
+    return cycles;
+}
+
 void LockManager::_dumpBucket(const LockBucket* bucket) const {
     for (LockBucket::Map::const_iterator it = bucket->data.begin(); it != bucket->data.end();
          it++) {
@@ -974,12 +1425,15 @@ LockHead* LockManager::LockBucket::findOrInsert(ResourceId resId) {
 //
 
 DeadlockDetector::DeadlockDetector(const LockManager& lockMgr, const Locker* initialLocker)
-    : _lockMgr(lockMgr), _initialLockerId(initialLocker->getId()), _foundCycle(false) {
-    const ResourceId resId = initialLocker->getWaitingResource();
+    : DeadlockDetector(lockMgr, initialLocker->getId(), initialLocker->getWaitingResource()) {}
 
+DeadlockDetector::DeadlockDetector(const LockManager& lockMgr,
+                                   LockerId initialLockerId,
+                                   ResourceId waitingResId)
+    : _lockMgr(lockMgr), _initialLockerId(initialLockerId), _foundCycle(false) {
     // If there is no resource waiting there is nothing to do
-    if (resId.isValid()) {
-        _queue.push_front(UnprocessedNode(_initialLockerId, resId));
+    if (waitingResId.isValid()) {
+        _queue.push_front(UnprocessedNode(_initialLockerId, waitingResId));
     }
 }
 
@@ -1020,6 +1474,15 @@ std::string DeadlockDetector::toString() const {
     return sb.str();
 }
 
+std::vector<LockerId> DeadlockDetector::getWaitingLockerIds() const {
+    std::vector<LockerId> lockerIds;
+    for (const auto& node : _graph) {
+        lockerIds.push_back(node.first);
+    }
+
+    return lockerIds;
+}
+
 void DeadlockDetector::_processNextNode(const UnprocessedNode& node) {
     // Locate the request
     LockManager::LockBucket* bucket = _lockMgr._getBucket(node.resId);
@@ -1053,64 +1516,15 @@ void DeadlockDetector::_processNextNode(const UnprocessedNode& node) {
 
     Edges& edges = val.first->second;
 
-    bool seen = false;
-    for (LockRequest* it = lock->grantedList._back; it != nullptr; it = it->prev) {
-        // We can't conflict with ourselves
-        if (it == request) {
-            seen = true;
-            continue;
-        }
+    forEachBlockingRequest(lock, request, [&](const LockRequest* blocker) {
+        const LockerId lockerId = blocker->locker->getId();
+        const ResourceId waitResId = blocker->locker->getWaitingResource();
 
-        // If we are a regular conflicting request, both granted and conversion modes need to
-        // be checked for conflict, since conversions will be granted first.
-        if (request->status == LockRequest::STATUS_WAITING) {
-            if (conflicts(request->mode, modeMask(it->mode)) ||
-                conflicts(request->mode, modeMask(it->convertMode))) {
-                const LockerId lockerId = it->locker->getId();
-                const ResourceId waitResId = it->locker->getWaitingResource();
-
-                if (waitResId.isValid()) {
-                    _queue.push_front(UnprocessedNode(lockerId, waitResId));
-                    edges.owners.push_back(lockerId);
-                }
-            }
-
-            continue;
-        }
-
-        // If we are a conversion request, only requests, which are before us need to be
-        // accounted for.
-        invariant(request->status == LockRequest::STATUS_CONVERTING);
-
-        if (conflicts(request->convertMode, modeMask(it->mode)) ||
-            (seen && conflicts(request->convertMode, modeMask(it->convertMode)))) {
-            const LockerId lockerId = it->locker->getId();
-            const ResourceId waitResId = it->locker->getWaitingResource();
-
-            if (waitResId.isValid()) {
-                _queue.push_front(UnprocessedNode(lockerId, waitResId));
-                edges.owners.push_back(lockerId);
-            }
+        if (waitResId.isValid()) {
+            _queue.push_front(UnprocessedNode(lockerId, waitResId));
+            edges.owners.push_back(lockerId);
         }
-    }
-
-    // All conflicting waits, which would be granted before us
-    for (LockRequest* it = request->prev;
-         (request->status == LockRequest::STATUS_WAITING) && (it != nullptr);
-         it = it->prev) {
-        // We started from the previous element, so we should never see ourselves
-        invariant(it != request);
-
-        if (conflicts(request->mode, modeMask(it->mode))) {
-            const LockerId lockerId = it->locker->getId();
-            const ResourceId waitResId = it->locker->getWaitingResource();
-
-            if (waitResId.isValid()) {
-                _queue.push_front(UnprocessedNode(lockerId, waitResId));
-                edges.owners.push_back(lockerId);
-            }
-        }
-    }
+    });
 }
 
 
@@ -1170,6 +1584,9 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    fastPathSlot = -1;
+    fastPathResId = ResourceId();
+    blocksFastPath = false;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -41,6 +42,7 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/new.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -49,6 +51,13 @@ namespace mongo {
 /**
  * Entry point for the lock manager scheduling functionality. Don't use it directly, but
  * instead go through the Locker interface.
+ *
+ * Intent requests on the global, database and collection resources are first tried on a lock-free
+ * fast path: the request is published to a slot and granted without taking any mutex, as long as
+ * no non-intent request is present on its resource. A non-intent request first disables the fast
+ * path for its resource and moves the published requests onto the regular LockHead, so conflicts,
+ * deadlock detection and dump() only ever need to look at the LockHead. getLockInfoBSON() also
+ * reports the requests granted on the fast path.
  */
 class LockManager {
     MONGO_DISALLOW_COPYING(LockManager);
@@ -131,6 +140,44 @@ public:
     void getLockInfoBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                          BSONObjBuilder* result);
 
+    /**
+     * A lock request which is waiting to be granted, together with the requests which it has to
+     * wait for. Those are the granted requests it conflicts with and the conflicting requests
+     * queued ahead of it.
+     */
+    struct WaitingRequest {
+        struct Blocker {
+            LockerId lockerId;
+            LockMode mode;
+            bool granted;
+        };
+
+        LockerId lockerId;
+        ResourceId resourceId;
+
+        // The mode being waited for, which for a conversion is the mode being converted to
+        LockMode mode;
+        bool converting;
+
+        std::vector<Blocker> blockers;
+    };
+
+    /**
+     * Returns all lock requests which are currently waiting, which is the wait-for graph of the
+     * lock manager. Each bucket is examined under its own mutex, so the result is not a
+     * consistent snapshot of all resources, but every edge in it existed at some point.
+     */
+    std::vector<WaitingRequest> getWaitForGraph() const;
+
+    /**
+     * Finds the cycles among the edges of a graph returned by getWaitForGraph(), in a single pass
+     * over it. Returns the strongly connected components which contain a cycle, each as the
+     * indexes of its waiters in 'waiters'. As the graph is not a consistent snapshot, a cycle
+     * should be confirmed through DeadlockDetector before it is reported.
+     */
+    static std::vector<std::vector<size_t>> findWaitCycles(
+        const std::vector<WaitingRequest>& waiters);
+
 private:
     // The deadlock detector needs to access the buckets and locks directly
     friend class DeadlockDetector;
@@ -176,10 +223,13 @@ private:
     void _dumpBucket(const LockBucket* bucket) const;
 
     /**
-     * Dump the contents of a bucket to the BSON.
+     * Dump the contents of a bucket to the BSON. Requests granted on the fast path for the
+     * resources of the bucket are reported along with the granted requests of their LockHead and
+     * removed from 'fastPathLocks'.
      */
     void _dumpBucketToBSON(const std::map<LockerId, BSONObj>& lockToClientMap,
                            const LockBucket* bucket,
+                           std::map<ResourceId, std::vector<BSONObj>>* fastPathLocks,
                            BSONObjBuilder* result);
 
     /**
@@ -191,6 +241,8 @@ private:
                           const std::map<LockerId, BSONObj>& lockToClientMap,
                           const LockBucket* bucket,
                           BSONArrayBuilder* locks);
+    static BSONObj _lockRequestToBSON(const LockRequest* request,
+                                      const std::map<LockerId, BSONObj>& lockToClientMap);
 
     /**
      * Should be invoked when the state of a lock changes in a way, which could potentially
@@ -211,11 +263,71 @@ private:
      */
     void _cleanupUnusedLocksInBucket(LockBucket* bucket);
 
+    /**
+     * Tries to grant an intent mode request without taking any mutex. Returns false if the request
+     * must go through the regular path instead. Otherwise returns true and sets 'result', which is
+     * LOCK_WAITING if a conflicting request moved this one onto the LockHead before it could be
+     * granted.
+     */
+    bool _lockFastPath(ResourceId resId, LockRequest* request, LockResult* result);
+
+    /**
+     * Removes a request from its fast path slot. Returns false if a conflicting request has
+     * already moved it onto the LockHead.
+     */
+    bool _releaseFastPathSlot(LockRequest* request);
+
+    /**
+     * Takes a request the Locker holds on the fast path off it and puts it on the granted queue of
+     * 'lock', unless it has already been moved there. MUST be called under the lock bucket's mutex.
+     */
+    void _leaveFastPath(LockHead* lock, LockRequest* request);
+
+    /**
+     * Called for requests in non-intent modes before their conflicts are checked. Disables the
+     * fast path for the resource until the request goes away or downgrades to an intent mode,
+     * and moves any requests already granted on the fast path onto 'lock'.
+     *
+     * MUST be called under the lock bucket's mutex.
+     */
+    void _blockFastPath(LockHead* lock, LockRequest* request);
+    void _unblockFastPath(ResourceId resId, LockRequest* request);
+
+    /**
+     * Returns the fast path slot with the given index, counting across all groups.
+     */
+    AtomicWord<uintptr_t>& _getFastPathSlot(unsigned index);
+
+    /**
+     * Pins the request published in 'slot', so that its owner cannot remove it while another
+     * thread reads it. Returns nullptr if the slot is empty. The caller must unpin the slot by
+     * storing the request back, or zero if it moved the request onto a LockHead.
+     */
+    static LockRequest* _pinFastPathSlot(AtomicWord<uintptr_t>& slot);
+
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    // Fast path slots hold the address of a granted LockRequest, or zero. Lockers publish to the
+    // group of slots picked by their id, and each group is aligned to a cache line of its own.
+    // Every non-intent request on a fast path resource scans all slots, so keep the total small.
+    static constexpr unsigned _numFastPathSlotGroups = 128;
+    static constexpr unsigned _numFastPathSlotsPerGroup = 8;
+
+    struct alignas(stdx::hardware_destructive_interference_size) FastPathSlotGroup {
+        std::array<AtomicWord<uintptr_t>, _numFastPathSlotsPerGroup> slots;
+    };
+
+    // Kept inline rather than allocated, so that the alignment of the groups is honored.
+    std::array<FastPathSlotGroup, _numFastPathSlotGroups> _fastPathSlotGroups;
+
+    // Number of non-intent requests on the resources hashing to each counter. The fast path is
+    // only used for a resource while its counter is zero.
+    static const unsigned _numFastPathBlockCounts;
+    AtomicWord<uint32_t>* _fastPathBlockCounts;
 };
 
 
@@ -237,6 +349,12 @@ public:
      */
     DeadlockDetector(const LockManager& lockMgr, const Locker* initialLocker);
 
+    /**
+     * Same as above, but starts from a locker which is known only by its id and the resource it
+     * was seen waiting for, for example one obtained from LockManager::getWaitForGraph.
+     */
+    DeadlockDetector(const LockManager& lockMgr, LockerId initialLockerId, ResourceId waitingResId);
+
     DeadlockDetector& check() {
         while (next()) {
         }
@@ -264,6 +382,11 @@ public:
      */
     std::string toString() const;
 
+    /**
+     * Returns the ids of the waiting lockers, which are part of the graph built so far.
+     */
+    std::vector<LockerId> getWaitingLockerIds() const;
+
 private:
     // An entry in the owners list below means that some locker L is blocked on some resource
     // resId, which is currently held by the given set of owners. The reason to store it in
@@ -393,6 +393,31 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Index of the LockManager fast path slot this request was granted through, or -1 if it was
+    // not granted on the fast path or has since left it. A request leaves the fast path when it
+    // converts or unlocks, or when a conflicting request moves it onto the regular LockHead, in
+    // which case 'lock' is set and the slot no longer references the request.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    int fastPathSlot;
+
+    // The resource a fast path request was published for. Conflicting requests read it to find
+    // the fast path requests they need to move onto their LockHead.
+    //
+    // Written by LockManager on Locker thread before the request is published to a slot
+    // Read by LockManager on any thread while the slot holding the request is pinned
+    ResourceId fastPathResId;
+
+    // Whether this request holds or waits for a non-intent mode on a resource that supports the
+    // fast path, and so keeps new intent requests for that resource off the fast path.
+    //
+    // Written by LockManager on any thread
+    // Read by LockManager on any thread
+    // Protected by LockHead bucket's mutex
+    bool blocksFastPath;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
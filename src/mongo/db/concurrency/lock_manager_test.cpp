@@ -28,6 +28,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -596,6 +597,213 @@ TEST(LockManager, Downgrade) {
     ASSERT(lockMgr.unlock(&request2));
 }
 
+TEST(LockManager, FastPathIntentRequestsConflictWithExclusive) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+
+    // The exclusive request has to wait for the intent requests granted before it
+    MMAPV1LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_X));
+
+    // New intent requests queue up behind it
+    MMAPV1LockerImpl locker4;
+    LockRequestCombo request4(&locker4);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request4, MODE_IS));
+
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(request3.numNotifies == 0);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(request3.numNotifies == 1);
+    ASSERT(request3.lastResult == LOCK_OK);
+    ASSERT(request4.numNotifies == 0);
+
+    ASSERT(lockMgr.unlock(&request3));
+    ASSERT(request4.numNotifies == 1);
+    ASSERT(request4.lastResult == LOCK_OK);
+
+    // Once the exclusive request is gone, intent requests are granted right away again
+    MMAPV1LockerImpl locker5;
+    LockRequestCombo request5(&locker5);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request5, MODE_IX));
+
+    ASSERT(lockMgr.unlock(&request4));
+    ASSERT(lockMgr.unlock(&request5));
+}
+
+TEST(LockManager, FastPathIntentRequestConvertsUp) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+
+    // Upgrading past an intent mode has to wait for the other intent request
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT(request1.mode == MODE_IX);
+    ASSERT(request1.convertMode == MODE_X);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(request1.numNotifies == 1);
+    ASSERT(request1.lastResult == LOCK_OK);
+    ASSERT(request1.mode == MODE_X);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+}
+
+TEST(LockManager, FastPathIntentRequestsAreExcludedUnderContention) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    // Holders of each mode on the resource. Every thread counts itself in once its request is
+    // granted and then checks the modes it conflicts with, so any overlap is seen by one side.
+    AtomicWord<int> isHolders{0};
+    AtomicWord<int> ixHolders{0};
+    AtomicWord<int> sHolders{0};
+    AtomicWord<int> xHolders{0};
+    AtomicWord<int> violations{0};
+    AtomicWord<bool> done{false};
+
+    auto grant = [&](LockResult result, CondVarLockGrantNotification* notify) {
+        if (result == LOCK_WAITING) {
+            result = notify->wait(Minutes(1));
+        }
+        if (result != LOCK_OK) {
+            violations.fetchAndAdd(1);
+        }
+    };
+
+    std::vector<stdx::thread> intentThreads;
+    for (int i = 0; i < 8; i++) {
+        intentThreads.emplace_back([&, i] {
+            MMAPV1LockerImpl locker;
+            CondVarLockGrantNotification notify;
+            const LockMode mode = (i % 2) ? MODE_IX : MODE_IS;
+            AtomicWord<int>& holders = (mode == MODE_IX) ? ixHolders : isHolders;
+
+            while (!done.load()) {
+                LockRequest request;
+                request.initNew(&locker, &notify);
+                notify.clear();
+                grant(lockMgr.lock(resId, &request, mode), &notify);
+
+                holders.fetchAndAdd(1);
+                if (xHolders.load() != 0 || (mode == MODE_IX && sHolders.load() != 0)) {
+                    violations.fetchAndAdd(1);
+                }
+                holders.fetchAndSubtract(1);
+
+                lockMgr.unlock(&request);
+            }
+        });
+    }
+
+    MMAPV1LockerImpl locker;
+    CondVarLockGrantNotification notify;
+    auto checkExclusive = [&] {
+        xHolders.fetchAndAdd(1);
+        if (isHolders.load() != 0 || ixHolders.load() != 0 || sHolders.load() != 0) {
+            violations.fetchAndAdd(1);
+        }
+        xHolders.fetchAndSubtract(1);
+    };
+
+    for (int i = 0; i < 1000; i++) {
+        // Plain exclusive lock
+        {
+            LockRequest request;
+            request.initNew(&locker, &notify);
+            notify.clear();
+            grant(lockMgr.lock(resId, &request, MODE_X), &notify);
+            checkExclusive();
+            lockMgr.unlock(&request);
+        }
+
+        // Shared lock converted to exclusive
+        {
+            LockRequest request;
+            request.initNew(&locker, &notify);
+            notify.clear();
+            grant(lockMgr.lock(resId, &request, MODE_S), &notify);
+
+            sHolders.fetchAndAdd(1);
+            if (ixHolders.load() != 0 || xHolders.load() != 0) {
+                violations.fetchAndAdd(1);
+            }
+            sHolders.fetchAndSubtract(1);
+
+            notify.clear();
+            grant(lockMgr.convert(resId, &request, MODE_X), &notify);
+            checkExclusive();
+            lockMgr.unlock(&request);
+            lockMgr.unlock(&request);
+        }
+
+        // Intent lock, which may be granted on the fast path, converted to exclusive
+        {
+            LockRequest request;
+            request.initNew(&locker, &notify);
+            notify.clear();
+            grant(lockMgr.lock(resId, &request, MODE_IS), &notify);
+
+            notify.clear();
+            grant(lockMgr.convert(resId, &request, MODE_X), &notify);
+            checkExclusive();
+            lockMgr.unlock(&request);
+            lockMgr.unlock(&request);
+        }
+    }
+
+    done.store(true);
+    for (auto& thread : intentThreads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(violations.load(), 0);
+}
+
+TEST(LockManager, LockInfoReportsFastPathIntentRequests) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    MMAPV1LockerImpl locker;
+    LockRequestCombo request(&locker);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request, MODE_IX));
+
+    BSONObjBuilder builder;
+    lockMgr.getLockInfoBSON({}, &builder);
+    const BSONObj lockInfo = builder.obj();
+
+    bool found = false;
+    for (const auto& entry : lockInfo["lockInfo"].Obj()) {
+        if (entry.Obj()["resourceId"].str() != resId.toString())
+            continue;
+
+        const auto granted = entry.Obj()["granted"].Array();
+        ASSERT_EQ(granted.size(), 1U);
+        ASSERT_EQ(granted[0].Obj()["mode"].str(), "IX");
+        found = true;
+    }
+    ASSERT(found);
+
+    ASSERT(lockMgr.unlock(&request));
+}
+
 
 // Lock conflict matrix tests
 static void checkConflict(LockMode existingMode, LockMode newMode, bool hasConflict) {
@@ -34,10 +34,13 @@
 
 #include <vector>
 
+#include "mongo/db/client.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
+#include "mongo/transport/session.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
@@ -126,6 +129,13 @@ AtomicUInt64 idCounter(0);
 // Partitioned global lock statistics, so we don't hit the same bucket
 PartitionedInstanceWideLockStats globalStats;
 
+// Record the wait time of one out of every lockWaitHistogramSampleRate lock acquisitions which had
+// to wait. Zero or less turns the histogram off.
+MONGO_EXPORT_SERVER_PARAMETER(lockWaitHistogramSampleRate, int, 1);
+
+// Sampled wait times of lock acquisitions, reported through serverStatus
+LockWaitHistogram globalWaitHistogram;
+
 }  // namespace
 
 template <bool IsForMMAPV1>
@@ -243,6 +253,23 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+TicketHolder* priorityTicketHolders[LockModesCount] = {};
+
+/**
+ * Whether the operation may use the priority ticket lanes: operations that do not come from a
+ * user connection are internal (replication, TTL and the like), and connections from other
+ * members of the cluster are tagged as internal clients.
+ */
+bool hasTicketPriority(OperationContext* opCtx) {
+    auto client = opCtx ? opCtx->getClient() : nullptr;
+    if (!client)
+        return false;
+    if (!client->isFromUserConnection())
+        return true;
+
+    auto session = client->session();
+    return session && (session->getTags() & transport::Session::kInternalClient);
+}
 }  // namespace
 
 
@@ -257,9 +284,25 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+void Locker::setGlobalPriorityThrottling(class TicketHolder* reading,
+                                         class TicketHolder* writing) {
+    priorityTicketHolders[MODE_S] = reading;
+    priorityTicketHolders[MODE_IS] = reading;
+    priorityTicketHolders[MODE_IX] = writing;
+}
+
+/* static */
+TicketHolder* Locker::getGlobalThrottling(LockMode mode) {
+    return ticketHolders[mode];
+}
+
 template <bool IsForMMAPV1>
 LockerImpl<IsForMMAPV1>::LockerImpl()
-    : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
+    : _id(idCounter.addAndFetch(1)),
+      _numLockWaits(_id),
+      _wuowNestingLevel(0),
+      _threadId(stdx::this_thread::get_id()) {}
 
 template <bool IsForMMAPV1>
 stdx::thread::id LockerImpl<IsForMMAPV1>::getThreadId() const {
@@ -285,9 +328,21 @@ LockerImpl<IsForMMAPV1>::~LockerImpl() {
     invariant(_numResourcesToUnlockAtEndUnitOfWork == 0);
     invariant(_requests.empty());
     invariant(_modeForTicket == MODE_NONE);
+}
+
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::resetForReuse() {
+    if (inAWriteUnitOfWork() || _numResourcesToUnlockAtEndUnitOfWork > 0 || !_requests.empty() ||
+        _modeForTicket != MODE_NONE || _uninterruptibleLocksRequested > 0) {
+        return false;
+    }
 
-    // Reset the locking statistics so the object can be reused
     _stats.reset();
+    _clientState.store(kInactive);
+    _sharedLocksShouldTwoPhaseLock = false;
+    setShouldConflictWithSecondaryBatchApplication(true);
+    setShouldAcquireTicket(true);
+    return true;
 }
 
 template <bool IsForMMAPV1>
@@ -334,13 +389,27 @@ LockResult LockerImpl<IsForMMAPV1>::_acquireTicket(OperationContext* opCtx,
 
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
-        if (deadline == Date_t::max()) {
+
+        bool acquired = false;
+        auto priorityHolder = priorityTicketHolders[mode];
+        if (priorityHolder && hasTicketPriority(opCtx)) {
+            // Internal operations that find the regular tickets taken queue for the reserved ones
+            // instead, where user operations cannot get ahead of them.
+            acquired = holder->tryAcquire();
+            if (!acquired)
+                holder = priorityHolder;
+        }
+
+        if (acquired) {
+            // Got a regular ticket without waiting.
+        } else if (deadline == Date_t::max()) {
             holder->waitForTicket(opCtx);
         } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
             return LOCK_TIMEOUT;
         }
         restoreStateOnErrorGuard.Dismiss();
     }
+    _ticketHolder = holder;
     _clientState.store(reader ? kActiveReader : kActiveWriter);
     return LOCK_OK;
 }
@@ -625,7 +694,7 @@ void LockerImpl<IsForMMAPV1>::getLockerInfo(LockerInfo* lockerInfo) const {
     std::sort(lockerInfo->locks.begin(), lockerInfo->locks.end());
 
     lockerInfo->waitingResource = getWaitingResource();
-    lockerInfo->stats.append(_stats);
+    _stats.appendTo(&lockerInfo->stats);
 }
 
 template <bool IsForMMAPV1>
@@ -847,6 +916,16 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(
         _unlockImpl(&it);
     });
 
+    // Record the wait however it ends, including when it is interrupted. Sample on a per-locker
+    // counter rather than on a shared one, so that deciding whether to record it does not add
+    // contention of its own.
+    auto recordWaitGuard = MakeGuard([&] {
+        const int sampleRate = lockWaitHistogramSampleRate.load();
+        if (sampleRate > 0 && _numLockWaits++ % sampleRate == 0) {
+            globalWaitHistogram.record(resId, curTimeMicros64() - startOfTotalWaitTime);
+        }
+    });
+
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
         // wait time anyways.
@@ -915,9 +994,9 @@ void LockerImpl<IsForMMAPV1>::releaseTicket() {
 
 template <bool IsForMMAPV1>
 void LockerImpl<IsForMMAPV1>::_releaseTicket() {
-    auto holder = shouldAcquireTicket() ? ticketHolders[_modeForTicket] : nullptr;
-    if (holder) {
-        holder->release();
+    if (_ticketHolder) {
+        _ticketHolder->release();
+        _ticketHolder = nullptr;
     }
     _clientState.store(kInactive);
 }
@@ -1076,8 +1155,17 @@ void reportGlobalLockingStats(SingleThreadedLockStats* outStats) {
     globalStats.report(outStats);
 }
 
+void reportGlobalLockWaitHistogram(BSONObjBuilder* builder) {
+    globalWaitHistogram.report(builder);
+}
+
+void noteGlobalLockWaitResourceName(ResourceId resId, StringData name) {
+    globalWaitHistogram.noteResourceName(resId, name);
+}
+
 void resetGlobalLockStats() {
     globalStats.reset();
+    globalWaitHistogram.reset();
 }
 
 
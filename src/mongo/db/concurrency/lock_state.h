@@ -103,6 +103,13 @@ public:
 
     virtual ~LockerImpl();
 
+    /**
+     * Returns this locker to the state of a newly constructed one so that another operation can
+     * use it, keeping its id and the memory of its lock request map. Returns false without
+     * changing anything if the locker still holds locks, a ticket or a unit of work.
+     */
+    bool resetForReuse();
+
     virtual ClientState getClientState() const;
 
     virtual LockerId getId() const {
@@ -307,7 +314,12 @@ private:
 
     // Per-locker locking statistics. Reported in the slow-query log message and through
     // db.currentOp. Complementary to the per-instance locking statistics.
-    SingleThreadedLockStats _stats;
+    CompactLockStats _stats;
+
+    // Number of lock acquisitions which had to wait, used to sample one out of every
+    // lockWaitHistogramSampleRate of them. Starts at the locker id rather than zero, so that
+    // lockers which only wait once are still sampled at that rate.
+    uint64_t _numLockWaits;
 
     // Delays release of exclusive/intent-exclusive locked resources until the write unit of
     // work completes. Value of 0 means we are not inside a write unit of work.
@@ -316,6 +328,10 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // The TicketHolder the ticket was taken from, which is either the regular or the priority
+    // one for _modeForTicket, or nullptr if no ticket is held.
+    TicketHolder* _ticketHolder = nullptr;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
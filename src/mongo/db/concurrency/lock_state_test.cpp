@@ -427,6 +427,45 @@ TEST(LockerImpl, GetLockerInfoShouldReportHeldLocks) {
     ASSERT(locker.unlockGlobal());
 }
 
+TEST(LockerImpl, ResetForReuseRefusesLockerHoldingLocks) {
+    DefaultLockerImpl locker;
+    ASSERT_EQ(LOCK_OK, locker.lockGlobal(MODE_IX));
+    ASSERT_FALSE(locker.resetForReuse());
+    ASSERT(locker.unlockGlobal());
+}
+
+TEST(LockerImpl, ResetForReuseClearsPerOperationState) {
+    const ResourceId collectionId(RESOURCE_COLLECTION, "TestDB.collection"_sd);
+
+    DefaultLockerImpl locker;
+    const LockerId id = locker.getId();
+    locker.setSharedLocksShouldTwoPhaseLock(true);
+    locker.setShouldConflictWithSecondaryBatchApplication(false);
+    ASSERT_EQ(LOCK_OK, locker.lockGlobal(MODE_IX));
+    ASSERT_EQ(LOCK_OK, locker.lock(collectionId, MODE_IX));
+    ASSERT(locker.unlock(collectionId));
+    ASSERT(locker.unlockGlobal());
+
+    ASSERT(locker.resetForReuse());
+    ASSERT_EQ(id, locker.getId());
+    ASSERT(locker.shouldConflictWithSecondaryBatchApplication());
+    ASSERT_EQ(Locker::kInactive, locker.getClientState());
+
+    // The statistics of the previous operation are gone.
+    Locker::LockerInfo lockerInfo;
+    locker.getLockerInfo(&lockerInfo);
+    ASSERT_EQ(0, lockerInfo.stats.get(collectionId, MODE_IX).numAcquisitions);
+
+    // Shared locks no longer take part in two-phase locking.
+    ASSERT_EQ(LOCK_OK, locker.lockGlobal(MODE_IS));
+    ASSERT_EQ(LOCK_OK, locker.lock(collectionId, MODE_IS));
+    locker.beginWriteUnitOfWork();
+    ASSERT(locker.unlock(collectionId));
+    ASSERT(locker.isLockHeldForMode(collectionId, MODE_NONE));
+    locker.endWriteUnitOfWork();
+    ASSERT(locker.unlockGlobal());
+}
+
 TEST(LockerImpl, GetLockerInfoShouldReportPendingLocks) {
     const ResourceId globalId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
     const ResourceId dbId(RESOURCE_DATABASE, "TestDB"_sd);
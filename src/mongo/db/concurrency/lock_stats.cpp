@@ -30,7 +30,11 @@
 
 #include "mongo/db/concurrency/lock_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 
@@ -146,6 +150,129 @@ void LockStats<CounterType>::reset() {
     }
 }
 
+void CompactLockStats::appendTo(SingleThreadedLockStats* outStats) const {
+    uint64_t used = _used;
+    while (used) {
+        const int slot = countTrailingZeros64(used);
+        used &= used - 1;
+
+        const int type = slot / LockModesCount;
+        const int mode = slot % LockModesCount;
+        auto& outCounters = (type == ResourceTypesCount) ? outStats->_oplogStats.modeStats[mode]
+                                                         : outStats->_stats[type].modeStats[mode];
+        outCounters.append(_counters[slot]);
+    }
+}
+
+namespace {
+
+// Names of the LockWaitHistogram buckets, by the upper bound of their wait time in microseconds.
+const char* const kWaitBucketNames[LockWaitHistogram::kBuckets] = {"lt4",
+                                                                    "lt16",
+                                                                    "lt64",
+                                                                    "lt256",
+                                                                    "lt1024",
+                                                                    "lt4096",
+                                                                    "lt16384",
+                                                                    "lt65536",
+                                                                    "lt262144",
+                                                                    "lt1048576",
+                                                                    "lt4194304",
+                                                                    "ge4194304"};
+
+}  // namespace
+
+void LockWaitHistogram::record(ResourceId resId, int64_t waitMicros) {
+    int bucket = 0;
+    while (bucket + 1 < kBuckets && waitMicros >= (int64_t{4} << (2 * bucket))) {
+        bucket++;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _entries.find(resId);
+    if (it == _entries.end()) {
+        if (_entries.size() >= kMaxResources) {
+            auto coldest = std::min_element(
+                _entries.begin(), _entries.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.second.totalWaitMicros < rhs.second.totalWaitMicros;
+                });
+            _entries.erase(coldest);
+        }
+
+        it = _entries.emplace(resId, Entry()).first;
+        if (resId == resourceIdOplog) {
+            it->second.name = NamespaceString::kRsOplogNamespace.ns();
+        }
+    }
+
+    auto& entry = it->second;
+    entry.totalWaitMicros += waitMicros;
+    entry.counts[bucket]++;
+
+    if (entry.name.empty()) {
+        _unnamed[resId % kUnnamedSlots].store(resId);
+    }
+}
+
+void LockWaitHistogram::_setName(ResourceId resId, StringData name) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _entries.find(resId);
+    if (it != _entries.end() && it->second.name.empty()) {
+        it->second.name = name.toString();
+    }
+
+    _unnamed[resId % kUnnamedSlots].compareAndSwap(resId, 0);
+}
+
+int64_t LockWaitHistogram::get(ResourceId resId, int bucket) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _entries.find(resId);
+    return (it == _entries.end()) ? 0 : it->second.counts[bucket];
+}
+
+void LockWaitHistogram::report(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // The entries are ordered by resource id, which orders them by type first, so each type gets
+    // one section
+    std::unique_ptr<BSONObjBuilder> section;
+    ResourceType sectionType = RESOURCE_INVALID;
+    for (const auto& entry : _entries) {
+        const ResourceType type = entry.first.getType();
+        if (!section || type != sectionType) {
+            // The previous section must be done before the next one starts
+            section.reset();
+            section.reset(new BSONObjBuilder(builder->subobjStart(resourceTypeName(type))));
+            sectionType = type;
+        }
+
+        const std::string name =
+            entry.second.name.empty() ? entry.first.toString() : entry.second.name;
+        const long long totalWaitMicros = entry.second.totalWaitMicros;
+
+        BSONObjBuilder resourceBuilder(section->subobjStart(name));
+        resourceBuilder.append("totalWaitMicros", totalWaitMicros);
+        for (int bucket = 0; bucket < kBuckets; bucket++) {
+            const long long value = entry.second.counts[bucket];
+            if (value > 0) {
+                resourceBuilder.append(kWaitBucketNames[bucket], value);
+            }
+        }
+    }
+}
+
+void LockWaitHistogram::reset() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    _entries.clear();
+    for (auto& slot : _unnamed) {
+        slot.store(0);
+    }
+}
+
 
 // Ensures that there are instances compiled for LockStats for AtomicInt64 and int64_t
 template class LockStats<int64_t>;
@@ -28,12 +28,18 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
+#include "mongo/base/string_data.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
 class BSONObjBuilder;
+class CompactLockStats;
 
 
 /**
@@ -166,6 +172,7 @@ private:
     // template parameter.
     template <typename T>
     friend class LockStats;
+    friend class CompactLockStats;
 
 
     // Keep the per-mode lock stats next to each other in case we want to do fancy operations
@@ -190,11 +197,143 @@ typedef LockStats<int64_t> SingleThreadedLockStats;
 typedef LockStats<AtomicInt64> AtomicLockStats;
 
 
+/**
+ * Per-locker statistics. An operation usually touches only a few of the resource type and mode
+ * combinations, so instead of zeroing the whole table on every reset, this keeps a mask of the
+ * counters which were used and only initializes a counter the first time it is touched. The full
+ * table is materialized only when somebody asks for it through appendTo.
+ */
+class CompactLockStats {
+public:
+    void recordAcquisition(ResourceId resId, LockMode mode) {
+        _get(resId, mode).numAcquisitions++;
+    }
+
+    void recordWait(ResourceId resId, LockMode mode) {
+        _get(resId, mode).numWaits++;
+    }
+
+    void recordWaitTime(ResourceId resId, LockMode mode, int64_t waitMicros) {
+        _get(resId, mode).combinedWaitTimeMicros += waitMicros;
+    }
+
+    void recordDeadlock(ResourceId resId, LockMode mode) {
+        _get(resId, mode).numDeadlocks++;
+    }
+
+    /**
+     * Adds the counters recorded so far to 'outStats'.
+     */
+    void appendTo(SingleThreadedLockStats* outStats) const;
+
+    bool empty() const {
+        return _used == 0;
+    }
+
+    void reset() {
+        _used = 0;
+    }
+
+private:
+    // One slot per mode for each resource type, plus the oplog which is reported separately.
+    static constexpr int kNumSlots = (ResourceTypesCount + 1) * LockModesCount;
+    static_assert(kNumSlots <= 64, "the used slots must fit in a 64-bit mask");
+
+    static int _slot(ResourceId resId, LockMode mode) {
+        const int type = (resId == resourceIdOplog) ? ResourceTypesCount : resId.getType();
+        return type * LockModesCount + mode;
+    }
+
+    LockStatCounters<int64_t>& _get(ResourceId resId, LockMode mode) {
+        const int slot = _slot(resId, mode);
+        const uint64_t bit = uint64_t(1) << slot;
+        if (!(_used & bit)) {
+            _counters[slot].reset();
+            _used |= bit;
+        }
+
+        return _counters[slot];
+    }
+
+    uint64_t _used = 0;
+
+    // Only the entries whose bit is set in _used hold meaningful values.
+    LockStatCounters<int64_t> _counters[kNumSlots];
+};
+
+
+/**
+ * Distribution of how long lock acquisitions, which had to wait, were blocked for, kept separately
+ * for each resource, so that long waits can be traced to the database or collection involved.
+ * Bucket i counts waits shorter than 4^(i+1) microseconds, except for the last one, which counts
+ * all the longer waits.
+ *
+ * Only sampled waits are recorded, so the histograms are kept under a mutex. At most kMaxResources
+ * resources are tracked, and the one with the least total wait time makes room for a new one.
+ */
+class LockWaitHistogram {
+public:
+    static constexpr int kBuckets = 12;
+    static constexpr std::size_t kMaxResources = 1000;
+
+    void record(ResourceId resId, int64_t waitMicros);
+
+    /**
+     * Remembers 'name' as the name of 'resId' if a wait on it was recorded without one. Called
+     * after every database and collection lock acquisition, so unless a name is missing, this only
+     * costs an atomic read of a slot which is rarely written.
+     */
+    void noteResourceName(ResourceId resId, StringData name) {
+        if (_unnamed[resId % kUnnamedSlots].load() == resId) {
+            _setName(resId, name);
+        }
+    }
+
+    int64_t get(ResourceId resId, int bucket) const;
+
+    /**
+     * Appends the histograms grouped by resource type and named after their resource, or after the
+     * resource id if its name is not known.
+     */
+    void report(BSONObjBuilder* builder) const;
+    void reset();
+
+private:
+    struct Entry {
+        std::string name;
+        int64_t totalWaitMicros{0};
+        int64_t counts[kBuckets] = {};
+    };
+
+    static constexpr std::size_t kUnnamedSlots = 64;
+
+    void _setName(ResourceId resId, StringData name);
+
+    mutable stdx::mutex _mutex;
+    std::map<ResourceId, Entry> _entries;
+
+    // Ids of resources which were waited for but have no name yet, by the id modulo the number of
+    // slots. A collision only delays naming a resource until its next recorded wait.
+    AtomicUInt64 _unnamed[kUnnamedSlots];
+};
+
+
 /**
  * Reports instance-wide locking statistics, which can then be converted to BSON or logged.
  */
 void reportGlobalLockingStats(SingleThreadedLockStats* outStats);
 
+/**
+ * Appends the instance-wide histograms of sampled lock wait times to 'builder'.
+ */
+void reportGlobalLockWaitHistogram(BSONObjBuilder* builder);
+
+/**
+ * Passes the name of a database or collection, which was just locked, on to the instance-wide
+ * lock wait histograms. See LockWaitHistogram::noteResourceName.
+ */
+void noteGlobalLockWaitResourceName(ResourceId resId, StringData name);
+
 /**
  * Currently used for testing only.
  */
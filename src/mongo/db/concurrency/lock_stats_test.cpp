@@ -101,4 +101,99 @@ TEST(LockStats, Reporting) {
     stats.report(&builder);
 }
 
+TEST(LockStats, CompactStatsOnlyReportTouchedCounters) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Compact"));
+
+    CompactLockStats compactStats;
+    ASSERT(compactStats.empty());
+
+    compactStats.recordAcquisition(resId, MODE_IX);
+    compactStats.recordAcquisition(resId, MODE_IX);
+    compactStats.recordWait(resourceIdOplog, MODE_X);
+    compactStats.recordWaitTime(resourceIdOplog, MODE_X, 10);
+    ASSERT_FALSE(compactStats.empty());
+
+    SingleThreadedLockStats stats;
+    compactStats.appendTo(&stats);
+
+    ASSERT_EQUALS(2, stats.get(resId, MODE_IX).numAcquisitions);
+    ASSERT_EQUALS(0, stats.get(resId, MODE_IX).numWaits);
+    ASSERT_EQUALS(0, stats.get(resId, MODE_X).numAcquisitions);
+    ASSERT_EQUALS(1, stats.get(resourceIdOplog, MODE_X).numWaits);
+    ASSERT_EQUALS(10, stats.get(resourceIdOplog, MODE_X).combinedWaitTimeMicros);
+
+    // After a reset the counters start over from zero rather than from their old values.
+    compactStats.reset();
+    ASSERT(compactStats.empty());
+    compactStats.recordAcquisition(resId, MODE_IX);
+
+    SingleThreadedLockStats statsAfterReset;
+    compactStats.appendTo(&statsAfterReset);
+
+    ASSERT_EQUALS(1, statsAfterReset.get(resId, MODE_IX).numAcquisitions);
+    ASSERT_EQUALS(0, statsAfterReset.get(resourceIdOplog, MODE_X).numWaits);
+}
+
+TEST(LockStats, WaitHistogram) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.WaitHistogram"));
+
+    LockWaitHistogram histogram;
+    histogram.reset();
+
+    histogram.record(resId, 0);
+    histogram.record(resId, 3);
+    histogram.record(resId, 4);
+    histogram.record(resId, 5000);
+    histogram.record(resId, 10 * 1000 * 1000);
+    histogram.record(resourceIdOplog, 20);
+
+    ASSERT_EQUALS(2, histogram.get(resId, 0));
+    ASSERT_EQUALS(1, histogram.get(resId, 1));
+    ASSERT_EQUALS(1, histogram.get(resId, 6));
+    ASSERT_EQUALS(1, histogram.get(resId, LockWaitHistogram::kBuckets - 1));
+    ASSERT_EQUALS(1, histogram.get(resourceIdOplog, 2));
+    ASSERT_EQUALS(0, histogram.get(resId, 2));
+
+    // Until the resource gets locked by name, it is reported by its id
+    BSONObjBuilder unnamedBuilder;
+    histogram.report(&unnamedBuilder);
+    const BSONObj unnamedReport = unnamedBuilder.obj();
+    ASSERT_EQUALS(2, unnamedReport["Collection"][resId.toString()]["lt4"].numberLong());
+
+    histogram.noteResourceName(resId, "LockStats.WaitHistogram");
+
+    BSONObjBuilder builder;
+    histogram.report(&builder);
+    const BSONObj report = builder.obj();
+
+    const BSONObj collReport = report["Collection"]["LockStats.WaitHistogram"].Obj();
+    ASSERT_EQUALS(2, collReport["lt4"].numberLong());
+    ASSERT_EQUALS(1, collReport["ge4194304"].numberLong());
+    ASSERT_EQUALS(10 * 1000 * 1000 + 5007, collReport["totalWaitMicros"].numberLong());
+    ASSERT_EQUALS(1, report["Collection"]["local.oplog.rs"]["lt64"].numberLong());
+    ASSERT(report["Collection"][resId.toString()].eoo());
+    ASSERT(report["Database"].eoo());
+}
+
+TEST(LockStats, WaitHistogramEvictsColdestResource) {
+    LockWaitHistogram histogram;
+
+    const auto collResId = [](std::size_t i) {
+        return ResourceId(RESOURCE_COLLECTION, "LockStats.coll" + std::to_string(i));
+    };
+
+    const ResourceId hotResId(RESOURCE_DATABASE, std::string("hot"));
+    histogram.record(hotResId, 1000 * 1000);
+
+    for (std::size_t i = 0; i < LockWaitHistogram::kMaxResources; i++) {
+        histogram.record(collResId(i), 10 + i);
+    }
+
+    // The resource with the least total wait time made room for the last one
+    ASSERT_EQUALS(1, histogram.get(hotResId, 9));
+    ASSERT_EQUALS(0, histogram.get(collResId(0), 1));
+    ASSERT_EQUALS(1, histogram.get(collResId(1), 1));
+    ASSERT_EQUALS(1, histogram.get(collResId(LockWaitHistogram::kMaxResources - 1), 4));
+}
+
 }  // namespace mongo
@@ -73,6 +73,21 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Gives operations that must not be starved by user traffic, i.e. internal operations such as
+     * replication and operations from other members of the cluster, lanes of their own:
+     * 'reading' and 'writing' hold tickets that only such operations may take when the tickets
+     * installed by setGlobalThrottling have run out.
+     */
+    static void setGlobalPriorityThrottling(class TicketHolder* reading,
+                                            class TicketHolder* writing);
+
+    /**
+     * Returns the TicketHolder installed by setGlobalThrottling that global lock attempts in 'mode'
+     * obtain tickets from, or nullptr if acquisitions in that mode are not throttled.
+     */
+    static TicketHolder* getGlobalThrottling(LockMode mode);
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -28,57 +28,57 @@
 
 #include "mongo/platform/basic.h"
 
-#include "mongo/base/counter.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/sharded_counter.h"
 
 namespace mongo {
 namespace {
-Counter64 returnedCounter;
-Counter64 insertedCounter;
-Counter64 updatedCounter;
-Counter64 deletedCounter;
-Counter64 scannedCounter;
-Counter64 scannedObjectCounter;
+ShardedCounter64 returnedCounter;
+ShardedCounter64 insertedCounter;
+ShardedCounter64 updatedCounter;
+ShardedCounter64 deletedCounter;
+ShardedCounter64 scannedCounter;
+ShardedCounter64 scannedObjectCounter;
 
-ServerStatusMetricField<Counter64> displayReturned("document.returned", &returnedCounter);
-ServerStatusMetricField<Counter64> displayUpdated("document.updated", &updatedCounter);
-ServerStatusMetricField<Counter64> displayInserted("document.inserted", &insertedCounter);
-ServerStatusMetricField<Counter64> displayDeleted("document.deleted", &deletedCounter);
-ServerStatusMetricField<Counter64> displayScanned("queryExecutor.scanned", &scannedCounter);
-ServerStatusMetricField<Counter64> displayScannedObjects("queryExecutor.scannedObjects",
-                                                         &scannedObjectCounter);
+ServerStatusMetricField<ShardedCounter64> displayReturned("document.returned", &returnedCounter);
+ServerStatusMetricField<ShardedCounter64> displayUpdated("document.updated", &updatedCounter);
+ServerStatusMetricField<ShardedCounter64> displayInserted("document.inserted", &insertedCounter);
+ServerStatusMetricField<ShardedCounter64> displayDeleted("document.deleted", &deletedCounter);
+ServerStatusMetricField<ShardedCounter64> displayScanned("queryExecutor.scanned", &scannedCounter);
+ServerStatusMetricField<ShardedCounter64> displayScannedObjects("queryExecutor.scannedObjects",
+                                                                &scannedObjectCounter);
 
-Counter64 scanAndOrderCounter;
-Counter64 writeConflictsCounter;
+ShardedCounter64 scanAndOrderCounter;
+ShardedCounter64 writeConflictsCounter;
 
-ServerStatusMetricField<Counter64> displayScanAndOrder("operation.scanAndOrder",
-                                                       &scanAndOrderCounter);
-ServerStatusMetricField<Counter64> displayWriteConflicts("operation.writeConflicts",
-                                                         &writeConflictsCounter);
+ServerStatusMetricField<ShardedCounter64> displayScanAndOrder("operation.scanAndOrder",
+                                                              &scanAndOrderCounter);
+ServerStatusMetricField<ShardedCounter64> displayWriteConflicts("operation.writeConflicts",
+                                                                &writeConflictsCounter);
 
 }  // namespace
 
 void recordCurOpMetrics(OperationContext* opCtx) {
     const OpDebug& debug = CurOp::get(opCtx)->debug();
     if (debug.nreturned > 0)
-        returnedCounter.increment(debug.nreturned);
+        returnedCounter.add(debug.nreturned);
     if (debug.ninserted > 0)
-        insertedCounter.increment(debug.ninserted);
+        insertedCounter.add(debug.ninserted);
     if (debug.nMatched > 0)
-        updatedCounter.increment(debug.nMatched);
+        updatedCounter.add(debug.nMatched);
     if (debug.ndeleted > 0)
-        deletedCounter.increment(debug.ndeleted);
+        deletedCounter.add(debug.ndeleted);
     if (debug.keysExamined > 0)
-        scannedCounter.increment(debug.keysExamined);
+        scannedCounter.add(debug.keysExamined);
     if (debug.docsExamined > 0)
-        scannedObjectCounter.increment(debug.docsExamined);
+        scannedObjectCounter.add(debug.docsExamined);
 
     if (debug.hasSortStage)
-        scanAndOrderCounter.increment();
+        scanAndOrderCounter.add();
     if (debug.writeConflicts)
-        writeConflictsCounter.increment(debug.writeConflicts);
+        writeConflictsCounter.add(debug.writeConflicts);
 }
 
 }  // namespace mongo
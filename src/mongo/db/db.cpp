@@ -95,6 +95,7 @@
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
+#include "mongo/db/periodic_runner_job_detect_lock_cycles.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -592,6 +593,10 @@ ExitCode _initAndListen(int listenPort) {
         startPeriodicThreadToAbortExpiredTransactions(serviceContext);
     }
 
+    // Start up a background task to look for lock wait cycles, if lockCycleDetectionIntervalSeconds
+    // is set.
+    startPeriodicThreadToDetectLockCycles(serviceContext);
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -33,12 +33,14 @@
 #include "mongo/db/db_raii.h"
 
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/storage/snapshot_manager.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -46,6 +48,15 @@ namespace {
 
 const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 
+// Secondary reads served at the last applied timestamp without the PBWM lock, and those that had to
+// retry under the PBWM lock because of catalog changes newer than the last applied timestamp.
+Counter64 secondaryReadsAtLastApplied;
+Counter64 secondaryReadsRetriedWithPBWM;
+ServerStatusMetricField<Counter64> displaySecondaryReadsAtLastApplied(
+    "repl.secondaryReads.atLastApplied", &secondaryReadsAtLastApplied);
+ServerStatusMetricField<Counter64> displaySecondaryReadsRetriedWithPBWM(
+    "repl.secondaryReads.retriedWithPBWM", &secondaryReadsRetriedWithPBWM);
+
 }  // namespace
 
 // If true, do not take the PBWM lock in AutoGetCollectionForRead on secondaries during batch
@@ -129,12 +140,15 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
         // because it is set asynchonously. This is not problematic because holding the collection
         // lock guarantees no metadata changes will occur in that time.
         auto lastAppliedTimestamp = readAtLastAppliedTimestamp
-            ? boost::optional<Timestamp>(replCoord->getMyLastAppliedOpTime().getTimestamp())
+            ? boost::optional<Timestamp>(_getLastAppliedTimestamp(opCtx))
             : boost::none;
 
         // Return if there are no conflicting catalog changes on the collection.
         auto minSnapshot = coll->getMinimumVisibleSnapshot();
         if (!_conflictingCatalogChanges(opCtx, minSnapshot, lastAppliedTimestamp)) {
+            if (readAtLastAppliedTimestamp) {
+                secondaryReadsAtLastApplied.increment();
+            }
             return;
         }
 
@@ -158,6 +172,7 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
                    << " on nss: " << nss.ns() << ", but future catalog changes are pending at time "
                    << *minSnapshot << ". Trying again without reading at last-applied time.";
             _shouldNotConflictWithSecondaryBatchApplicationBlock = boost::none;
+            secondaryReadsRetriedWithPBWM.increment();
         }
 
         if (readConcernLevel == repl::ReadConcernLevel::kMajorityReadConcern) {
@@ -214,6 +229,20 @@ bool AutoGetCollectionForRead::_shouldReadAtLastAppliedTimestamp(
     return true;
 }
 
+Timestamp AutoGetCollectionForRead::_getLastAppliedTimestamp(OperationContext* opCtx) const {
+    // Prefer the local snapshot of the storage engine, which is the timestamp the recovery unit
+    // opens its transaction at. It only moves at batch boundaries, so it never names a point in the
+    // middle of a batch. Before the first batch has set it, fall back to the replication
+    // coordinator's view.
+    auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine();
+    if (auto snapshotManager = storageEngine->getSnapshotManager()) {
+        if (auto localSnapshot = snapshotManager->getLocalSnapshot()) {
+            return *localSnapshot;
+        }
+    }
+    return repl::ReplicationCoordinator::get(opCtx)->getMyLastAppliedOpTime().getTimestamp();
+}
+
 bool AutoGetCollectionForRead::_conflictingCatalogChanges(
     OperationContext* opCtx,
     boost::optional<Timestamp> minSnapshot,
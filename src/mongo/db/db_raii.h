@@ -122,6 +122,10 @@ private:
                                            const NamespaceString& nss,
                                            repl::ReadConcernLevel readConcernLevel) const;
 
+    // Returns the timestamp that reads at the last applied timestamp will see: the boundary of the
+    // most recently completed replication batch.
+    Timestamp _getLastAppliedTimestamp(OperationContext* opCtx) const;
+
     // Returns true if the minSnapshot causes conflicting catalog changes for either the provided
     // lastAppliedTimestamp or the point-in-time snapshot of the RecoveryUnit on 'opCtx'.
     bool _conflictingCatalogChanges(OperationContext* opCtx,
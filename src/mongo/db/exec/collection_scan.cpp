@@ -68,6 +68,10 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
+    // Tailable scans spend most of their time at the end of the collection, where there is
+    // nothing to read ahead.
+    _specificStats.readAhead = params.readAhead && !params.tailable &&
+        params.direction == CollectionScanParams::FORWARD;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
 
     if (params.maxTs) {
@@ -122,6 +126,9 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
 
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            if (_specificStats.readAhead) {
+                _cursor->enableReadAhead();
+            }
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
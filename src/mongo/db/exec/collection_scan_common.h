@@ -72,6 +72,10 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether to ask the storage engine to read ahead of a forward scan's position in the
+    // background. Only a hint: storage engines that cannot do so ignore it.
+    bool readAhead = false;
 };
 
 }  // namespace mongo
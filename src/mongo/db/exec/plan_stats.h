@@ -211,6 +211,9 @@ struct CollectionScanStats : public SpecificStats {
     // sees a document that does not pass the filter and has a "ts" Timestamp field greater than
     // 'maxTs'.
     boost::optional<Timestamp> maxTs;
+
+    // Whether the scan asked the storage engine to read ahead of it.
+    bool readAhead = false;
 };
 
 struct CountStats : public SpecificStats {
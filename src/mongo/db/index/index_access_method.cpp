@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -50,7 +51,9 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
@@ -77,6 +80,20 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
                        [](const std::set<std::size_t>& components) { return !components.empty(); });
 }
 
+/**
+ * Returns 'keys' in the order of the index with key pattern 'keyPattern', which is the order the
+ * SortedDataInterface batch methods are fastest with.
+ */
+template <typename Keys>
+std::vector<BSONObj> inIndexOrder(const Keys& keys, const BSONObj& keyPattern) {
+    std::vector<BSONObj> sorted(keys.begin(), keys.end());
+    const Ordering ordering = Ordering::make(keyPattern);
+    std::sort(sorted.begin(), sorted.end(), [&](const BSONObj& l, const BSONObj& r) {
+        return l.woCompare(r, ordering, /*considerfieldname*/ false) < 0;
+    });
+    return sorted;
+}
+
 }  // namespace
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
@@ -138,47 +155,144 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     // Delegate to the subclass.
     getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
 
-    Status ret = Status::OK();
-    for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
-        Status status = _newInterface->insert(opCtx, *i, loc, options.dupsAllowed);
+    // Insert all of the keys in one batch, so that a document with many keys does not search the
+    // index from scratch for every one of them.
+    const std::vector<BSONObj> sortedKeys = inIndexOrder(keys, _descriptor->keyPattern());
+    const BSONObj* failedKey = nullptr;
+    Status status = _newInterface->insertKeys(
+        opCtx,
+        sortedKeys,
+        loc,
+        options.dupsAllowed,
+        [&](const BSONObj& key, const Status& error) {
+            if (error.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+                return Status::OK();
+            }
 
-        // Everything's OK, carry on.
-        if (status.isOK()) {
-            ++*numInserted;
-            IndexKeyEntry indexEntry = IndexKeyEntry(*i, loc);
-            continue;
+            if (error.code() == ErrorCodes::DuplicateKeyValue) {
+                // A document might be indexed multiple times during a background index build
+                // if it moves ahead of the collection scan cursor (e.g. via an update).
+                if (!_btreeState->isReady(opCtx)) {
+                    LOG(3) << "key " << key << " already in index during background indexing (ok)";
+                    return Status::OK();
+                }
+            }
+
+            failedKey = &key;
+            return error;
+        },
+        numInserted);
+
+    if (!status.isOK()) {
+        // Clean up after ourselves. The keys ahead of the one that failed have been inserted.
+        for (const auto& key : sortedKeys) {
+            if (&key == failedKey)
+                break;
+            removeOneKey(opCtx, key, loc, options.dupsAllowed);
         }
+        *numInserted = 0;
 
-        // Error cases.
+        return status;
+    }
 
-        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
-            IndexKeyEntry indexEntry = IndexKeyEntry(*i, loc);
-            continue;
+    if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+
+    return Status::OK();
+}
+
+Status IndexAccessMethod::insertMany(OperationContext* opCtx,
+                                     const std::vector<BsonRecord>& records,
+                                     const InsertDeleteOptions& options,
+                                     int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    std::vector<IndexKeyEntry> entries;
+    std::vector<size_t> numKeys(records.size());
+    std::vector<MultikeyPaths> multikeyPaths(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        invariant(records[i].id != RecordId());
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        // Delegate to the subclass.
+        getKeys(*records[i].docPtr, options.getKeysMode, &keys, &multikeyPaths[i]);
+        numKeys[i] = keys.size();
+        for (const auto& key : keys) {
+            entries.emplace_back(key, records[i].id);
         }
+    }
 
-        if (status.code() == ErrorCodes::DuplicateKeyValue) {
-            // A document might be indexed multiple times during a background index build
-            // if it moves ahead of the collection scan cursor (e.g. via an update).
-            if (!_btreeState->isReady(opCtx)) {
-                LOG(3) << "key " << *i << " already in index during background indexing (ok)";
-                continue;
+    // Keys shared by several documents end up next to each other, in RecordId order.
+    std::sort(entries.begin(),
+              entries.end(),
+              IndexEntryComparison(Ordering::make(_descriptor->keyPattern())));
+
+    const IndexKeyEntry* failedEntry = nullptr;
+    stdx::unordered_map<RecordId, int64_t, RecordId::Hasher> numSkipped;
+    Status status = _newInterface->insertEntries(
+        opCtx,
+        entries,
+        options.dupsAllowed,
+        [&](const IndexKeyEntry& entry, const Status& error) {
+            if (error.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+                ++numSkipped[entry.loc];
+                return Status::OK();
+            }
+
+            if (error.code() == ErrorCodes::DuplicateKeyValue) {
+                // A document might be indexed multiple times during a background index build
+                // if it moves ahead of the collection scan cursor (e.g. via an update).
+                if (!_btreeState->isReady(opCtx)) {
+                    LOG(3) << "key " << entry.key
+                           << " already in index during background indexing (ok)";
+                    ++numSkipped[entry.loc];
+                    return Status::OK();
+                }
             }
-        }
 
-        // Clean up after ourselves.
-        for (BSONObjSet::const_iterator j = keys.begin(); j != i; ++j) {
-            removeOneKey(opCtx, *j, loc, options.dupsAllowed);
-            *numInserted = 0;
+            failedEntry = &entry;
+            return error;
+        },
+        numInserted);
+
+    if (!status.isOK()) {
+        // Clean up after ourselves. The entries ahead of the one that failed have been inserted.
+        for (const auto& entry : entries) {
+            if (&entry == failedEntry)
+                break;
+            removeOneKey(opCtx, entry.key, entry.loc, options.dupsAllowed);
         }
+        *numInserted = 0;
 
         return status;
     }
 
-    if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
-        _btreeState->setMultikey(opCtx, multikeyPaths);
+    for (size_t i = 0; i < records.size(); ++i) {
+        auto skipped = numSkipped.find(records[i].id);
+        const int64_t inserted =
+            numKeys[i] - (skipped == numSkipped.end() ? 0 : skipped->second);
+        if (inserted > 1 || isMultikeyFromPaths(multikeyPaths[i])) {
+            _btreeState->setMultikey(opCtx, multikeyPaths[i]);
+        }
     }
 
-    return ret;
+    return Status::OK();
+}
+
+void IndexAccessMethod::removeKeys(OperationContext* opCtx,
+                                   const std::vector<BSONObj>& keys,
+                                   const RecordId& loc,
+                                   bool dupsAllowed) {
+    try {
+        _newInterface->unindexKeys(opCtx, keys, loc, dupsAllowed);
+    } catch (const AssertionException&) {
+        // Go through the keys one at a time so that a failure to remove one of them does not
+        // keep the others in the index. Removing the keys that are already gone does nothing.
+        for (const auto& key : keys) {
+            removeOneKey(opCtx, key, loc, dupsAllowed);
+        }
+    }
 }
 
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
@@ -225,10 +339,8 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     // those that don't apply to the partialIndex filter.
     getKeys(obj, GetKeysMode::kRelaxConstraintsUnfiltered, &keys, multikeyPaths);
 
-    for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
-        removeOneKey(opCtx, *i, loc, options.dupsAllowed);
-        ++*numDeleted;
-    }
+    removeKeys(opCtx, inIndexOrder(keys, _descriptor->keyPattern()), loc, options.dupsAllowed);
+    *numDeleted = keys.size();
 
     return Status::OK();
 }
@@ -388,25 +500,26 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
     }
 
-    for (size_t i = 0; i < ticket.removed.size(); ++i) {
-        _newInterface->unindex(opCtx, ticket.removed[i], ticket.loc, ticket.dupsAllowed);
-        IndexKeyEntry indexEntry = IndexKeyEntry(ticket.removed[i], ticket.loc);
-    }
-
-    for (size_t i = 0; i < ticket.added.size(); ++i) {
-        Status status =
-            _newInterface->insert(opCtx, ticket.added[i], ticket.loc, ticket.dupsAllowed);
-        if (!status.isOK()) {
-            if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+    const BSONObj& keyPattern = _descriptor->keyPattern();
+    _newInterface->unindexKeys(
+        opCtx, inIndexOrder(ticket.removed, keyPattern), ticket.loc, ticket.dupsAllowed);
+
+    int64_t numAdded = 0;
+    Status status = _newInterface->insertKeys(
+        opCtx,
+        inIndexOrder(ticket.added, keyPattern),
+        ticket.loc,
+        ticket.dupsAllowed,
+        [&](const BSONObj& key, const Status& error) {
+            if (error.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
                 // Ignore.
-                IndexKeyEntry indexEntry = IndexKeyEntry(ticket.added[i], ticket.loc);
-                continue;
+                return Status::OK();
             }
-
-            return status;
-        }
-
-        IndexKeyEntry indexEntry = IndexKeyEntry(ticket.added[i], ticket.loc);
+            return error;
+        },
+        &numAdded);
+    if (!status.isOK()) {
+        return status;
     }
 
     *numInserted = ticket.added.size();
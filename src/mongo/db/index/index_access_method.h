@@ -47,6 +47,7 @@ extern AtomicBool failIndexKeyTooLong;
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 /**
@@ -84,6 +85,18 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Analogous to insert(), but for several documents at once. The keys of all of the documents
+     * are sorted together and inserted in one pass over the index, which is much cheaper than
+     * inserting each document's keys separately when many small documents are inserted at once.
+     * 'numInserted' will be set to the number of keys added to the index for all the documents.
+     * Either all of the keys will be inserted or none will.
+     */
+    Status insertMany(OperationContext* opCtx,
+                      const std::vector<BsonRecord>& records,
+                      const InsertDeleteOptions& options,
+                      int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -329,6 +342,15 @@ protected:
     const IndexDescriptor* _descriptor;
 
 private:
+    /**
+     * Removes 'keys', which must be in index order, in one batch, falling back to removing them
+     * one by one if the batch fails.
+     */
+    void removeKeys(OperationContext* opCtx,
+                    const std::vector<BSONObj>& keys,
+                    const RecordId& loc,
+                    bool dupsAllowed);
+
     void removeOneKey(OperationContext* opCtx,
                       const BSONObj& key,
                       const RecordId& loc,
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_detect_lock_cycles.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+namespace {
+
+// How often, in seconds, to look for cycles among all waiting lock requests. 0 turns it off.
+MONGO_EXPORT_SERVER_PARAMETER(lockCycleDetectionIntervalSeconds, int, 0);
+
+Counter64 lockCyclesFound;
+ServerStatusMetricField<Counter64> displayLockCyclesFound("lockCycleDetection.cyclesFound",
+                                                          &lockCyclesFound);
+
+void detectLockCycles() {
+    const LockManager& lockManager = *getGlobalLockManager();
+    const auto waiters = lockManager.getWaitForGraph();
+
+    for (const auto& cycle : LockManager::findWaitCycles(waiters)) {
+        // The wait-for graph was collected one bucket at a time, so confirm the cycle with the
+        // same check that lock requests use for themselves.
+        const auto& waiter = waiters[cycle.front()];
+        DeadlockDetector wfg(lockManager, waiter.lockerId, waiter.resourceId);
+        if (!wfg.check().hasCycle()) {
+            continue;
+        }
+
+        lockCyclesFound.increment();
+        warning() << "Lock wait cycle found: " << wfg.toString();
+    }
+}
+
+}  // namespace
+
+void startPeriodicThreadToDetectLockCycles(ServiceContext* serviceContext) {
+    // Enforce calling this function once, and only once.
+    static bool firstCall = true;
+    invariant(firstCall);
+    firstCall = false;
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    // PeriodicRunner does not support altering the period of a job, so like the job which aborts
+    // expired transactions, run every second and count up to the configured interval.
+    PeriodicRunner::PeriodicJob job(
+        [](Client* client) {
+            static int seconds = 0;
+            const int interval = lockCycleDetectionIntervalSeconds.load();
+            if (interval <= 0 || ++seconds < interval) {
+                return;
+            }
+
+            seconds = 0;
+            detectLockCycles();
+        },
+        Seconds(1));
+
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+}  // namespace mongo
@@ -126,6 +126,48 @@ private:
 };
 
 
+/**
+ * Estimates the number of distinct values using a HyperLogLog sketch. Unlike $addToSet, the state
+ * is a fixed array of registers regardless of input cardinality, and two sketches are merged by
+ * taking the per-register maximum, so partial results from spills and shards combine exactly.
+ */
+class AccumulatorApproxCountDistinct final : public Accumulator {
+public:
+    // The number of hash bits used to select a register. The relative standard error of the
+    // estimate is approximately 1.04 / sqrt(kNumRegisters), or 0.81% with 2^14 registers.
+    static constexpr int kPrecision = 14;
+    static constexpr size_t kNumRegisters = size_t(1) << kPrecision;
+
+    explicit AccumulatorApproxCountDistinct(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    /**
+     * Returns the cardinality estimate for the current register state, applying the linear
+     * counting correction for small cardinalities.
+     */
+    double _estimate() const;
+
+    std::vector<uint8_t> _registers;
+};
+
+
 class AccumulatorFirst final : public Accumulator {
 public:
     explicit AccumulatorFirst(const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -307,6 +349,78 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 };
 
+/**
+ * Estimates one or more percentiles of the numeric input using a merging t-digest (Dunning and
+ * Ertl, "Computing Extremely Accurate Quantiles Using t-Digests"). Inputs are summarized by a
+ * bounded number of weighted centroids which are small near the tails of the distribution, so the
+ * memory use is independent of the number of inputs while extreme percentiles stay accurate. The
+ * partial state is the list of centroids, which can be merged from spills and shards.
+ *
+ * The operand is an object of the form {input: <expression>, p: <number or array of numbers>}.
+ */
+class AccumulatorApproxPercentile final : public Accumulator {
+public:
+    // Controls the trade-off between accuracy and size. The digest holds at most about
+    // kCompression centroids once compressed.
+    static constexpr double kCompression = 100;
+
+    // The number of unmerged inputs buffered before they are folded into the centroids.
+    static constexpr size_t kBufferSize = 500;
+
+    explicit AccumulatorApproxPercentile(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    /**
+     * Validates the requested percentiles and records them, or checks that they match the ones
+     * recorded by earlier inputs.
+     */
+    void _setPercentiles(const Value& percentiles);
+
+    void _addCentroid(double mean, double weight);
+
+    /**
+     * Folds the buffered inputs into the centroid list, merging neighbouring centroids while the
+     * size bound given by the scale function allows it.
+     */
+    void _compress();
+
+    /**
+     * Returns the estimated value at quantile 'q', where 0 <= q <= 1. The digest must be compressed
+     * and non-empty.
+     */
+    double _quantile(double q) const;
+
+    void _updateMemUsage();
+
+    Value _percentiles;
+    std::vector<Centroid> _centroids;
+    std::vector<Centroid> _buffer;
+    double _totalWeight;
+    double _min;
+    double _max;
+};
+
 class AccumulatorMergeObjects : public Accumulator {
 public:
     AccumulatorMergeObjects(const boost::intrusive_ptr<ExpressionContext>& expCtx);
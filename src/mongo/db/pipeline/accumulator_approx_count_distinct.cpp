@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects for
+ * all of the code used other than as permitted herein. If you modify file(s)
+ * with this exception, you may extend this exception to your version of the
+ * file(s), but you are not obligated to do so. If you do not wish to do so,
+ * delete this exception statement from your version. If you delete this
+ * exception statement from all source files in the program, then also delete
+ * it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxCountDistinct, AccumulatorApproxCountDistinct::create);
+
+namespace {
+// The width of the hash, in bits, from which the register index and rank are taken.
+const int kHashBits = 64;
+
+/**
+ * Spreads the bits of a Value hash over all 64 bits. Value hashes are built with hash_combine()
+ * and are not uniformly distributed enough to derive HyperLogLog ranks from directly.
+ */
+uint64_t mixHash(size_t valueHash) {
+    const uint64_t in = valueHash;
+    uint64_t out[2];
+    MurmurHash3_x64_128(&in, sizeof(in), 0, out);
+    return out[0];
+}
+}  // namespace
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        if (input.missing())
+            return;
+
+        // Hash through the ValueComparator so that values which compare equal under the collation
+        // are counted once.
+        const uint64_t hash = mixHash(getExpressionContext()->getValueComparator().hash(input));
+        const size_t index = hash >> (kHashBits - kPrecision);
+
+        // The rank is the position of the leftmost 1-bit among the remaining bits. An all-zero
+        // remainder takes the maximum rank.
+        const uint64_t remainder = hash << kPrecision;
+        const uint8_t rank = static_cast<uint8_t>(
+            std::min(countLeadingZeros64(remainder), kHashBits - kPrecision) + 1);
+
+        if (rank > _registers[index])
+            _registers[index] = rank;
+    } else {
+        // This is what getValue(true) produced below.
+        verify(input.getType() == BinData);
+        const BSONBinData sketch = input.getBinData();
+        uassert(50900,
+                str::stream() << getOpName() << " cannot merge a sketch with " << sketch.length
+                              << " registers, expected "
+                              << kNumRegisters,
+                sketch.length == static_cast<int>(kNumRegisters));
+
+        const uint8_t* otherRegisters = static_cast<const uint8_t*>(sketch.data);
+        for (size_t i = 0; i < kNumRegisters; i++) {
+            _registers[i] = std::max(_registers[i], otherRegisters[i]);
+        }
+    }
+}
+
+double AccumulatorApproxCountDistinct::_estimate() const {
+    // This is an implementation of the algorithm from "HyperLogLog: the analysis of a near-optimal
+    // cardinality estimation algorithm" (Flajolet et al., 2007). A 64-bit hash makes the large
+    // range correction unnecessary.
+    const double m = kNumRegisters;
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+
+    double harmonicSum = 0;
+    size_t numZeroRegisters = 0;
+    for (auto reg : _registers) {
+        harmonicSum += std::ldexp(1.0, -reg);
+        if (reg == 0)
+            numZeroRegisters++;
+    }
+
+    const double rawEstimate = alpha * m * m / harmonicSum;
+    if (rawEstimate <= 2.5 * m && numZeroRegisters > 0) {
+        // Linear counting is considerably more accurate while many registers are still empty.
+        return m * std::log(m / numZeroRegisters);
+    }
+    return rawEstimate;
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        return Value(BSONBinData(_registers.data(), _registers.size(), BinDataGeneral));
+    }
+    return Value(static_cast<long long>(std::llround(_estimate())));
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx), _registers(kNumRegisters, 0) {
+    // This is a fixed size Accumulator so we never need to update this
+    _memUsageBytes = sizeof(*this) + kNumRegisters;
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    std::fill(_registers.begin(), _registers.end(), 0);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxCountDistinct::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
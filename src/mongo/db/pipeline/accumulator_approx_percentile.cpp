@@ -0,0 +1,284 @@
+/**
+ * Copyright (C) 2018 MongoDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or  modify
+ * it under the terms of the GNU Affero General Public License, version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * As a special exception, the copyright holders give permission to link the
+ * code of portions of this program with the OpenSSL library under certain
+ * conditions as described in each individual source file and distribute
+ * linked combinations including the program with the OpenSSL library. You
+ * must comply with the GNU Affero General Public License in all respects for
+ * all of the code used other than as permitted herein. If you modify file(s)
+ * with this exception, you may extend this exception to your version of the
+ * file(s), but you are not obligated to do so. If you do not wish to do so,
+ * delete this exception statement from your version. If you delete this
+ * exception statement from all source files in the program, then also delete
+ * it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::vector;
+
+REGISTER_ACCUMULATOR(approxPercentile, AccumulatorApproxPercentile::create);
+
+namespace {
+const double kPi = 3.14159265358979323846;
+
+/**
+ * The k1 scale function from the t-digest paper, mapping a quantile to a scale where each
+ * centroid may span at most one unit.
+ */
+double scaleK(double q) {
+    return AccumulatorApproxPercentile::kCompression / (2 * kPi) * std::asin(2 * q - 1);
+}
+
+double inverseScaleK(double k) {
+    return (std::sin(k * 2 * kPi / AccumulatorApproxPercentile::kCompression) + 1) / 2;
+}
+
+/**
+ * Returns the largest quantile which a centroid starting at quantile 'q' may extend to. The k scale
+ * ends at kCompression / 4, past which the sine turns back down, so clamp there. Otherwise the
+ * centroids in the upper tail would stop merging and their number would grow with the input.
+ */
+double maxQuantileFrom(double q) {
+    return inverseScaleK(std::min(scaleK(q) + 1, AccumulatorApproxPercentile::kCompression / 4));
+}
+}  // namespace
+
+const char* AccumulatorApproxPercentile::getOpName() const {
+    return "$approxPercentile";
+}
+
+void AccumulatorApproxPercentile::_setPercentiles(const Value& percentiles) {
+    if (!_percentiles.missing()) {
+        uassert(50901,
+                str::stream() << getOpName() << " requires 'p' to be the same for every input",
+                ValueComparator().evaluate(_percentiles == percentiles));
+        return;
+    }
+
+    auto isValidPercentile = [](const Value& p) {
+        return p.numeric() && p.coerceToDouble() >= 0 && p.coerceToDouble() <= 1;
+    };
+    const bool isValid = percentiles.isArray()
+        ? !percentiles.getArray().empty() &&
+            std::all_of(percentiles.getArray().begin(),
+                        percentiles.getArray().end(),
+                        isValidPercentile)
+        : isValidPercentile(percentiles);
+    uassert(50902,
+            str::stream() << getOpName()
+                          << " requires 'p' to be a number or a non-empty array of numbers "
+                             "between 0 and 1, found: "
+                          << percentiles.toString(),
+            isValid);
+    _percentiles = percentiles;
+    _updateMemUsage();
+}
+
+void AccumulatorApproxPercentile::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        uassert(50903,
+                str::stream() << getOpName()
+                              << " requires an object of the form {input: <expression>, p: "
+                                 "<number or array of numbers>}, found: "
+                              << input.toString(),
+                input.getType() == Object && !input["p"].missing() &&
+                    input.getDocument().size() == (input["input"].missing() ? 1U : 2U));
+        _setPercentiles(input["p"]);
+
+        // Non-numeric types, including NaN which has no position in the distribution, have no
+        // impact on the percentiles.
+        const Value val = input["input"];
+        if (!val.numeric() || std::isnan(val.coerceToDouble()))
+            return;
+
+        const double d = val.coerceToDouble();
+        _min = std::min(_min, d);
+        _max = std::max(_max, d);
+        _addCentroid(d, 1);
+    } else {
+        // This is what getValue(true) produced below.
+        verify(input.getType() == Object);
+        const vector<Value>& means = input["means"].getArray();
+        const vector<Value>& weights = input["weights"].getArray();
+        verify(means.size() == weights.size());
+
+        if (means.empty())
+            return;  // This partition had no data to contribute.
+
+        _setPercentiles(input["p"]);
+
+        // The centroid means of the partition lie inside its range, so the extremes are carried
+        // separately to keep the 0 and 1 percentiles exact.
+        _min = std::min(_min, input["min"].getDouble());
+        _max = std::max(_max, input["max"].getDouble());
+        for (size_t i = 0; i < means.size(); i++) {
+            _addCentroid(means[i].getDouble(), weights[i].getDouble());
+        }
+    }
+}
+
+void AccumulatorApproxPercentile::_addCentroid(double mean, double weight) {
+    _buffer.push_back({mean, weight});
+    if (_buffer.size() >= kBufferSize) {
+        _compress();
+    }
+}
+
+void AccumulatorApproxPercentile::_compress() {
+    if (_buffer.empty())
+        return;
+
+    _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+    std::sort(_buffer.begin(), _buffer.end(), [](const Centroid& lhs, const Centroid& rhs) {
+        return lhs.mean < rhs.mean;
+    });
+
+    double totalWeight = 0;
+    for (auto&& centroid : _buffer) {
+        totalWeight += centroid.weight;
+    }
+
+    _centroids.clear();
+    Centroid current = _buffer.front();
+    double weightSoFar = 0;
+    double weightLimit = totalWeight * maxQuantileFrom(0);
+    for (auto it = _buffer.begin() + 1; it != _buffer.end(); ++it) {
+        if (weightSoFar + current.weight + it->weight <= weightLimit) {
+            current.weight += it->weight;
+            current.mean += (it->mean - current.mean) * it->weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            _centroids.push_back(current);
+            current = *it;
+            weightLimit = totalWeight * maxQuantileFrom(weightSoFar / totalWeight);
+        }
+    }
+    _centroids.push_back(current);
+
+    _totalWeight = totalWeight;
+    _buffer.clear();
+    _updateMemUsage();
+}
+
+double AccumulatorApproxPercentile::_quantile(double q) const {
+    invariant(!_centroids.empty());
+    if (_centroids.size() == 1)
+        return _centroids.front().mean;
+
+    // Each centroid is treated as having half of its weight on either side of its mean, and values
+    // are interpolated linearly between neighbouring means, or between the outermost means and the
+    // exact minimum and maximum.
+    const double index = q * _totalWeight;
+    const Centroid& first = _centroids.front();
+    if (index < first.weight / 2) {
+        return _min + (first.mean - _min) * index / (first.weight / 2);
+    }
+
+    double weightSoFar = first.weight / 2;
+    for (size_t i = 0; i + 1 < _centroids.size(); i++) {
+        const double delta = (_centroids[i].weight + _centroids[i + 1].weight) / 2;
+        if (weightSoFar + delta > index) {
+            const double fraction = (index - weightSoFar) / delta;
+            return _centroids[i].mean + (_centroids[i + 1].mean - _centroids[i].mean) * fraction;
+        }
+        weightSoFar += delta;
+    }
+
+    const Centroid& last = _centroids.back();
+    const double fraction = std::min(1.0, (index - weightSoFar) / (last.weight / 2));
+    return last.mean + (_max - last.mean) * fraction;
+}
+
+Value AccumulatorApproxPercentile::getValue(bool toBeMerged) {
+    _compress();
+
+    if (toBeMerged) {
+        vector<Value> means;
+        vector<Value> weights;
+        means.reserve(_centroids.size());
+        weights.reserve(_centroids.size());
+        for (auto&& centroid : _centroids) {
+            means.push_back(Value(centroid.mean));
+            weights.push_back(Value(centroid.weight));
+        }
+        MutableDocument partial;
+        partial.addField("p", _percentiles);
+        partial.addField("means", Value(std::move(means)));
+        partial.addField("weights", Value(std::move(weights)));
+        partial.addField("min", Value(_min));
+        partial.addField("max", Value(_max));
+        return Value(partial.freeze());
+    }
+
+    if (_centroids.empty())
+        return Value(BSONNULL);  // percentiles are not defined without any numeric input
+
+    if (!_percentiles.isArray())
+        return Value(_quantile(_percentiles.coerceToDouble()));
+
+    vector<Value> results;
+    for (auto&& p : _percentiles.getArray()) {
+        results.push_back(Value(_quantile(p.coerceToDouble())));
+    }
+    return Value(std::move(results));
+}
+
+void AccumulatorApproxPercentile::_updateMemUsage() {
+    _memUsageBytes = sizeof(*this) + _percentiles.getApproximateSize() - sizeof(Value) +
+        (_centroids.capacity() + _buffer.capacity()) * sizeof(Centroid);
+}
+
+AccumulatorApproxPercentile::AccumulatorApproxPercentile(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    reset();
+}
+
+void AccumulatorApproxPercentile::reset() {
+    _percentiles = Value();
+    _centroids.clear();
+    _buffer.clear();
+    _buffer.reserve(kBufferSize);
+    _totalWeight = 0;
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+    _updateMemUsage();
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxPercentile::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxPercentile(expCtx);
+}
+
+}  // namespace mongo
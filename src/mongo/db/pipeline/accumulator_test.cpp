@@ -344,6 +344,236 @@ TEST(Accumulators, AddToSetRespectsCollation) {
                             Value(std::vector<Value>{Value("a"_sd)})}});
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxCountDistinct",
+        expCtx,
+        {// No input.
+         {{}, Value(0LL)},
+         // Small cardinalities are counted exactly.
+         {{Value(1), Value(2), Value(3)}, Value(3LL)},
+         {{Value("a"_sd), Value("b"_sd), Value("a"_sd)}, Value(2LL)},
+         // Numerically equal values of different types are the same value.
+         {{Value(1), Value(1LL), Value(1.0), Value(Decimal128(1))}, Value(1LL)},
+         // Null values are counted and missing values are ignored.
+         {{Value(BSONNULL), Value(), Value(5)}, Value(2LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+    assertExpectedResults("$approxCountDistinct",
+                          expCtx,
+                          {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctIsAccurateForLargeCardinalities) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+    const long long numDistinct = 200000;
+    const size_t numShards = 4;
+
+    intrusive_ptr<Accumulator> unsharded(factory(expCtx));
+    std::vector<intrusive_ptr<Accumulator>> shards;
+    for (size_t i = 0; i < numShards; i++) {
+        shards.push_back(factory(expCtx));
+    }
+
+    // Every value is seen twice, on different shards.
+    for (long long i = 0; i < numDistinct; i++) {
+        unsharded->process(Value(i), false);
+        shards[i % numShards]->process(Value(i), false);
+        shards[(i + 1) % numShards]->process(Value(i), false);
+    }
+
+    const long long estimate = unsharded->getValue(false).getLong();
+    ASSERT_LT(std::abs(estimate - numDistinct), numDistinct * 3 / 100);
+
+    // Merging the partial sketches must produce exactly the same estimate.
+    intrusive_ptr<Accumulator> merger(factory(expCtx));
+    for (auto&& shard : shards) {
+        merger->process(shard->getValue(true), true);
+    }
+    ASSERT_VALUE_EQ(Value(estimate), merger->getValue(false));
+
+    // The memory footprint does not depend on the input.
+    ASSERT_EQ(unsharded->memUsageForSorter(), factory(expCtx)->memUsageForSorter());
+}
+
+TEST(Accumulators, ApproxCountDistinctRejectsMalformedSketch) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto accum = AccumulationStatement::getFactory("$approxCountDistinct")(expCtx);
+    const char sketch[] = {1, 2, 3};
+    ASSERT_THROWS_CODE(accum->process(Value(BSONBinData(sketch, sizeof(sketch), BinDataGeneral)),
+                                      true),
+                       AssertionException,
+                       50900);
+}
+
+/**
+ * Returns the operand $approxPercentile receives for 'input' with the percentiles 'p'.
+ */
+static Value percentileInput(Value input, Value p) {
+    return Value(Document{{"input", input}, {"p", p}});
+}
+
+TEST(Accumulators, ApproxPercentile) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const Value median(0.5);
+    assertExpectedResults(
+        "$approxPercentile",
+        expCtx,
+        {// No input.
+         {{}, Value(BSONNULL)},
+         // No numeric input.
+         {{percentileInput(Value("a"_sd), median), percentileInput(Value(), median)},
+          Value(BSONNULL)},
+         // A single value.
+         {{percentileInput(Value(5), median)}, Value(5.0)},
+         // Small inputs are held exactly.
+         {{percentileInput(Value(3), median),
+           percentileInput(Value(1LL), median),
+           percentileInput(Value(2.0), median)},
+          Value(2.0)},
+         // Multiple percentiles, including the extremes.
+         {{percentileInput(Value(1), Value(std::vector<Value>{Value(0), Value(0.5), Value(1)})),
+           percentileInput(Value(2), Value(std::vector<Value>{Value(0), Value(0.5), Value(1)})),
+           percentileInput(Value(3), Value(std::vector<Value>{Value(0), Value(0.5), Value(1)})),
+           percentileInput(Value(4), Value(std::vector<Value>{Value(0), Value(0.5), Value(1)})),
+           percentileInput(Value(5), Value(std::vector<Value>{Value(0), Value(0.5), Value(1)}))},
+          Value(std::vector<Value>{Value(1.0), Value(3.0), Value(5.0)})},
+         // Non-numeric, NaN and missing values are ignored.
+         {{percentileInput(Value(BSONNULL), median),
+           percentileInput(Value(numeric_limits<double>::quiet_NaN()), median),
+           percentileInput(Value(), median),
+           percentileInput(Value(7), median)},
+          Value(7.0)}});
+}
+
+TEST(Accumulators, ApproxPercentileRejectsInvalidPercentiles) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+
+    ASSERT_THROWS_CODE(factory(expCtx)->process(Value(1), false), AssertionException, 50903);
+    ASSERT_THROWS_CODE(factory(expCtx)->process(Value(Document{{"input", 1}}), false),
+                       AssertionException,
+                       50903);
+    ASSERT_THROWS_CODE(factory(expCtx)->process(percentileInput(Value(1), Value(1.5)), false),
+                       AssertionException,
+                       50902);
+    ASSERT_THROWS_CODE(factory(expCtx)->process(percentileInput(Value(1), Value("a"_sd)), false),
+                       AssertionException,
+                       50902);
+    ASSERT_THROWS_CODE(
+        factory(expCtx)->process(percentileInput(Value(1), Value(std::vector<Value>{})), false),
+        AssertionException,
+        50902);
+
+    auto accum = factory(expCtx);
+    accum->process(percentileInput(Value(1), Value(0.5)), false);
+    ASSERT_THROWS_CODE(accum->process(percentileInput(Value(2), Value(0.9)), false),
+                       AssertionException,
+                       50901);
+}
+
+TEST(Accumulators, ApproxPercentileIsAccurateWithBoundedMemory) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+    const long long numValues = 1000000;
+    const size_t numShards = 4;
+    const std::vector<double> percentiles{0.01, 0.5, 0.9, 0.99, 0.999};
+
+    std::vector<Value> percentileValues;
+    for (auto p : percentiles) {
+        percentileValues.push_back(Value(p));
+    }
+    const Value p(percentileValues);
+
+    intrusive_ptr<Accumulator> unsharded(factory(expCtx));
+    std::vector<intrusive_ptr<Accumulator>> shards;
+    for (size_t i = 0; i < numShards; i++) {
+        shards.push_back(factory(expCtx));
+    }
+
+    // Feed the values 0 to numValues - 1 in a scrambled order. 7919 is coprime with numValues, so
+    // this visits every value exactly once.
+    int peakMemUsage = 0;
+    for (long long i = 0; i < numValues; i++) {
+        const Value input = percentileInput(Value(i * 7919 % numValues), p);
+        unsharded->process(input, false);
+        shards[i % numShards]->process(input, false);
+        peakMemUsage = std::max(peakMemUsage, unsharded->memUsageForSorter());
+    }
+
+    intrusive_ptr<Accumulator> merger(factory(expCtx));
+    for (auto&& shard : shards) {
+        merger->process(shard->getValue(true), true);
+    }
+
+    // The estimates should be within 0.1% of the range of the input, whether merged or not.
+    for (auto&& result : {unsharded->getValue(false), merger->getValue(false)}) {
+        const std::vector<Value>& estimates = result.getArray();
+        ASSERT_EQ(estimates.size(), percentiles.size());
+        for (size_t i = 0; i < percentiles.size(); i++) {
+            const double expected = percentiles[i] * (numValues - 1);
+            ASSERT_APPROX_EQUAL(estimates[i].getDouble(), expected, numValues / 1000.0);
+        }
+    }
+
+    // The digest never holds more than a few thousand centroids, compared to the tens of megabytes
+    // needed to keep every input.
+    ASSERT_LT(peakMemUsage, 64 * 1024);
+    ASSERT_LT(merger->memUsageForSorter(), 64 * 1024);
+}
+
+TEST(Accumulators, ApproxPercentileCentroidCountStaysBounded) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+
+    // A partial state of many light centroids stands in for tens of millions of inputs. Near the
+    // top of the scale the centroids must keep merging, or the tail alone would keep hundreds.
+    const size_t numCentroids = 200000;
+    std::vector<Value> means;
+    std::vector<Value> weights;
+    for (size_t i = 0; i < numCentroids; i++) {
+        means.push_back(Value(static_cast<double>(i)));
+        weights.push_back(Value(50.0));
+    }
+    auto accum = factory(expCtx);
+    accum->process(Value(Document{{"p", 0.5},
+                                  {"means", Value(std::move(means))},
+                                  {"weights", Value(std::move(weights))},
+                                  {"min", 0.0},
+                                  {"max", static_cast<double>(numCentroids - 1)}}),
+                   true);
+
+    const Value partial = accum->getValue(true);
+    ASSERT_LTE(partial["means"].getArray().size(),
+               static_cast<size_t>(AccumulatorApproxPercentile::kCompression));
+}
+
+TEST(Accumulators, ApproxPercentileMergeKeepsExactExtremes) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+    const Value p(std::vector<Value>{Value(0), Value(1)});
+
+    // Each shard has enough values for its outermost centroids to merge several of them, so their
+    // means are not the extremes of the input.
+    auto lowShard = factory(expCtx);
+    auto highShard = factory(expCtx);
+    for (int i = 0; i < 10000; i++) {
+        lowShard->process(percentileInput(Value(i), p), false);
+        highShard->process(percentileInput(Value(i + 10000), p), false);
+    }
+
+    auto merger = factory(expCtx);
+    merger->process(lowShard->getValue(true), true);
+    merger->process(highShard->getValue(true), true);
+    ASSERT_VALUE_EQ(merger->getValue(false), Value(std::vector<Value>{Value(0.0), Value(19999.0)}));
+}
+
 /* ------------------------- AccumulatorMergeObjects -------------------------- */
 
 namespace AccumulatorMergeObjects {
@@ -362,6 +362,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (spec->maxTs) {
             bob->append("maxTs", *(spec->maxTs));
         }
+        if (spec->readAhead) {
+            bob->appendBool("readAhead", true);
+        }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
@@ -375,6 +375,14 @@ public:
         _allowPartialResults = allowPartialResults;
     }
 
+    bool isReadAhead() const {
+        return _readAhead;
+    }
+
+    void setReadAhead(bool readAhead) {
+        _readAhead = readAhead;
+    }
+
     boost::optional<long long> getReplicationTerm() const {
         return _replicationTerm;
     }
@@ -497,6 +505,9 @@ private:
     bool _showRecordId = false;
     bool _hasReadPref = false;
 
+    // Ask forward collection scans to read the upcoming records in the background.
+    bool _readAhead = false;
+
     // Options that can be specified in the OP_QUERY 'flags' header.
     TailableModeEnum _tailableMode = TailableModeEnum::kNormal;
     bool _slaveOk = false;
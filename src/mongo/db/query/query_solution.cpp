@@ -249,6 +249,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->maxScan = this->maxScan;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->readAhead = this->readAhead;
 
     return copy;
 }
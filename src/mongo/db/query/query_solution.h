@@ -308,6 +308,9 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether a forward scan should read ahead of its position in the background.
+    bool readAhead = false;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -83,6 +83,7 @@ PlanStage* buildStages(OperationContext* opCtx,
                                                      : CollectionScanParams::BACKWARD;
             params.maxScan = csn->maxScan;
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
+            params.readAhead = csn->readAhead;
             return new CollectionScan(opCtx, params, ws, csn->filter.get());
         }
         case STAGE_IXSCAN: {
@@ -78,6 +78,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -299,6 +300,17 @@ std::unique_ptr<ThreadPool> SyncTail::makeWriterPool(int threadCount) {
     options.onCreateThread = [](const std::string&) {
         // Only do this once per thread
         if (!Client::getCurrent()) {
+            // Writers are dealt out to the NUMA nodes in turn before they allocate anything, so
+            // their Client and storage engine session come from their own node's memory.
+            if (numaAwareThreadPlacement) {
+                static AtomicWord<unsigned> nextWriter{0};
+                auto swNode =
+                    NumaTopology::get().bindCurrentThreadToNode(nextWriter.fetchAndAdd(1));
+                if (!swNode.isOK()) {
+                    warning() << swNode.getStatus();
+                }
+            }
+
             Client::initThreadIfNotAlready();
             AuthorizationSession::get(cc())->grantInternalAuthorization();
         }
@@ -37,10 +37,13 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -56,6 +59,12 @@ using std::vector;
 
 namespace {
 
+// Whether the balancer should ask the donor shards for their per-chunk write rates and prefer
+// moving the chunks receiving the most writes. Off by default, because it adds a getChunkWriteHeat
+// request to each donor on every balancer round, and shards only start tracking the write rates
+// once they are first asked for them.
+MONGO_EXPORT_SERVER_PARAMETER(balancerPreferHotChunks, bool, false);
+
 /**
  * Does a linear pass over the information cached in the specified chunk manager and extracts chunk
  * distribution and chunk placement information which is needed by the balancer policy.
@@ -171,6 +180,51 @@ private:
     BSONObjIndexedMap<BalancerChunkSelectionPolicy::SplitInfo> _chunkSplitPoints;
 };
 
+/**
+ * Asks every shard, which owns more than its share of the collection's chunks and is therefore a
+ * potential donor, for the write rates of its chunks and records them in the distribution. This is
+ * best-effort, because older shards do not support the command and failing to obtain the heat of a
+ * chunk only means falling back to the default chunk selection.
+ */
+void appendChunkWriteHeat(OperationContext* opCtx,
+                          const ShardStatisticsVector& shardStats,
+                          DistributionStatus* distribution) {
+    if (shardStats.empty())
+        return;
+
+    const size_t averageNumberOfChunks = distribution->totalChunks() / shardStats.size();
+
+    for (const auto& stat : shardStats) {
+        if (distribution->numberOfChunksInShard(stat.shardId) <= averageNumberOfChunks)
+            continue;
+
+        auto shardStatus = Grid::get(opCtx)->shardRegistry()->getShard(opCtx, stat.shardId);
+        if (!shardStatus.isOK()) {
+            continue;
+        }
+
+        auto commandResponse = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            "admin",
+            BSON("getChunkWriteHeat" << distribution->nss().ns()),
+            Shard::RetryPolicy::kIdempotent);
+
+        auto status = Shard::CommandResponse::getEffectiveStatus(commandResponse);
+        if (!status.isOK()) {
+            LOG(1) << "Unable to retrieve chunk write heat for " << distribution->nss().ns()
+                   << " from shard " << stat.shardId << causedBy(redact(status));
+            continue;
+        }
+
+        for (const auto& chunkElem : commandResponse.getValue().response["chunks"].Array()) {
+            const auto chunkObj = chunkElem.Obj();
+            distribution->setChunkWriteHeat(chunkObj["min"].Obj(),
+                                            chunkObj["writeBytesPerSec"].numberDouble());
+        }
+    }
+}
+
 }  // namespace
 
 BalancerChunkSelectionPolicyImpl::BalancerChunkSelectionPolicyImpl(ClusterStatistics* clusterStats,
@@ -425,11 +479,15 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
 
     const auto& shardKeyPattern = cm->getShardKeyPattern().getKeyPattern();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
+    if (balancerPreferHotChunks.load()) {
+        appendChunkWriteHeat(opCtx, shardStats, &collInfoStatus.getValue());
+    }
+
     const DistributionStatus& distribution = collInfoStatus.getValue();
 
     for (const auto& tagRangeEntry : distribution.tagRanges()) {
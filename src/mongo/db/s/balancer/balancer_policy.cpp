@@ -57,7 +57,8 @@ const size_t kAggressiveImbalanceThreshold = 1;
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
     : _nss(std::move(nss)),
       _shardChunks(std::move(shardToChunksMap)),
-      _zoneRanges(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ZoneRange>()) {}
+      _zoneRanges(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ZoneRange>()),
+      _chunkWriteHeat(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<double>()) {}
 
 size_t DistributionStatus::totalChunks() const {
     size_t total = 0;
@@ -173,6 +174,15 @@ string DistributionStatus::getTagForChunk(const ChunkType& chunk) const {
     return "";
 }
 
+void DistributionStatus::setChunkWriteHeat(const BSONObj& chunkMin, double writeBytesPerSec) {
+    _chunkWriteHeat[chunkMin.getOwned()] = writeBytesPerSec;
+}
+
+double DistributionStatus::getChunkWriteHeat(const ChunkType& chunk) const {
+    const auto it = _chunkWriteHeat.find(chunk.getMin());
+    return it == _chunkWriteHeat.end() ? 0 : it->second;
+}
+
 void DistributionStatus::report(BSONObjBuilder* builder) const {
     builder->append("ns", _nss.ns());
 
@@ -500,6 +510,11 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
 
     unsigned numJumboChunks = 0;
 
+    // Prefer the chunk receiving the most writes so that moving it also moves write load off the
+    // donor. Without any heat information this is the first eligible chunk.
+    const ChunkType* chunkToMove = nullptr;
+    double chunkToMoveHeat = 0;
+
     for (const auto& chunk : chunks) {
         if (distribution.getTagForChunk(chunk) != tag)
             continue;
@@ -509,8 +524,16 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
             continue;
         }
 
-        migrations->emplace_back(to, chunk);
-        invariant(usedShards->insert(chunk.getShard()).second);
+        const double heat = distribution.getChunkWriteHeat(chunk);
+        if (!chunkToMove || heat > chunkToMoveHeat) {
+            chunkToMove = &chunk;
+            chunkToMoveHeat = heat;
+        }
+    }
+
+    if (chunkToMove) {
+        migrations->emplace_back(to, *chunkToMove);
+        invariant(usedShards->insert(chunkToMove->getShard()).second);
         invariant(usedShards->insert(to).second);
         return true;
     }
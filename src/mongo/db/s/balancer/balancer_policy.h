@@ -140,6 +140,17 @@ public:
      */
     std::string getTagForChunk(const ChunkType& chunk) const;
 
+    /**
+     * Records the recent write rate, as reported by the owning shard, of the chunk starting at
+     * chunkMin. Used to prefer moving the most write-heavy chunks off an overloaded shard.
+     */
+    void setChunkWriteHeat(const BSONObj& chunkMin, double writeBytesPerSec);
+
+    /**
+     * Returns the write rate recorded for the specified chunk or 0 if none was recorded.
+     */
+    double getChunkWriteHeat(const ChunkType& chunk) const;
+
     /**
      * Returns a BSON/string representation of this distribution status.
      */
@@ -158,6 +169,9 @@ private:
 
     // Set of all zones defined for this collection
     std::set<std::string> _allTags;
+
+    // Map of chunk min key to the write rate (in bytes per second) reported for that chunk
+    BSONObjIndexedMap<double> _chunkWriteHeat;
 };
 
 class BalancerPolicy {
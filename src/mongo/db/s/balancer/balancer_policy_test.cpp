@@ -133,6 +133,25 @@ TEST(BalancerPolicy, Basic) {
     ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
 }
 
+TEST(BalancerPolicy, HottestChunkIsPreferredForMigration) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.setChunkWriteHeat(cluster.second[kShardId0][1].getMin(), 10.0);
+    distribution.setChunkWriteHeat(cluster.second[kShardId0][2].getMin(), 1000.0);
+    distribution.setChunkWriteHeat(cluster.second[kShardId0][3].getMin(), 100.0);
+
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][2].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][2].getMax(), migrations[0].maxKey);
+}
+
 TEST(BalancerPolicy, SmallClusterShouldBePerfectlyBalanced) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, kNoMaxSize, 1, false, emptyTagSet, emptyShardVersion), 1},
@@ -37,6 +37,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_write_heat_tracker.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
@@ -191,6 +192,60 @@ BSONObj findExtremeKeyForShard(OperationContext* opCtx,
     return shardKeyPattern.extractShardKeyFromDoc(end);
 }
 
+/**
+ * If the specified chunk receives writes at a rate above the hot chunk threshold, returns the
+ * point at which to split it so that the write load can be spread. This is the most recently
+ * written shard key, which for monotonically increasing keys leaves all subsequent writes on the
+ * upper part, or the median key if that one cannot be used. Returns an empty document if the chunk
+ * is not hot or no split point could be found.
+ *
+ * 'lastWrittenKey' is set to the most recently written shard key, if any.
+ */
+BSONObj findHotChunkSplitPoint(OperationContext* opCtx,
+                               const NamespaceString& nss,
+                               const ShardKeyPattern& shardKeyPattern,
+                               const Chunk& chunk,
+                               BSONObj* lastWrittenKey) {
+    const double hotChunkThreshold = ChunkWriteHeatTracker::getHotChunkSplitThreshold();
+    if (hotChunkThreshold <= 0) {
+        return BSONObj();
+    }
+
+    const ChunkRange chunkRange(chunk.getMin(), chunk.getMax());
+    const auto heat = ChunkWriteHeatTracker::get(opCtx).getChunkHeat(
+        nss, chunkRange, opCtx->getServiceContext()->getFastClockSource()->now());
+    if (!heat || heat->writeBytesPerSec < hotChunkThreshold) {
+        return BSONObj();
+    }
+
+    LOG(1) << "chunk " << redact(chunkRange.toString()) << " of " << nss << " is hot ("
+           << heat->writeBytesPerSec << " bytes/sec written)";
+
+    *lastWrittenKey = heat->lastWrittenKey;
+
+    // Chunk range lower bounds are inclusive, so the split point must be strictly greater
+    if (!lastWrittenKey->isEmpty() && chunkRange.containsKey(*lastWrittenKey) &&
+        lastWrittenKey->woCompare(chunk.getMin()) > 0) {
+        return *lastWrittenKey;
+    }
+
+    auto medianKey = splitVector(opCtx,
+                                 nss,
+                                 shardKeyPattern.toBSON(),
+                                 chunk.getMin(),
+                                 chunk.getMax(),
+                                 true,  // force
+                                 boost::none,
+                                 boost::none,
+                                 boost::none,
+                                 boost::none);
+    if (!medianKey.isOK() || medianKey.getValue().empty()) {
+        return BSONObj();
+    }
+
+    return medianKey.getValue().front();
+}
+
 /**
  * Checks if autobalance is enabled on the current sharded collection.
  */
@@ -329,10 +384,29 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
                                                        boost::none,
                                                        maxChunkSizeBytes));
 
+        // Keeps track of the minKey of the top chunk after the split so we can migrate the chunk.
+        BSONObj topChunkMinKey;
+
+        // Set if the chunk is split because of its write rate rather than because of its size
+        bool isHotChunkSplit = false;
+
         if (splitPoints.size() <= 1) {
             // No split points means there isn't enough data to split on; 1 split point means we
-            // have between half the chunk size to full chunk size so there is no need to split yet
-            return;
+            // have between half the chunk size to full chunk size so there is no need to split yet,
+            // unless the chunk is taking a large share of the writes
+            BSONObj lastWrittenKey;
+            BSONObj hotSplitPoint = findHotChunkSplitPoint(
+                opCtx.get(), nss, cm->getShardKeyPattern(), chunk, &lastWrittenKey);
+            if (hotSplitPoint.isEmpty()) {
+                return;
+            }
+
+            splitPoints = {hotSplitPoint.getOwned()};
+            isHotChunkSplit = true;
+
+            // Move away whichever part is receiving the writes
+            topChunkMinKey = lastWrittenKey.isEmpty() ? hotSplitPoint.getOwned()
+                                                      : lastWrittenKey.getOwned();
         }
 
         // We assume that if the chunk being split is the first (or last) one on the collection,
@@ -340,12 +414,10 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
         // very first (or last) key as a split point.
         //
         // This heuristic is skipped for "special" shard key patterns that are not likely to produce
-        // monotonically increasing or decreasing values (e.g. hashed shard keys).
-
-        // Keeps track of the minKey of the top chunk after the split so we can migrate the chunk.
-        BSONObj topChunkMinKey;
-
-        if (KeyPattern::isOrderedKeyPattern(cm->getShardKeyPattern().toBSON())) {
+        // monotonically increasing or decreasing values (e.g. hashed shard keys), as well as for
+        // hot chunks, which already have their split point chosen based on the writes.
+        if (!isHotChunkSplit &&
+            KeyPattern::isOrderedKeyPattern(cm->getShardKeyPattern().toBSON())) {
             if (0 ==
                 cm->getShardKeyPattern().getKeyPattern().globalMin().woCompare(chunk.getMin())) {
                 // MinKey is infinity (This is the first chunk on the collection)
@@ -380,7 +452,7 @@ void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
 
         log() << "autosplitted " << nss << " chunk: " << redact(chunk.toString()) << " into "
               << (splitPoints.size() + 1) << " parts (maxChunkSizeBytes " << maxChunkSizeBytes
-              << ")"
+              << ")" << (isHotChunkSplit ? " because of its write rate" : "")
               << (topChunkMinKey.isEmpty() ? "" : " (top chunk migration suggested" +
                           (std::string)(shouldBalance ? ")" : ", but no migrations allowed)"));
 
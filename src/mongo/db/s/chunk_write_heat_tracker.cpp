@@ -0,0 +1,298 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_write_heat_tracker.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+// Period over which the tracked write heat of a chunk halves when there are no more writes to it
+MONGO_EXPORT_SERVER_PARAMETER(chunkWriteHeatHalfLifeSecs, int, 60);
+
+// Write rate above which the shard schedules a split of a chunk, even if it is not large. Zero
+// disables splitting based on the write rate.
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitHotChunkWriteBytesPerSec, int, 0);
+
+// Bounds the memory used per collection. Chunks whose heat has decayed away are dropped first.
+const std::size_t kMaxTrackedChunksPerCollection = 10000;
+
+// Decayed byte counts below this are considered cold and may be dropped
+const double kColdDecayedBytes = 1.0;
+
+// Writes to a chunk are passed on to the tracker at most this often, which is small compared to
+// the half-life, so that the decay is still accurate
+const Seconds kSampleInterval(1);
+
+// Tracking stops once no getChunkWriteHeat arrived for this long, which is well above the interval
+// between balancer rounds
+const Minutes kHeatRequestExpiry(5);
+
+const auto getChunkWriteHeatTracker = ServiceContext::declareDecoration<ChunkWriteHeatTracker>();
+
+Milliseconds getHalfLife() {
+    return Seconds(std::max(1, chunkWriteHeatHalfLifeSecs.load()));
+}
+
+/**
+ * Returns the factor by which a value accumulated as of 'from' has decayed by 'to'.
+ */
+double decayFactor(Date_t from, Date_t to, Milliseconds halfLife) {
+    if (to <= from) {
+        return 1.0;
+    }
+
+    return std::exp2(-static_cast<double>(durationCount<Milliseconds>(to - from)) /
+                     durationCount<Milliseconds>(halfLife));
+}
+
+/**
+ * Converts an exponentially decayed sum into an average rate per second. A steady rate 'r' makes
+ * the decayed sum converge to r * halfLife / ln(2).
+ */
+double toRatePerSec(double decayedSum, Milliseconds halfLife) {
+    return decayedSum * M_LN2 * 1000 / durationCount<Milliseconds>(halfLife);
+}
+
+}  // namespace
+
+ChunkWriteHeatTracker::ChunkHeat::ChunkHeat(ChunkRange range,
+                                            double writeBytesPerSec,
+                                            double writeOpsPerSec,
+                                            BSONObj lastWrittenKey)
+    : range(std::move(range)),
+      writeBytesPerSec(writeBytesPerSec),
+      writeOpsPerSec(writeOpsPerSec),
+      lastWrittenKey(std::move(lastWrittenKey)) {}
+
+void ChunkWriteHeatTracker::ChunkHeat::append(BSONObjBuilder* builder) const {
+    range.append(builder);
+    builder->append("writeBytesPerSec", writeBytesPerSec);
+    builder->append("writeOpsPerSec", writeOpsPerSec);
+    builder->append("lastWrittenKey", lastWrittenKey);
+}
+
+ChunkWriteHeatTracker::ChunkWriteHeatTracker() = default;
+
+ChunkWriteHeatTracker::~ChunkWriteHeatTracker() = default;
+
+ChunkWriteHeatTracker& ChunkWriteHeatTracker::get(ServiceContext* serviceContext) {
+    return getChunkWriteHeatTracker(serviceContext);
+}
+
+ChunkWriteHeatTracker& ChunkWriteHeatTracker::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+double ChunkWriteHeatTracker::getHotChunkSplitThreshold() {
+    return std::max(0, autoSplitHotChunkWriteBytesPerSec.load());
+}
+
+Milliseconds ChunkWriteHeatTracker::getSampleInterval() {
+    return kSampleInterval;
+}
+
+bool ChunkWriteHeatTracker::isTrackingEnabled(Date_t now) const {
+    if (getHotChunkSplitThreshold() > 0) {
+        return true;
+    }
+
+    const long long lastRequestMillis = _lastHeatRequestMillis.load();
+    return lastRequestMillis != 0 &&
+        now.toMillisSinceEpoch() - lastRequestMillis <
+        durationCount<Milliseconds>(kHeatRequestExpiry);
+}
+
+void ChunkWriteHeatTracker::markHeatRequested(Date_t now) {
+    _lastHeatRequestMillis.store(now.toMillisSinceEpoch());
+}
+
+double ChunkWriteHeatTracker::recordWrites(const NamespaceString& nss,
+                                           const ChunkRange& range,
+                                           const BSONObj& lastWrittenKey,
+                                           uint64_t bytes,
+                                           uint64_t numWrites,
+                                           Date_t now) {
+    const auto halfLife = getHalfLife();
+
+    auto& stripe = _getStripe(nss);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+
+    auto collIt = stripe.collections.find(nss.ns());
+    if (collIt == stripe.collections.end()) {
+        auto newEntries = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkEntry>();
+        collIt = stripe.collections.emplace(nss.ns(), std::move(newEntries)).first;
+    }
+    auto& entries = collIt->second;
+
+    auto it = entries.find(range.getMin());
+    if (it == entries.end()) {
+        if (entries.size() >= kMaxTrackedChunksPerCollection) {
+            for (auto pruneIt = entries.begin(); pruneIt != entries.end();) {
+                const auto& entry = pruneIt->second;
+                if (entry.decayedBytes * decayFactor(entry.lastUpdate, now, halfLife) <
+                    kColdDecayedBytes) {
+                    pruneIt = entries.erase(pruneIt);
+                } else {
+                    ++pruneIt;
+                }
+            }
+
+            if (entries.size() >= kMaxTrackedChunksPerCollection) {
+                return 0;
+            }
+        }
+
+        it = entries.emplace(range.getMin().getOwned(), ChunkEntry()).first;
+        it->second.max = range.getMax().getOwned();
+        it->second.lastUpdate = now;
+    } else if (SimpleBSONObjComparator::kInstance.evaluate(it->second.max != range.getMax())) {
+        // The chunk was split or merged, so whatever was accumulated belongs to a different range
+        it->second = ChunkEntry();
+        it->second.max = range.getMax().getOwned();
+        it->second.lastUpdate = now;
+    }
+
+    auto& entry = it->second;
+
+    const double factor = decayFactor(entry.lastUpdate, now, halfLife);
+    entry.decayedBytes = entry.decayedBytes * factor + bytes;
+    entry.decayedOps = entry.decayedOps * factor + numWrites;
+    entry.lastUpdate = std::max(entry.lastUpdate, now);
+    entry.lastWrittenKey = lastWrittenKey.getOwned();
+
+    return toRatePerSec(entry.decayedBytes, halfLife);
+}
+
+boost::optional<ChunkWriteHeatTracker::ChunkHeat> ChunkWriteHeatTracker::getChunkHeat(
+    const NamespaceString& nss, const ChunkRange& range, Date_t now) const {
+    auto& stripe = _getStripe(nss);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+
+    auto collIt = stripe.collections.find(nss.ns());
+    if (collIt == stripe.collections.end()) {
+        return boost::none;
+    }
+
+    auto it = collIt->second.find(range.getMin());
+    if (it == collIt->second.end() ||
+        SimpleBSONObjComparator::kInstance.evaluate(it->second.max != range.getMax())) {
+        return boost::none;
+    }
+
+    return _makeChunkHeat(it->first, it->second, now);
+}
+
+std::vector<ChunkWriteHeatTracker::ChunkHeat> ChunkWriteHeatTracker::getHottestChunks(
+    const NamespaceString& nss, std::size_t limit, Date_t now) const {
+    std::vector<ChunkHeat> chunks;
+
+    {
+        auto& stripe = _getStripe(nss);
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+
+        auto collIt = stripe.collections.find(nss.ns());
+        if (collIt == stripe.collections.end()) {
+            return chunks;
+        }
+
+        for (const auto& entry : collIt->second) {
+            chunks.push_back(_makeChunkHeat(entry.first, entry.second, now));
+        }
+    }
+
+    std::sort(chunks.begin(), chunks.end(), [](const ChunkHeat& lhs, const ChunkHeat& rhs) {
+        return lhs.writeBytesPerSec > rhs.writeBytesPerSec;
+    });
+
+    if (chunks.size() > limit) {
+        chunks.erase(chunks.begin() + limit, chunks.end());
+    }
+
+    return chunks;
+}
+
+bool ChunkWriteHeatTracker::tryMarkSplitRequested(const NamespaceString& nss,
+                                                  const ChunkRange& range,
+                                                  Date_t now) {
+    auto& stripe = _getStripe(nss);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+
+    auto collIt = stripe.collections.find(nss.ns());
+    if (collIt == stripe.collections.end()) {
+        return false;
+    }
+
+    auto it = collIt->second.find(range.getMin());
+    if (it == collIt->second.end() ||
+        SimpleBSONObjComparator::kInstance.evaluate(it->second.max != range.getMax())) {
+        return false;
+    }
+
+    auto& entry = it->second;
+    if (entry.lastSplitRequest != Date_t() && now - entry.lastSplitRequest < getHalfLife()) {
+        return false;
+    }
+
+    entry.lastSplitRequest = now;
+    return true;
+}
+
+void ChunkWriteHeatTracker::clear(const NamespaceString& nss) {
+    auto& stripe = _getStripe(nss);
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    stripe.collections.erase(nss.ns());
+}
+
+ChunkWriteHeatTracker::Stripe& ChunkWriteHeatTracker::_getStripe(const NamespaceString& nss) const {
+    return _stripes[std::hash<std::string>()(nss.ns()) % kNumStripes];
+}
+
+ChunkWriteHeatTracker::ChunkHeat ChunkWriteHeatTracker::_makeChunkHeat(const BSONObj& min,
+                                                                       const ChunkEntry& entry,
+                                                                       Date_t now) const {
+    const auto halfLife = getHalfLife();
+    const double factor = decayFactor(entry.lastUpdate, now, halfLife);
+
+    return ChunkHeat(ChunkRange(min, entry.max),
+                     toRatePerSec(entry.decayedBytes * factor, halfLife),
+                     toRatePerSec(entry.decayedOps * factor, halfLife),
+                     entry.lastWrittenKey);
+}
+
+}  // namespace mongo
@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class NamespaceString;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Keeps an exponentially decayed estimate of the write rate of every chunk, which this shard has
+ * written to recently. The sharding op observer accumulates the writes on the chunk itself and
+ * passes them on at most once per sample interval, and the tracker is consulted by the
+ * auto-splitter to split hot chunks even if they are not large, by the balancer (through the
+ * getChunkWriteHeat command) to prefer moving hot chunks and by diagnostic tooling.
+ *
+ * The decay half-life is controlled by the 'chunkWriteHeatHalfLifeSecs' server parameter. All
+ * methods are thread-safe. The caller supplies the current time, so that the decay is
+ * deterministic under test.
+ */
+class ChunkWriteHeatTracker {
+    MONGO_DISALLOW_COPYING(ChunkWriteHeatTracker);
+
+public:
+    /**
+     * Point in time view of the heat of a single chunk.
+     */
+    struct ChunkHeat {
+        ChunkHeat(ChunkRange range,
+                  double writeBytesPerSec,
+                  double writeOpsPerSec,
+                  BSONObj lastWrittenKey);
+
+        /**
+         * Writes the contents as { min, max, writeBytesPerSec, writeOpsPerSec, lastWrittenKey }.
+         */
+        void append(BSONObjBuilder* builder) const;
+
+        ChunkRange range;
+        double writeBytesPerSec;
+        double writeOpsPerSec;
+
+        // Shard key of the most recent write to the chunk
+        BSONObj lastWrittenKey;
+    };
+
+    ChunkWriteHeatTracker();
+    ~ChunkWriteHeatTracker();
+
+    static ChunkWriteHeatTracker& get(ServiceContext* serviceContext);
+    static ChunkWriteHeatTracker& get(OperationContext* opCtx);
+
+    /**
+     * Returns the write rate, in bytes per second, above which a chunk is considered hot and gets
+     * split regardless of its size. Zero means that hot chunk splitting is disabled. Controlled by
+     * the 'autoSplitHotChunkWriteBytesPerSec' server parameter.
+     */
+    static double getHotChunkSplitThreshold();
+
+    /**
+     * Returns the minimum interval at which the writes accumulated on a chunk are passed on to the
+     * tracker through recordWrites.
+     */
+    static Milliseconds getSampleInterval();
+
+    /**
+     * Returns whether writes need to be tracked at all, which is the case while hot chunk splitting
+     * is enabled or while the balancer keeps asking for the write rates through getChunkWriteHeat.
+     * Otherwise the op observer skips the tracking altogether.
+     */
+    bool isTrackingEnabled(Date_t now) const;
+
+    /**
+     * Notes that somebody is consuming the write rates, so that they are tracked for a while.
+     */
+    void markHeatRequested(Date_t now);
+
+    /**
+     * Accounts for 'numWrites' writes totalling 'bytes' to the chunk 'range' of 'nss', the last of
+     * which had shard key 'lastWrittenKey', and returns the resulting write rate of the chunk, in
+     * bytes per second. If the chunk bounds changed since the last call, because of a split or
+     * merge, the chunk starts from no heat.
+     */
+    double recordWrites(const NamespaceString& nss,
+                        const ChunkRange& range,
+                        const BSONObj& lastWrittenKey,
+                        uint64_t bytes,
+                        uint64_t numWrites,
+                        Date_t now);
+
+    /**
+     * Returns the current heat of the specified chunk or boost::none if it has not been written
+     * to recently or its bounds do not match.
+     */
+    boost::optional<ChunkHeat> getChunkHeat(const NamespaceString& nss,
+                                            const ChunkRange& range,
+                                            Date_t now) const;
+
+    /**
+     * Returns up to 'limit' chunks of 'nss' in decreasing order of write rate.
+     */
+    std::vector<ChunkHeat> getHottestChunks(const NamespaceString& nss,
+                                            std::size_t limit,
+                                            Date_t now) const;
+
+    /**
+     * Returns true and remembers the time if no split was requested for the specified chunk
+     * within the last half-life. Used to avoid scheduling a split of the same hot chunk on every
+     * write.
+     */
+    bool tryMarkSplitRequested(const NamespaceString& nss, const ChunkRange& range, Date_t now);
+
+    /**
+     * Forgets all the heat tracked for the specified collection.
+     */
+    void clear(const NamespaceString& nss);
+
+private:
+    struct ChunkEntry {
+        BSONObj max;
+
+        // Exponentially decayed sums of the bytes and the number of writes, as of 'lastUpdate'
+        double decayedBytes{0};
+        double decayedOps{0};
+        Date_t lastUpdate;
+
+        BSONObj lastWrittenKey;
+        Date_t lastSplitRequest;
+    };
+
+    using CollectionEntries = BSONObjIndexedMap<ChunkEntry>;
+
+    // The per-collection maps are spread over a number of independently locked stripes, so that
+    // writes to different collections do not contend
+    struct Stripe {
+        mutable stdx::mutex mutex;
+        stdx::unordered_map<std::string, CollectionEntries> collections;
+    };
+
+    static const std::size_t kNumStripes = 16;
+
+    Stripe& _getStripe(const NamespaceString& nss) const;
+
+    ChunkHeat _makeChunkHeat(const BSONObj& min, const ChunkEntry& entry, Date_t now) const;
+
+    mutable std::array<Stripe, kNumStripes> _stripes;
+
+    // When getChunkWriteHeat was last called, in milliseconds since the epoch, or zero if never
+    AtomicInt64 _lastHeatRequestMillis{0};
+};
+
+}  // namespace mongo
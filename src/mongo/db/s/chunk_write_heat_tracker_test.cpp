@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_write_heat_tracker.h"
+#include "mongo/s/chunk.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+// Matches the default of the chunkWriteHeatHalfLifeSecs server parameter
+const Seconds kHalfLife(60);
+
+ChunkRange makeRange(int min, int max) {
+    return ChunkRange(BSON("x" << min), BSON("x" << max));
+}
+
+TEST(ChunkWriteHeatTrackerTest, TrackingStartsOnceHeatIsRequested) {
+    // Hot chunk splitting is disabled by default, so nothing needs the write rates yet
+    ChunkWriteHeatTracker tracker;
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+    ASSERT_FALSE(tracker.isTrackingEnabled(now));
+
+    tracker.markHeatRequested(now);
+    ASSERT(tracker.isTrackingEnabled(now));
+    ASSERT(tracker.isTrackingEnabled(now + Minutes(1)));
+}
+
+TEST(ChunkWriteHeatTrackerTest, TrackingStopsOnceHeatIsNoLongerRequested) {
+    ChunkWriteHeatTracker tracker;
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    tracker.markHeatRequested(now);
+    ASSERT_FALSE(tracker.isTrackingEnabled(now + Minutes(10)));
+
+    tracker.markHeatRequested(now + Minutes(10));
+    ASSERT(tracker.isTrackingEnabled(now + Minutes(10)));
+}
+
+TEST(ChunkWriteHeatTrackerTest, PendingWritesAreTakenOncePerSampleInterval) {
+    ChunkInfo chunkInfo(ChunkType(
+        kNss, makeRange(0, 100), ChunkVersion(1, 0, OID::gen()), ShardId("shard0000")));
+    Chunk chunk(chunkInfo, boost::none);
+    const auto sampleInterval = ChunkWriteHeatTracker::getSampleInterval();
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000000);
+
+    chunk.addPendingWriteHeat(100);
+    auto pending = chunk.takePendingWriteHeat(now, sampleInterval);
+    ASSERT(pending);
+    ASSERT_EQ(100U, pending->bytes);
+    ASSERT_EQ(1U, pending->numWrites);
+
+    // Writes within the interval are kept for the next sample
+    chunk.addPendingWriteHeat(200);
+    chunk.addPendingWriteHeat(300);
+    ASSERT_FALSE(chunk.takePendingWriteHeat(now + sampleInterval / 2, sampleInterval));
+
+    pending = chunk.takePendingWriteHeat(now + sampleInterval, sampleInterval);
+    ASSERT(pending);
+    ASSERT_EQ(500U, pending->bytes);
+    ASSERT_EQ(2U, pending->numWrites);
+}
+
+TEST(ChunkWriteHeatTrackerTest, SteadyWriteRateConverges) {
+    ChunkWriteHeatTracker tracker;
+    const auto range = makeRange(0, 100);
+
+    // 1000 bytes every second for twenty half-lives
+    Date_t now = Date_t::fromMillisSinceEpoch(1000);
+    double writeBytesPerSec = 0;
+    for (int i = 0; i < 20 * 60; i++) {
+        writeBytesPerSec = tracker.recordWrites(kNss, range, BSON("x" << 50), 1000, 1, now);
+        now += Seconds(1);
+    }
+
+    ASSERT_APPROX_EQUAL(1000.0, writeBytesPerSec, 20.0);
+
+    const auto heat = tracker.getChunkHeat(kNss, range, now);
+    ASSERT(heat);
+    ASSERT_APPROX_EQUAL(1.0, heat->writeOpsPerSec, 0.02);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 50), heat->lastWrittenKey);
+}
+
+TEST(ChunkWriteHeatTrackerTest, HeatHalvesAfterHalfLife) {
+    ChunkWriteHeatTracker tracker;
+    const auto range = makeRange(0, 100);
+
+    const Date_t start = Date_t::fromMillisSinceEpoch(1000);
+    const double initial = tracker.recordWrites(kNss, range, BSON("x" << 10), 1 << 20, 1, start);
+
+    const auto heat = tracker.getChunkHeat(kNss, range, start + kHalfLife);
+    ASSERT(heat);
+    ASSERT_APPROX_EQUAL(initial / 2, heat->writeBytesPerSec, initial / 1000);
+}
+
+TEST(ChunkWriteHeatTrackerTest, ChangedChunkBoundsResetHeat) {
+    ChunkWriteHeatTracker tracker;
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    tracker.recordWrites(kNss, makeRange(0, 100), BSON("x" << 10), 1000, 1, now);
+    tracker.recordWrites(kNss, makeRange(0, 100), BSON("x" << 20), 1000, 1, now);
+
+    // The chunk was split at 50
+    ASSERT(!tracker.getChunkHeat(kNss, makeRange(0, 50), now));
+
+    const double afterSplit =
+        tracker.recordWrites(kNss, makeRange(0, 50), BSON("x" << 30), 1000, 1, now);
+    const auto heat = tracker.getChunkHeat(kNss, makeRange(0, 50), now);
+    ASSERT(heat);
+    ASSERT_APPROX_EQUAL(afterSplit, heat->writeBytesPerSec, 1e-9);
+    ASSERT(!tracker.getChunkHeat(kNss, makeRange(0, 100), now));
+}
+
+TEST(ChunkWriteHeatTrackerTest, HottestChunksAreSortedAndLimited) {
+    ChunkWriteHeatTracker tracker;
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    tracker.recordWrites(kNss, makeRange(0, 10), BSON("x" << 1), 100, 1, now);
+    tracker.recordWrites(kNss, makeRange(10, 20), BSON("x" << 11), 300, 1, now);
+    tracker.recordWrites(kNss, makeRange(20, 30), BSON("x" << 21), 200, 1, now);
+    tracker.recordWrites(
+        NamespaceString("TestDB", "Other"), makeRange(0, 10), BSON("x" << 1), 1000, 1, now);
+
+    const auto hottest = tracker.getHottestChunks(kNss, 2, now);
+    ASSERT_EQ(2U, hottest.size());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 10), hottest[0].range.getMin());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 20), hottest[1].range.getMin());
+
+    tracker.clear(kNss);
+    ASSERT(tracker.getHottestChunks(kNss, 10, now).empty());
+    ASSERT_EQ(1U, tracker.getHottestChunks(NamespaceString("TestDB", "Other"), 10, now).size());
+}
+
+TEST(ChunkWriteHeatTrackerTest, SplitRequestsAreRateLimited) {
+    ChunkWriteHeatTracker tracker;
+    const auto range = makeRange(0, 100);
+    const Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+    // Unknown chunks are never split
+    ASSERT_FALSE(tracker.tryMarkSplitRequested(kNss, range, now));
+
+    tracker.recordWrites(kNss, range, BSON("x" << 10), 1000, 1, now);
+    ASSERT_TRUE(tracker.tryMarkSplitRequested(kNss, range, now));
+    ASSERT_FALSE(tracker.tryMarkSplitRequested(kNss, range, now + Seconds(1)));
+    ASSERT_TRUE(tracker.tryMarkSplitRequested(kNss, range, now + kHalfLife));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -48,11 +49,17 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -62,11 +69,130 @@ namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
 using DeleteNotification = CollectionRangeDeleter::DeleteNotification;
+using Throttle = CollectionRangeDeleter::Throttle;
+
+// Time to wait between two batches of deletions. With adaptive throttling, the minimum such time.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 0);
+
+// Whether to size deletion batches and the delays between them from the load on the node.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterAdaptiveThrottling, bool, false);
+
+// With adaptive throttling, the time to wait between two batches when the node is saturated.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBatchDelayMS, int, 1000);
+
+// With adaptive throttling, the replication lag at which the node is considered saturated.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxReplicationLagSecs, int, 10);
+
+// Dirty cache ratios between which the pressure from the cache rises from 0 to 1. These match the
+// default eviction_dirty_target and eviction_dirty_trigger of WiredTiger, above which application
+// threads are drafted into eviction.
+const double kDirtyCacheRatioLow = 0.05;
+const double kDirtyCacheRatioHigh = 0.20;
+
+// Fractions of write tickets in use between which the pressure from tickets rises from 0 to 1.
+const double kWriteTicketsInUseLow = 0.5;
+const double kWriteTicketsInUseHigh = 1.0;
 
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
 
+/**
+ * Maps 'value' linearly onto [0, 1], with 'low' and below mapping to 0 and 'high' and above to 1.
+ */
+double scalePressure(double value, double low, double high) {
+    if (high <= low)
+        return value >= high ? 1 : 0;
+    return std::min(1.0, std::max(0.0, (value - low) / (high - low)));
+}
+
+/**
+ * Keeps the progress of the range deletions in progress on this node, for serverStatus.
+ */
+class RangeDeletionProgress {
+public:
+    void recordBatch(const NamespaceString& nss,
+                     const ChunkRange& range,
+                     int numDeleted,
+                     const Throttle& throttle) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _find(lk, nss, range);
+        if (it == _entries.end()) {
+            it = _entries.insert(_entries.end(), Entry{nss, range, Date_t::now()});
+        }
+        it->numDeleted += numDeleted;
+        it->numBatches++;
+        it->lastThrottle = throttle;
+
+        _totalDeleted += numDeleted;
+        _totalBatches++;
+        _totalDelayMillis += durationCount<Milliseconds>(throttle.delay);
+    }
+
+    void finish(const NamespaceString& nss, const ChunkRange& range) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _find(lk, nss, range);
+        if (it != _entries.end()) {
+            _entries.erase(it);
+        }
+    }
+
+    void abandonAll(const NamespaceString& nss) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _entries.remove_if([&](const Entry& entry) { return entry.nss == nss; });
+    }
+
+    void report(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("totalDeleted", _totalDeleted);
+        builder->append("totalBatches", _totalBatches);
+        builder->append("totalDelayMillis", _totalDelayMillis);
+
+        BSONArrayBuilder arr(builder->subarrayStart("inProgress"));
+        for (auto const& entry : _entries) {
+            BSONObjBuilder obj(arr.subobjStart());
+            obj.append("ns", entry.nss.ns());
+            entry.range.append(&obj);
+            obj.append("startedAt", entry.startedAt);
+            obj.append("numDeleted", entry.numDeleted);
+            obj.append("numBatches", entry.numBatches);
+            obj.append("lastBatchSize", entry.lastThrottle.batchSize);
+            obj.append("lastBatchDelayMillis",
+                       durationCount<Milliseconds>(entry.lastThrottle.delay));
+            obj.append("lastPressure", entry.lastThrottle.pressure);
+        }
+        arr.done();
+    }
+
+private:
+    struct Entry {
+        NamespaceString nss;
+        ChunkRange range;
+        Date_t startedAt;
+        long long numDeleted{0};
+        long long numBatches{0};
+        Throttle lastThrottle{0, Milliseconds(0), 0};
+    };
+
+    std::list<Entry>::iterator _find(WithLock,
+                                     const NamespaceString& nss,
+                                     const ChunkRange& range) {
+        return std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) {
+            return entry.nss == nss && entry.range == range;
+        });
+    }
+
+    mutable stdx::mutex _mutex;
+    std::list<Entry> _entries;
+
+    // Cumulative, always-increasing counters over all ranges deleted on this node
+    long long _totalDeleted{0};
+    long long _totalBatches{0};
+    long long _totalDelayMillis{0};
+};
+
+const auto getRangeDeletionProgress = ServiceContext::declareDecoration<RangeDeletionProgress>();
+
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
                                                  ChunkRange const& range) {
     // Start search with newest entries by using reverse iterators
@@ -89,6 +215,60 @@ CollectionRangeDeleter::~CollectionRangeDeleter() {
     clear({ErrorCodes::InterruptedDueToReplStateChange, "Collection sharding metadata discarded"});
 }
 
+auto CollectionRangeDeleter::sampleLoadSignals(OperationContext* opCtx) -> LoadSignals {
+    LoadSignals signals;
+
+    if (auto storageEngine = opCtx->getServiceContext()->getGlobalStorageEngine()) {
+        signals.cacheDirtyRatio = storageEngine->getCacheDirtyRatio();
+    }
+
+    auto const replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet) {
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp();
+        const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp();
+        if (lastApplied.getSecs() > lastCommitted.getSecs()) {
+            signals.replicationLag = Seconds(lastApplied.getSecs() - lastCommitted.getSecs());
+        }
+    }
+
+    if (auto writeTickets = Locker::getGlobalThrottling(MODE_IX)) {
+        if (writeTickets->outof() > 0) {
+            signals.writeTicketsInUse =
+                static_cast<double>(writeTickets->used()) / writeTickets->outof();
+        }
+    }
+
+    return signals;
+}
+
+auto CollectionRangeDeleter::computeThrottle(const LoadSignals& signals, int maxToDelete)
+    -> Throttle {
+    const Milliseconds minDelay(std::max(rangeDeleterBatchDelayMS.load(), 0));
+    if (!rangeDeleterAdaptiveThrottling.load()) {
+        return {maxToDelete, minDelay, 0};
+    }
+
+    const Milliseconds maxDelay(std::max(rangeDeleterMaxBatchDelayMS.load(), 0));
+    const double maxLagSecs = std::max(rangeDeleterMaxReplicationLagSecs.load(), 1);
+
+    const double pressure = std::max(
+        {scalePressure(signals.cacheDirtyRatio, kDirtyCacheRatioLow, kDirtyCacheRatioHigh),
+         scalePressure(durationCount<Seconds>(signals.replicationLag), 0, maxLagSecs),
+         scalePressure(signals.writeTicketsInUse, kWriteTicketsInUseLow, kWriteTicketsInUseHigh)});
+
+    const int batchSize = std::max(1, static_cast<int>(maxToDelete * (1 - pressure)));
+    const Milliseconds delay = std::max(
+        minDelay,
+        minDelay + Milliseconds(static_cast<long long>(
+                       durationCount<Milliseconds>(maxDelay - minDelay) * pressure)));
+    return {batchSize, delay, pressure};
+}
+
+void CollectionRangeDeleter::reportProgress(ServiceContext* serviceContext,
+                                            BSONObjBuilder* builder) {
+    getRangeDeletionProgress(serviceContext).report(builder);
+}
+
 boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     OperationContext* opCtx,
     NamespaceString const& nss,
@@ -98,6 +278,9 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
     StatusWith<int> wrote = 0;
 
+    // Sample the load before taking any locks, so that waiting for them is not counted against it.
+    const auto throttle = computeThrottle(sampleLoadSignals(opCtx), maxToDelete);
+
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
 
@@ -119,6 +302,8 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
                        << nss.ns();
             }
 
+            getRangeDeletionProgress(opCtx->getServiceContext()).abandonAll(nss);
+
             stdx::lock_guard<stdx::mutex> lk(css->_metadataManager->_managerLock);
             css->_metadataManager->_clearAllCleanups(lk);
             return boost::none;
@@ -197,14 +382,19 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
         try {
             const auto keyPattern = scopedCollectionMetadata->getKeyPattern();
-            wrote = self->_doDeletion(opCtx, collection, keyPattern, *range, maxToDelete);
+            wrote =
+                self->_doDeletion(opCtx, collection, keyPattern, *range, throttle.batchSize);
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
         }
     }  // drop autoColl
 
+    auto& progress = getRangeDeletionProgress(opCtx->getServiceContext());
+
     if (!wrote.isOK() || wrote.getValue() == 0) {
+        progress.finish(nss, *range);
+
         if (wrote.isOK()) {
             LOG(0) << "No documents remain to delete in " << nss << " range "
                    << redact(range->toString());
@@ -271,8 +461,17 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getStatus());
     invariant(wrote.getValue() > 0);
 
+    progress.recordBatch(nss, *range, wrote.getValue(), throttle);
     notification.abandon();
-    return Date_t{};
+
+    if (throttle.delay <= Milliseconds(0)) {
+        return Date_t{};
+    }
+
+    LOG(1) << "Delaying next deletion batch in " << nss.ns() << " range "
+           << redact(range->toString()) << " by " << throttle.delay << " (pressure "
+           << throttle.pressure << ")";
+    return Date_t::now() + throttle.delay;
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -321,16 +520,18 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
-    int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
+    // Deletes the whole batch through a single index scan, rather than descending the shard key
+    // index again for every document.
+    auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+    auto manual = PlanExecutor::YIELD_MANUAL;
+    auto forward = InternalPlanner::FORWARD;
+    auto fetch = InternalPlanner::IXSCAN_FETCH;
 
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
+    auto exec = InternalPlanner::indexScan(
+        opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
+    int numDeleted = 0;
+    do {
         RecordId rloc;
         BSONObj obj;
         PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
@@ -346,6 +547,12 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         }
         invariant(PlanExecutor::ADVANCED == state);
 
+        // Deleting the document removes the index entry the scan is positioned on, and a write
+        // conflict abandons the snapshot, so the scan must be saved around the delete.
+        if (saver) {
+            obj = obj.getOwned();
+        }
+        exec->saveState();
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
             WriteUnitOfWork wuow(opCtx);
             if (saver) {
@@ -354,6 +561,7 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
             collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
+        uassertStatusOK(exec->restoreState());
     } while (++numDeleted < maxToDelete);
 
     return numDeleted;
@@ -34,13 +34,16 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
 class BSONObj;
+class BSONObjBuilder;
 class Collection;
 class OperationContext;
+class ServiceContext;
 
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
@@ -108,9 +111,57 @@ public:
         DeleteNotification notification{};
     };
 
+    /**
+     * Measures of how loaded this node is, from which the adaptive throttle sizes deletion batches.
+     */
+    struct LoadSignals {
+        // Fraction of the storage engine cache holding dirty data, see
+        // StorageEngine::getCacheDirtyRatio().
+        double cacheDirtyRatio = 0;
+
+        // How far the majority commit point trails this node's last applied optime.
+        Seconds replicationLag{0};
+
+        // Fraction of the global write tickets currently held by other operations.
+        double writeTicketsInUse = 0;
+    };
+
+    /**
+     * How many documents to delete in the next batch, and how long to wait after it before
+     * scheduling the batch after that.
+     */
+    struct Throttle {
+        int batchSize;
+        Milliseconds delay;
+
+        // Between 0 (idle) and 1 (saturated), the highest pressure among the load signals. Always 0
+        // when adaptive throttling is disabled.
+        double pressure;
+    };
+
     CollectionRangeDeleter();
     ~CollectionRangeDeleter();
 
+    /**
+     * Reads the current load signals for the node on which 'opCtx' runs. Takes no locks.
+     */
+    static LoadSignals sampleLoadSignals(OperationContext* opCtx);
+
+    /**
+     * Computes the size of the next deletion batch, of at most 'maxToDelete' documents, and the
+     * delay before the following one. With the 'rangeDeleterAdaptiveThrottling' server parameter
+     * off, this is always 'maxToDelete' documents followed by 'rangeDeleterBatchDelayMS'. With it
+     * on, the batch shrinks and the delay grows towards 'rangeDeleterMaxBatchDelayMS' as the cache
+     * fills with dirty data, the majority commit point falls behind or write tickets run out.
+     */
+    static Throttle computeThrottle(const LoadSignals& signals, int maxToDelete);
+
+    /**
+     * Appends the progress of every range deletion currently in progress on this node, and totals
+     * over all the ranges it has deleted.
+     */
+    static void reportProgress(ServiceContext* serviceContext, BSONObjBuilder* builder);
+
     //
     // All of the following members must be called only while the containing MetadataManager's lock
     // is held (or in its destructor), except cleanUpNextRange.
@@ -155,7 +206,8 @@ public:
     /**
      * If any range deletions are scheduled, deletes up to maxToDelete documents, notifying
      * watchers of ranges as they are done being deleted. It performs its own collection locking, so
-     * it must be called without locks.
+     * it must be called without locks. The batch may be smaller than maxToDelete, and the next run
+     * later than immediately, as decided by computeThrottle().
      *
      * If it should be scheduled to run again because there might be more documents to delete,
      * returns the time to begin, or boost::none otherwise.
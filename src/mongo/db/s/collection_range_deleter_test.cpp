@@ -40,11 +40,13 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -58,6 +60,12 @@ const std::string kShardKey = "_id";
 const BSONObj kShardKeyPattern = BSON(kShardKey << 1);
 const NamespaceString kAdminSysVer = NamespaceString("admin", "system.version");
 
+void setServerParameter(StringData name, StringData value) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find(name.toString());
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(value.toString()));
+}
+
 class CollectionRangeDeleterTest : public ShardServerTestFixture {
 protected:
     void setUp() override {
@@ -391,5 +399,85 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     ASSERT_FALSE(next(rangeDeleter, 1));
 }
 
+// Tests that without adaptive throttling the batch size and delay do not depend on the load.
+TEST_F(CollectionRangeDeleterTest, ThrottleIsFixedWithoutAdaptiveThrottling) {
+    CollectionRangeDeleter::LoadSignals saturated;
+    saturated.cacheDirtyRatio = 0.5;
+    saturated.replicationLag = Seconds(60);
+    saturated.writeTicketsInUse = 1;
+
+    auto throttle = CollectionRangeDeleter::computeThrottle(saturated, 128);
+    ASSERT_EQ(throttle.batchSize, 128);
+    ASSERT_EQ(throttle.delay, Milliseconds(0));
+    ASSERT_EQ(throttle.pressure, 0);
+
+    setServerParameter("rangeDeleterBatchDelayMS", "20");
+    ON_BLOCK_EXIT([] { setServerParameter("rangeDeleterBatchDelayMS", "0"); });
+    throttle = CollectionRangeDeleter::computeThrottle(saturated, 128);
+    ASSERT_EQ(throttle.batchSize, 128);
+    ASSERT_EQ(throttle.delay, Milliseconds(20));
+}
+
+// Tests that adaptive throttling shrinks batches and lengthens delays with the highest pressure.
+TEST_F(CollectionRangeDeleterTest, AdaptiveThrottleFollowsHighestPressure) {
+    setServerParameter("rangeDeleterAdaptiveThrottling", "true");
+    ON_BLOCK_EXIT([] { setServerParameter("rangeDeleterAdaptiveThrottling", "false"); });
+
+    CollectionRangeDeleter::LoadSignals idle;
+    auto throttle = CollectionRangeDeleter::computeThrottle(idle, 128);
+    ASSERT_EQ(throttle.batchSize, 128);
+    ASSERT_EQ(throttle.delay, Milliseconds(0));
+
+    // Half of the default maximum replication lag.
+    CollectionRangeDeleter::LoadSignals lagging;
+    lagging.replicationLag = Seconds(5);
+    lagging.writeTicketsInUse = 0.6;
+    throttle = CollectionRangeDeleter::computeThrottle(lagging, 128);
+    ASSERT_EQ(throttle.batchSize, 64);
+    ASSERT_EQ(throttle.delay, Milliseconds(500));
+    ASSERT_APPROX_EQUAL(throttle.pressure, 0.5, 1e-9);
+
+    // At the dirty cache eviction trigger, the deleter trickles one document at a time.
+    CollectionRangeDeleter::LoadSignals dirty;
+    dirty.cacheDirtyRatio = 0.25;
+    throttle = CollectionRangeDeleter::computeThrottle(dirty, 128);
+    ASSERT_EQ(throttle.batchSize, 1);
+    ASSERT_EQ(throttle.delay, Milliseconds(1000));
+    ASSERT_EQ(throttle.pressure, 1);
+}
+
+// Tests that the progress of a range is reported while it is being deleted.
+TEST_F(CollectionRangeDeleterTest, ReportsProgressOfRangeBeingDeleted) {
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 1));
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 2));
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 3));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    auto report = [&] {
+        BSONObjBuilder builder;
+        CollectionRangeDeleter::reportProgress(getServiceContext(), &builder);
+        return builder.obj();
+    };
+
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    auto inProgress = report()["inProgress"].Array();
+    ASSERT_EQ(inProgress.size(), 1U);
+    ASSERT_EQ(inProgress[0]["ns"].String(), kNss.ns());
+    ASSERT_BSONOBJ_EQ(inProgress[0]["min"].Obj(), BSON(kShardKey << 0));
+    ASSERT_EQ(inProgress[0]["numDeleted"].numberLong(), 3);
+    ASSERT_EQ(inProgress[0]["numBatches"].numberLong(), 2);
+
+    // The range is done.
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_TRUE(report()["inProgress"].Array().empty());
+}
+
 }  // namespace
 }  // namespace mongo
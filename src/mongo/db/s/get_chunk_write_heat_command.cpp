@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/s/chunk_write_heat_tracker.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultLimit = 100;
+
+/**
+ * Returns the write rates tracked for the chunks of a collection, which this shard owns, hottest
+ * first. Used by the balancer to prefer moving hot chunks and for diagnostics.
+ *
+ * Format:
+ * {
+ *   getChunkWriteHeat: <fully qualified namespace>,
+ *   limit: <maximum number of chunks to return, defaults to 100>
+ * }
+ */
+class GetChunkWriteHeatCommand : public BasicCommand {
+public:
+    GetChunkWriteHeatCommand() : BasicCommand("getChunkWriteHeat") {}
+
+    std::string help() const override {
+        return "Returns the decayed write rate of the hottest chunks of a collection on this "
+               "shard.\n"
+               " example: { getChunkWriteHeat : 'test.foo', limit : 10 }";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                ResourcePattern::forExactNamespace(NamespaceString(parseNs(dbname, cmdObj))),
+                ActionType::getShardVersion)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+        return Status::OK();
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return CommandHelpers::parseNsFullyQualified(cmdObj);
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+
+        long long limit = kDefaultLimit;
+        if (auto limitElem = cmdObj["limit"]) {
+            uassert(ErrorCodes::BadValue,
+                    "limit must be a positive number",
+                    limitElem.isNumber() && limitElem.safeNumberLong() > 0);
+            limit = limitElem.safeNumberLong();
+        }
+
+        // Writes are only tracked while somebody keeps asking for them, so the first request
+        // returns no heat and starts the tracking.
+        auto& heatTracker = ChunkWriteHeatTracker::get(opCtx);
+        const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+        heatTracker.markHeatRequested(now);
+        const auto chunks = heatTracker.getHottestChunks(nss, limit, now);
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        const auto metadata = CollectionShardingState::get(opCtx, nss)->getMetadata(opCtx);
+
+        result.append("ns", nss.ns());
+
+        BSONArrayBuilder chunksArr(result.subarrayStart("chunks"));
+        if (metadata) {
+            for (const auto& chunkHeat : chunks) {
+                // Skip the ranges, which are no longer chunks owned by this shard
+                ChunkType chunk;
+                chunk.setMin(chunkHeat.range.getMin());
+                chunk.setMax(chunkHeat.range.getMax());
+                if (!metadata->checkChunkIsValid(chunk).isOK()) {
+                    continue;
+                }
+
+                BSONObjBuilder chunkBuilder(chunksArr.subobjStart());
+                chunkHeat.append(&chunkBuilder);
+                chunkBuilder.doneFast();
+            }
+        }
+        chunksArr.doneFast();
+
+        return true;
+    }
+
+} getChunkWriteHeatCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/client/read_preference.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
@@ -66,6 +68,14 @@ const char kRecvChunkAbort[] = "_recvChunkAbort";
 
 const int kMaxObjectPerChunk{250000};
 
+// Upper bound on the number of record ids a clone stream claims at a time, so that documents are
+// handed out to concurrent streams in reasonably small pieces
+const std::size_t kMaxCloneLocsClaimedAtOnce{128};
+
+// Maximum size of the documents, which the donor reads ahead of the recipient's _migrateClone
+// requests. Zero disables the read-ahead.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneReadAheadBytes, int, 16 * 1024 * 1024);
+
 bool isInRange(const BSONObj& obj,
                const BSONObj& min,
                const BSONObj& max,
@@ -221,6 +231,15 @@ Status MigrationChunkClonerSourceLegacy::startClone(OperationContext* opCtx) {
         return storeCurrentLocsStatus;
     }
 
+    // Start pre-reading the documents so that the first batches are ready by the time the
+    // recipient asks for them
+    const int readAheadBytes = migrateCloneReadAheadBytes.load();
+    if (readAheadBytes > 0) {
+        const uint64_t maxBufferedBytes = readAheadBytes;
+        _readAheadThread =
+            stdx::thread([this, maxBufferedBytes] { _readAheadThreadMain(maxBufferedBytes); });
+    }
+
     // Tell the recipient shard to start cloning
     BSONObjBuilder cmdBuilder;
     StartChunkCloneRequest::appendAsCommand(&cmdBuilder,
@@ -276,7 +295,8 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
 
         stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-        const std::size_t cloneLocsRemaining = _cloneLocs.size();
+        const std::size_t cloneLocsRemaining =
+            _cloneLocs.size() + _numCloneLocsInFlight + _readAheadDocs.size();
 
         log() << "moveChunk data transfer progress: " << redact(res) << " mem used: " << _memoryUsed
               << " documents remaining to clone: " << cloneLocsRemaining;
@@ -459,7 +479,7 @@ uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
     return std::min(static_cast<uint64_t>(BSONObjMaxUserSize),
-                    _averageObjectSizeForCloneLocs * _cloneLocs.size());
+                    _readAheadBytes + _averageObjectSizeForCloneLocs * _cloneLocs.size());
 }
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
@@ -471,35 +491,86 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Use the builder size instead of accumulating the document sizes directly so that we take
+    // into consideration the overhead of BSONArray indices.
+    auto fitsInBatch = [arrBuilder](const BSONObj& doc) {
+        return !arrBuilder->arrSize() ||
+            (arrBuilder->len() + doc.objsize() + 1024) <= BSONObjMaxUserSize;
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    bool batchFull = false;
+    while (!batchFull) {
+        // Documents which have already been read ahead go out first
+        while (!_readAheadDocs.empty()) {
+            const BSONObj& doc = _readAheadDocs.front();
+            if (!fitsInBatch(doc)) {
+                batchFull = true;
+                break;
+            }
 
-    std::set<RecordId>::iterator it;
+            arrBuilder->append(doc);
+            _readAheadBytes -= doc.objsize();
+            _readAheadDocs.pop_front();
+            _cloneProgressCV.notify_all();
+        }
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
-        // We must always make progress in this method by at least one document because empty return
-        // indicates there is no more initial clone data.
-        if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+        // We must always make progress in this method by at least one document because empty
+        // return indicates there is no more initial clone data.
+        if (batchFull || (arrBuilder->arrSize() && tracker.intervalHasElapsed())) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+        const auto recordIds = _claimCloneLocs(lk, BSONObjMaxUserSize - arrBuilder->len());
+        if (recordIds.empty()) {
+            if (arrBuilder->arrSize() || (!_numCloneLocsInFlight && _readAheadDocs.empty())) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            // Some other stream is still reading documents, which it has claimed, and might put
+            // part of them back. It already holds the collection lock, so it is safe to wait.
+            opCtx->waitForConditionOrInterrupt(_cloneProgressCV, lk, [&] {
+                return !_numCloneLocsInFlight || !_readAheadDocs.empty() || !_cloneLocs.empty();
+            });
+            continue;
         }
-    }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+        // Whatever was not appended to the batch, including on error, goes back to _cloneLocs
+        auto it = recordIds.cbegin();
+        auto releaseGuard = MakeGuard([&] {
+            if (!lk.owns_lock()) {
+                lk.lock();
+            }
+            _releaseClaimedCloneLocs(lk, recordIds.size(), it, recordIds.cend());
+        });
+
+        lk.unlock();
+
+        for (; it != recordIds.cend(); ++it) {
+            if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+                batchFull = true;
+                break;
+            }
+
+            Snapshotted<BSONObj> doc;
+            if (collection->findDoc(opCtx, *it, &doc)) {
+                if (!fitsInBatch(doc.value())) {
+                    batchFull = true;
+                    break;
+                }
+
+                arrBuilder->append(doc.value());
+            }
+        }
+
+        lk.lock();
+    }
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
     // around
-    if (_cloneLocs.empty() && _deleteNotifyExec) {
+    if (_cloneLocs.empty() && !_numCloneLocsInFlight && _readAheadDocs.empty() &&
+        _deleteNotifyExec) {
         // We have a different OperationContext than when we created the PlanExecutor, so need to
         // manually destroy it ourselves.
         _deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
@@ -518,6 +589,8 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* opCtx,
 
     // All clone data must have been drained before starting to fetch the incremental changes
     invariant(_cloneLocs.empty());
+    invariant(!_numCloneLocsInFlight);
+    invariant(_readAheadDocs.empty());
 
     long long docSizeAccumulator = 0;
 
@@ -530,11 +603,15 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* opCtx,
 }
 
 void MigrationChunkClonerSourceLegacy::_cleanup(OperationContext* opCtx) {
+    _stopReadAhead();
+
     {
         stdx::lock_guard<stdx::mutex> sl(_mutex);
         _state = kDone;
         _reload.clear();
         _deleted.clear();
+        _readAheadDocs.clear();
+        _readAheadBytes = 0;
     }
     // Implicitly resets _deleteNotifyExec to avoid possible invariant failure
     // in on destruction of MigrationChunkClonerSourceLegacy, and will always
@@ -709,6 +786,112 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     return Status::OK();
 }
 
+std::vector<RecordId> MigrationChunkClonerSourceLegacy::_claimCloneLocs(WithLock,
+                                                                       uint64_t maxBytes) {
+    const std::size_t numToClaim = std::min(
+        kMaxCloneLocsClaimedAtOnce,
+        std::max<std::size_t>(1, maxBytes / std::max<uint64_t>(1, _averageObjectSizeForCloneLocs)));
+
+    std::vector<RecordId> recordIds;
+    auto it = _cloneLocs.begin();
+    while (it != _cloneLocs.end() && recordIds.size() < numToClaim) {
+        recordIds.push_back(*it);
+        it = _cloneLocs.erase(it);
+    }
+
+    _numCloneLocsInFlight += recordIds.size();
+    return recordIds;
+}
+
+void MigrationChunkClonerSourceLegacy::_releaseClaimedCloneLocs(
+    WithLock,
+    std::size_t numClaimed,
+    std::vector<RecordId>::const_iterator unreadBegin,
+    std::vector<RecordId>::const_iterator unreadEnd) {
+    _cloneLocs.insert(unreadBegin, unreadEnd);
+
+    invariant(_numCloneLocsInFlight >= numClaimed);
+    _numCloneLocsInFlight -= numClaimed;
+    _cloneProgressCV.notify_all();
+}
+
+void MigrationChunkClonerSourceLegacy::_readAheadThreadMain(uint64_t maxBufferedBytes) {
+    Client::initThread("migrateCloneReadAhead");
+    auto opCtx = cc().makeOperationContext();
+
+    try {
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _cloneProgressCV.wait(lk, [&] {
+                    return _readAheadShutdown || _cloneLocs.empty() ||
+                        _readAheadBytes < maxBufferedBytes;
+                });
+
+                if (_readAheadShutdown || _cloneLocs.empty()) {
+                    return;
+                }
+            }
+
+            // The record ids are only claimed while holding the collection lock, so that a clone
+            // stream waiting for them to be read never waits on a lock acquisition
+            AutoGetCollection autoColl(opCtx.get(), _args.getNss(), MODE_IS);
+            Collection* const collection = autoColl.getCollection();
+            if (!collection) {
+                return;
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            if (_readAheadShutdown || _readAheadBytes >= maxBufferedBytes) {
+                continue;
+            }
+
+            const auto recordIds = _claimCloneLocs(lk, maxBufferedBytes - _readAheadBytes);
+
+            auto it = recordIds.cbegin();
+            auto releaseGuard = MakeGuard([&] {
+                if (!lk.owns_lock()) {
+                    lk.lock();
+                }
+                _releaseClaimedCloneLocs(lk, recordIds.size(), it, recordIds.cend());
+            });
+
+            lk.unlock();
+
+            std::vector<BSONObj> docs;
+            docs.reserve(recordIds.size());
+            for (; it != recordIds.cend(); ++it) {
+                Snapshotted<BSONObj> doc;
+                if (collection->findDoc(opCtx.get(), *it, &doc)) {
+                    docs.push_back(doc.value().getOwned());
+                }
+            }
+
+            lk.lock();
+
+            for (auto& doc : docs) {
+                _readAheadBytes += doc.objsize();
+                _readAheadDocs.push_back(std::move(doc));
+            }
+        }
+    } catch (const DBException& ex) {
+        // The clone streams will read the remaining documents themselves
+        LOG(1) << "Migration clone read-ahead stopped " << causedBy(redact(ex));
+    }
+}
+
+void MigrationChunkClonerSourceLegacy::_stopReadAhead() {
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+        _readAheadShutdown = true;
+        _cloneProgressCV.notify_all();
+    }
+
+    if (_readAheadThread.joinable()) {
+        _readAheadThread.join();
+    }
+}
+
 void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* opCtx,
                                              Database* db,
                                              std::list<BSONObj>* docIdList,
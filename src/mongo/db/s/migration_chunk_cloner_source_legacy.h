@@ -28,8 +28,10 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -41,8 +43,11 @@
 #include "mongo/db/s/session_catalog_migration_source.h"
 #include "mongo/s/request_types/move_chunk_request.h"
 #include "mongo/s/shard_key_pattern.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -116,6 +121,11 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * It is safe to call this method concurrently from multiple clone streams. Documents already
+     * pre-read by the read-ahead thread are returned first. An empty batch is only returned once
+     * every record id has been handed out to some stream, so a stream may block briefly while
+     * another one finishes reading the documents it has claimed.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* opCtx,
@@ -166,6 +176,34 @@ private:
      */
     Status _storeCurrentLocs(OperationContext* opCtx);
 
+    /**
+     * Removes from _cloneLocs as many record ids as are estimated to fit in 'maxBytes' (at least
+     * one, if any are left) and accounts for them as in flight. The caller must read the
+     * documents and then call _releaseClaimedCloneLocs.
+     */
+    std::vector<RecordId> _claimCloneLocs(WithLock, uint64_t maxBytes);
+
+    /**
+     * Puts back into _cloneLocs the claimed record ids, which were not read, and releases the
+     * in-flight accounting for 'numClaimed' record ids.
+     */
+    void _releaseClaimedCloneLocs(WithLock,
+                                  std::size_t numClaimed,
+                                  std::vector<RecordId>::const_iterator unreadBegin,
+                                  std::vector<RecordId>::const_iterator unreadEnd);
+
+    /**
+     * Body of the thread, which reads documents ahead of the _migrateClone requests of the
+     * recipient into _readAheadDocs, until either all record ids have been claimed or the cloner
+     * is cleaned up.
+     */
+    void _readAheadThreadMain(uint64_t maxBufferedBytes);
+
+    /**
+     * Signals the read-ahead thread to exit and joins it. Must be called without any locks.
+     */
+    void _stopReadAhead();
+
     /**
      * Insert items from docIdList to a new array with the given fieldName in the given builder. If
      * explode is true, the inserted object will be the full version of the document. Note that
@@ -216,6 +254,24 @@ private:
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneLocs{0};
 
+    // Number of record ids removed from _cloneLocs whose documents are still being read by a clone
+    // stream or by the read-ahead thread (initial clone)
+    std::size_t _numCloneLocsInFlight{0};
+
+    // Documents pre-read by the read-ahead thread, which have not yet been returned to the
+    // recipient, and their total size (initial clone)
+    std::deque<BSONObj> _readAheadDocs;
+    uint64_t _readAheadBytes{0};
+
+    // Set when the read-ahead thread must exit
+    bool _readAheadShutdown{false};
+
+    // Signalled whenever _numCloneLocsInFlight, _readAheadDocs or _readAheadShutdown change
+    stdx::condition_variable _cloneProgressCV;
+
+    // Thread, which reads documents ahead of the recipient's requests (initial clone)
+    stdx::thread _readAheadThread;
+
     // List of _id of documents that were modified that must be re-cloned (xfer mods)
     std::list<BSONObj> _reload;
 
@@ -30,6 +30,7 @@
 
 #include "mongo/client/remote_command_targeter_mock.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
@@ -37,6 +38,7 @@
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -295,6 +297,88 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetched) {
     futureCommit.timed_get(kFutureTimeout);
 }
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, ConcurrentCloneStreamsFetchEachDocumentOnce) {
+    const int kNumDocs = 1000;
+    const int kNumStreams = 4;
+
+    std::vector<BSONObj> contents;
+    for (int i = 0; i < kNumDocs; i++) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 900))),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext()));
+        futureStartClone.timed_get(kFutureTimeout);
+    }
+
+    // Each stream keeps asking for batches until it receives an empty one, the same way the
+    // recipient's fetcher threads do
+    std::vector<std::vector<int>> fetchedIds(kNumStreams);
+    std::vector<stdx::thread> streams;
+    for (int i = 0; i < kNumStreams; i++) {
+        streams.emplace_back([&, i] {
+            Client::initThread(str::stream() << "cloneStream-" << i);
+            auto opCtx = cc().makeOperationContext();
+
+            while (true) {
+                AutoGetCollection autoColl(opCtx.get(), kNss, MODE_IS);
+
+                BSONArrayBuilder arrBuilder;
+                ASSERT_OK(
+                    cloner.nextCloneBatch(opCtx.get(), autoColl.getCollection(), &arrBuilder));
+                if (!arrBuilder.arrSize()) {
+                    break;
+                }
+
+                for (const auto& elem : arrBuilder.arr()) {
+                    fetchedIds[i].push_back(elem.Obj()["_id"].numberInt());
+                }
+            }
+        });
+    }
+
+    for (auto& stream : streams) {
+        stream.join();
+    }
+
+    std::vector<int> allIds;
+    for (const auto& ids : fetchedIds) {
+        allIds.insert(allIds.end(), ids.begin(), ids.end());
+    }
+    std::sort(allIds.begin(), allIds.end());
+
+    ASSERT_EQ(800U, allIds.size());
+    for (int i = 0; i < 800; i++) {
+        ASSERT_EQ(100 + i, allIds[i]);
+    }
+
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+
+        BSONObjBuilder modsBuilder;
+        ASSERT_OK(cloner.nextModsBatch(operationContext(), autoColl.getDb(), &modsBuilder));
+    }
+
+    auto futureCommit = launchAsync([&]() {
+        onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+    });
+
+    ASSERT_OK(cloner.commitClone(operationContext()));
+    futureCommit.timed_get(kFutureTimeout);
+}
+
 TEST_F(MigrationChunkClonerSourceLegacyTest, CollectionNotFound) {
     MigrationChunkClonerSourceLegacy cloner(
         createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200))),
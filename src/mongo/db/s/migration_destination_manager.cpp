@@ -51,6 +51,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -62,6 +63,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -69,6 +71,12 @@ namespace {
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
+// Number of concurrent _migrateClone streams used to fetch the initial clone data from the donor
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneFetchStreams, int, 4);
+
+// Number of threads, which insert the fetched batches of documents in parallel
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionThreads, int, 4);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 // Note: Even though we're setting UNSET here,
                                                 // kMajority implies JOURNAL if journaling is
@@ -302,6 +310,11 @@ void MigrationDestinationManager::report(BSONObjBuilder& b,
     bb.append("clonedBytes", _clonedBytes);
     bb.append("catchup", _numCatchup);
     bb.append("steady", _numSteady);
+    if (_cloneMillis) {
+        bb.append("cloneStreams", _cloneStreams);
+        bb.append("cloneMillis", _cloneMillis);
+        bb.append("clonedBytesPerSec", _clonedBytes * 1000 / _cloneMillis);
+    }
     bb.done();
 }
 
@@ -346,6 +359,8 @@ Status MigrationDestinationManager::start(const NamespaceString& nss,
 
     _numCloned = 0;
     _clonedBytes = 0;
+    _cloneStreams = 0;
+    _cloneMillis = 0;
     _numCatchup = 0;
     _numSteady = 0;
 
@@ -373,48 +388,109 @@ Status MigrationDestinationManager::start(const NamespaceString& nss,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
-
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
-            }
-        } catch (...) {
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numFetchers,
+    int numInserters) {
+    invariant(numFetchers > 0);
+    invariant(numInserters > 0);
+
+    ProducerConsumerQueue<BSONObj> batches(numInserters);
+
+    // Number of fetcher threads (other than the calling one), which have not yet received an empty
+    // batch from the donor
+    stdx::mutex fetchersMutex;
+    stdx::condition_variable fetchersDoneCV;
+    int numActiveFetchers = numFetchers - 1;
+
+    // A failure on any of the helper threads interrupts the calling thread, which is responsible
+    // for shutting down the queue and joining the helpers
+    auto interruptCaller = [opCtx](StringData what) {
+        const auto status = exceptionToStatus();
+        {
             stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+            opCtx->getServiceContext()->killOperation(opCtx, status.code());
+        }
+        log() << what << " failed " << causedBy(redact(status));
+    };
+
+    std::vector<stdx::thread> threads;
+    auto threadsJoinGuard = MakeGuard([&] {
+        batches.closeConsumerEnd();
+        for (auto& thread : threads) {
+            thread.join();
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
-        batches.closeProducerEnd();
-        inserterThread.join();
     });
 
+    for (int i = 0; i < numInserters; i++) {
+        threads.emplace_back([&, i] {
+            Client::initThreadIfNotAlready(str::stream() << "chunkInserter-" << i);
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    auto arr = nextBatch["objects"].Obj();
+                    if (arr.isEmpty()) {
+                        return;
+                    }
+                    insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
+                }
+            } catch (...) {
+                interruptCaller("Batch insertion");
+            }
+        });
+    }
+
+    for (int i = 1; i < numFetchers; i++) {
+        threads.emplace_back([&, i] {
+            Client::initThreadIfNotAlready(str::stream() << "chunkFetcher-" << i);
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<stdx::mutex> lk(fetchersMutex);
+                --numActiveFetchers;
+                fetchersDoneCV.notify_all();
+            });
+            try {
+                while (true) {
+                    auto res = fetchBatchFn(fetcherOpCtx.get());
+                    if (res["objects"].Obj().isEmpty()) {
+                        return;
+                    }
+                    batches.push(res.getOwned(), fetcherOpCtx.get());
+                }
+            } catch (...) {
+                interruptCaller("Batch fetching");
+            }
+        });
+    }
+
     while (true) {
         opCtx->checkForInterrupt();
 
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
-        auto arr = res["objects"].Obj();
-        if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
-            opCtx->checkForInterrupt();
+        if (res["objects"].Obj().isEmpty()) {
             break;
         }
+        batches.push(res.getOwned(), opCtx);
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(fetchersMutex);
+        opCtx->waitForConditionOrInterrupt(
+            fetchersDoneCV, lk, [&] { return numActiveFetchers == 0; });
     }
+
+    // Every inserter stops after draining the queue up to an empty batch
+    for (int i = 0; i < numInserters; i++) {
+        batches.push(BSON("objects" << BSONArray()), opCtx);
+    }
+
+    threadsJoinGuard.Dismiss();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    opCtx->checkForInterrupt();
 }
 
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
@@ -817,26 +893,50 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
             }
         };
 
+        // Each clone stream uses its own pooled connection, so that several batches can be in
+        // flight at the same time
         auto fetchBatchFn = [&](OperationContext* opCtx) {
+            ScopedDbConnection cloneConn(fromShardConnString);
             BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
-                conn.done();
+            if (!cloneConn->runCommand("admin",
+                                       migrateCloneRequest,
+                                       res)) {  // gets array of objects to copy, in disk order
+                cloneConn.done();
                 const std::string errMsg = str::stream() << "_migrateClone failed: "
                                                          << redact(res.toString());
                 uasserted(50747, errMsg);
             }
+            cloneConn.done();
             return res;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        const int numFetchers = std::max(1, migrateCloneFetchStreams.load());
+        const int numInserters = std::max(1, migrateCloneInsertionThreads.load());
+
+        Timer cloneTimer;
+        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn, numFetchers, numInserters);
+
+        long long numCloned;
+        long long clonedBytes;
+        long long cloneMillis;
+        {
+            stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+            _cloneStreams = numFetchers;
+            _cloneMillis = cloneTimer.millis();
+            numCloned = _numCloned;
+            clonedBytes = _clonedBytes;
+            cloneMillis = _cloneMillis;
+        }
+
+        log() << "Cloned " << numCloned << " documents (" << clonedBytes << " bytes) of "
+              << _nss.ns() << " in " << cloneMillis << "ms using " << numFetchers
+              << " streams and " << numInserters << " insertion threads";
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
 
         if (MONGO_FAIL_POINT(failMigrationLeaveOrphans)) {
-            setStateFail(str::stream() << "failing migration after cloning " << _numCloned
+            setStateFail(str::stream() << "failing migration after cloning " << numCloned
                                        << " docs due to failMigrationLeaveOrphans failpoint");
             return;
         }
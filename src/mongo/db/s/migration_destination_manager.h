@@ -118,12 +118,17 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Batches are fetched by 'numFetchers' concurrent streams,
+     * each of which stops once it receives an empty batch, and are inserted by 'numInserters'
+     * threads. When 'numFetchers' is greater than one, 'fetchBatchFn' must be safe to call
+     * concurrently.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numFetchers = 1,
+        int numInserters = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
@@ -224,6 +229,8 @@ private:
 
     long long _numCloned{0};
     long long _clonedBytes{0};
+    int _cloneStreams{0};
+    long long _cloneMillis{0};
     long long _numCatchup{0};
     long long _numSteady{0};
 
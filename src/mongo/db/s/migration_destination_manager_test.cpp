@@ -104,6 +104,53 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that batches fetched over several concurrent streams are all inserted by the parallel
+// inserters.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithMultipleStreams) {
+    const int kNumBatches = 50;
+
+    stdx::mutex mutex;
+    int nextBatch = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        int batch;
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            batch = nextBatch++;
+        }
+
+        BSONArrayBuilder arrayBuilder;
+        if (batch < kNumBatches) {
+            arrayBuilder.append(createDocument(2 * batch));
+            arrayBuilder.append(createDocument(2 * batch + 1));
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    std::vector<int> insertedIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        while (docs.more()) {
+            const int id = docs.next().Obj()["_id"].numberInt();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            insertedIds.push_back(id);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4 /* numFetchers */, 3 /* numInserters */);
+
+    std::sort(insertedIds.begin(), insertedIds.end());
+
+    ASSERT_EQ(2U * kNumBatches, insertedIds.size());
+    for (int i = 0; i < 2 * kNumBatches; i++) {
+        ASSERT_EQ(i, insertedIds[i]);
+    }
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
@@ -34,6 +34,8 @@
 
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/s/chunk_splitter.h"
+#include "mongo/db/s/chunk_write_heat_tracker.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/database_sharding_state.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -152,6 +154,47 @@ bool shouldSplitChunk(OperationContext* opCtx,
     return chunk.shouldSplit(balancerConfig->getMaxChunkSizeBytes(), minIsInf, maxIsInf);
 }
 
+/**
+ * Accounts for a write of 'dataWritten' bytes to 'chunk' in its write heat, and schedules a split
+ * of the chunk if its write rate makes it hot. The writes are accumulated on the chunk and only
+ * passed on to the chunk write heat tracker once per sample interval, so that writers to a hot
+ * chunk do not serialize on the tracker. Does nothing unless something consumes the write rates.
+ */
+void trackChunkWriteHeat(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         Chunk* chunk,
+                         const BSONObj& shardKey,
+                         long dataWritten) {
+    auto& heatTracker = ChunkWriteHeatTracker::get(opCtx);
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+    if (!heatTracker.isTrackingEnabled(now)) {
+        return;
+    }
+
+    chunk->addPendingWriteHeat(dataWritten);
+    const auto pending =
+        chunk->takePendingWriteHeat(now, ChunkWriteHeatTracker::getSampleInterval());
+    if (!pending) {
+        return;
+    }
+
+    const ChunkRange chunkRange(chunk->getMin(), chunk->getMax());
+    const double writeBytesPerSec = heatTracker.recordWrites(
+        nss, chunkRange, shardKey, pending->bytes, pending->numWrites, now);
+
+    const double hotChunkThreshold = ChunkWriteHeatTracker::getHotChunkSplitThreshold();
+    if (hotChunkThreshold > 0 && writeBytesPerSec >= hotChunkThreshold &&
+        heatTracker.tryMarkSplitRequested(nss, chunkRange, now)) {
+        try {
+            ChunkSplitter::get(opCtx).trySplitting(
+                nss, chunk->getMin(), chunk->getMax(), chunk->getBytesWritten());
+        } catch (const DBException& ex) {
+            LOG(1) << "Unable to schedule split of hot chunk " << redact(chunkRange.toString())
+                   << " of " << nss << causedBy(redact(ex));
+        }
+    }
+}
+
 /**
  * If the collection is sharded, finds the chunk that contains the specified document and increments
  * the size tracked for that chunk by the specified amount of data written, in bytes. Returns the
@@ -181,6 +224,10 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     auto chunk = chunkManager.findIntersectingChunkWithSimpleCollation(shardKey);
     chunk.addBytesWritten(dataWritten);
 
+    // Track the write rate of the chunk as well, so that chunks which receive a disproportionate
+    // share of the writes can be split and moved before they become large
+    trackChunkWriteHeat(opCtx, chunkManager.getns(), &chunk, shardKey, dataWritten);
+
     // If the chunk becomes too large, then we call the ChunkSplitter to schedule a split. Then, we
     // reset the tracking for that chunk to 0.
     if (shouldSplitChunk(opCtx, shardKeyPattern, chunk)) {
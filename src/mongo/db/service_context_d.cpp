@@ -36,6 +36,7 @@
 #include "mongo/base/initializer.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/concurrency/locker_noop.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context_registrar.h"
 #include "mongo/db/service_entry_point_mongod.h"
@@ -62,11 +63,48 @@ ServiceContextRegistrar serviceContextCreator([]() {
     service->setPreciseClockSource(std::make_unique<SystemClockSource>());
     return service;
 });
+
+// An idle locker which each client keeps between operations, so that its next operation does not
+// have to allocate and initialize a new one.
+const auto cachedLocker = Client::declareDecoration<std::unique_ptr<Locker>>();
+
+bool resetLockerForReuse(Locker* locker) {
+    if (auto defaultLocker = dynamic_cast<DefaultLockerImpl*>(locker)) {
+        return defaultLocker->resetForReuse();
+    }
+    if (auto mmapv1Locker = dynamic_cast<MMAPV1LockerImpl*>(locker)) {
+        return mmapv1Locker->resetForReuse();
+    }
+    return false;
+}
+
+/**
+ * Takes the locker of each finished operation and keeps it on the operation's client, unless the
+ * client already has one or the locker is not idle.
+ */
+class LockerCacheObserver final : public ServiceContext::ClientObserver {
+public:
+    void onCreateClient(Client* client) final {}
+    void onDestroyClient(Client* client) final {}
+    void onCreateOperationContext(OperationContext* opCtx) final {}
+
+    void onDestroyOperationContext(OperationContext* opCtx) final {
+        auto& cached = cachedLocker(opCtx->getClient());
+        if (cached || !opCtx->lockState() || !resetLockerForReuse(opCtx->lockState())) {
+            return;
+        }
+
+        // The operation context still needs a locker for the rest of its destruction.
+        cached = opCtx->swapLockState(stdx::make_unique<LockerNoop>());
+    }
+};
 }  // namespace
 
 extern bool _supportsDocLocking;
 
-ServiceContextMongoD::ServiceContextMongoD() = default;
+ServiceContextMongoD::ServiceContextMongoD() {
+    registerClientObserver(stdx::make_unique<LockerCacheObserver>());
+}
 
 ServiceContextMongoD::~ServiceContextMongoD() = default;
 
@@ -281,7 +319,10 @@ std::unique_ptr<OperationContext> ServiceContextMongoD::_newOpCtx(Client* client
     invariant(&cc() == client);
     auto opCtx = stdx::make_unique<OperationContext>(client, opId);
 
-    if (isMMAPV1()) {
+    if (auto& locker = cachedLocker(client)) {
+        locker->updateThreadIdToCurrentThread();
+        opCtx->setLockState(std::move(locker));
+    } else if (isMMAPV1()) {
         opCtx->setLockState(stdx::make_unique<MMAPV1LockerImpl>());
     } else {
         opCtx->setLockState(stdx::make_unique<DefaultLockerImpl>());
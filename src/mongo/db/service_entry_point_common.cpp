@@ -934,12 +934,53 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
     curop->setNS_inlock(nss.ns());
 }
 
+/**
+ * If the client allowed an exhaust reply to the given find or getMore, and the reply left the
+ * cursor open, returns the getMore to run next on the client's behalf. The getMore keeps the batch
+ * size and the logical session of the original request.
+ */
+boost::optional<BSONObj> makeExhaustGetMore(const OpMsgRequest& request, const Message& response) {
+    const auto commandName = request.getCommandName();
+    if (commandName != "find"_sd && commandName != "getMore"_sd) {
+        return boost::none;
+    }
+
+    // Cursors opened in a multi-document transaction have to be drained by the client.
+    if (request.body.hasField(OperationSessionInfo::kTxnNumberFieldName)) {
+        return boost::none;
+    }
+
+    const auto reply = OpMsg::parse(response).body;
+    const auto cursor = reply["cursor"];
+    if (!reply["ok"].trueValue() || cursor.type() != Object) {
+        return boost::none;
+    }
+
+    const auto cursorId = cursor.Obj()["id"].safeNumberLong();
+    if (cursorId == 0) {
+        return boost::none;
+    }
+
+    const NamespaceString nss(cursor.Obj()["ns"].valueStringData());
+    BSONObjBuilder getMore;
+    getMore.append("getMore", cursorId);
+    getMore.append("collection", nss.coll());
+    if (auto batchSize = request.body["batchSize"]) {
+        getMore.append(batchSize);
+    }
+    if (auto lsid = request.body[OperationSessionInfo::kSessionIdFieldName]) {
+        getMore.append(lsid);
+    }
+    getMore.append("$db", request.getDatabase());
+    return getMore.obj();
+}
+
 DbResponse runCommands(OperationContext* opCtx,
                        const Message& message,
                        const ServiceEntryPointCommon::Hooks& behaviors) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    OpMsgRequest request;
     [&] {
-        OpMsgRequest request;
         try {  // Parse.
             request = rpc::opMsgRequestFromAnyProtocol(message);
         } catch (const DBException& ex) {
@@ -1021,7 +1062,17 @@ DbResponse runCommands(OperationContext* opCtx,
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
+    // An OP_MSG client which allows exhaust replies gets the following batches of its cursor
+    // streamed without having to ask for them. The last reply of the stream is the one without
+    // the moreToCome flag.
+    if (OpMsg::isFlagSet(message, OpMsg::kExhaustSupported)) {
+        if (auto nextInvocation = makeExhaustGetMore(request, response)) {
+            CurOp::get(opCtx)->debug().exhaust = true;
+            OpMsg::setFlag(&response, OpMsg::kMoreToCome);
+            return DbResponse{std::move(response), {}, std::move(nextInvocation)};
+        }
+    }
+
     return DbResponse{std::move(response)};
 }
 
@@ -34,7 +34,6 @@
 #include "mongo/db/stats/counters.h"
 
 #include "mongo/db/jsobj.h"
-#include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -44,38 +43,38 @@ using std::endl;
 OpCounters::OpCounters() {}
 
 void OpCounters::gotInserts(int n) {
-    RARELY _checkWrap();
-    _insert.fetchAndAdd(n);
+    _checkWrapRarely();
+    _insert.add(n);
 }
 
 void OpCounters::gotInsert() {
-    RARELY _checkWrap();
-    _insert.fetchAndAdd(1);
+    _checkWrapRarely();
+    _insert.add(1);
 }
 
 void OpCounters::gotQuery() {
-    RARELY _checkWrap();
-    _query.fetchAndAdd(1);
+    _checkWrapRarely();
+    _query.add(1);
 }
 
 void OpCounters::gotUpdate() {
-    RARELY _checkWrap();
-    _update.fetchAndAdd(1);
+    _checkWrapRarely();
+    _update.add(1);
 }
 
 void OpCounters::gotDelete() {
-    RARELY _checkWrap();
-    _delete.fetchAndAdd(1);
+    _checkWrapRarely();
+    _delete.add(1);
 }
 
 void OpCounters::gotGetMore() {
-    RARELY _checkWrap();
-    _getmore.fetchAndAdd(1);
+    _checkWrapRarely();
+    _getmore.add(1);
 }
 
 void OpCounters::gotCommand() {
-    RARELY _checkWrap();
-    _command.fetchAndAdd(1);
+    _checkWrapRarely();
+    _command.add(1);
 }
 
 void OpCounters::gotOp(int op, bool isCommand) {
@@ -106,12 +105,19 @@ void OpCounters::gotOp(int op, bool isCommand) {
     }
 }
 
+void OpCounters::_checkWrapRarely() {
+    // Like RARELY, but the call count is kept per thread so that it does not become a contended
+    // cache line of its own.
+    static thread_local unsigned calls = 0;
+    if (++calls % 128 == 0)
+        _checkWrap();
+}
+
 void OpCounters::_checkWrap() {
-    const unsigned MAX = 1 << 30;
+    const long long MAX = 1 << 30;
 
-    bool wrap = _insert.loadRelaxed() > MAX || _query.loadRelaxed() > MAX ||
-        _update.loadRelaxed() > MAX || _delete.loadRelaxed() > MAX ||
-        _getmore.loadRelaxed() > MAX || _command.loadRelaxed() > MAX;
+    bool wrap = _insert.load() > MAX || _query.load() > MAX || _update.load() > MAX ||
+        _delete.load() > MAX || _getmore.load() > MAX || _command.load() > MAX;
 
     if (wrap) {
         _insert.store(0);
@@ -125,80 +131,58 @@ void OpCounters::_checkWrap() {
 
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.append("insert", static_cast<int>(_insert.load()));
+    b.append("query", static_cast<int>(_query.load()));
+    b.append("update", static_cast<int>(_update.load()));
+    b.append("delete", static_cast<int>(_delete.load()));
+    b.append("getmore", static_cast<int>(_getmore.load()));
+    b.append("command", static_cast<int>(_command.load()));
     return b.obj();
 }
 
 void NetworkCounter::hitPhysicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesIn.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _physicalBytesIn.store(bytes);
-    } else {
-        _physicalBytesIn.fetchAndAdd(bytes);
-    }
+    _physicalBytesIn.add(bytes);
 }
 
 void NetworkCounter::hitPhysicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _physicalBytesOut.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _physicalBytesOut.store(bytes);
-    } else {
-        _physicalBytesOut.fetchAndAdd(bytes);
-    }
+    _physicalBytesOut.add(bytes);
 }
 
 void NetworkCounter::hitLogicalIn(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _together.logicalBytesIn.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _together.logicalBytesIn.store(bytes);
-        // The requests field only gets incremented here (and not in hitPhysical) because the
-        // hitLogical and hitPhysical are each called for each operation. Incrementing it in both
-        // functions would double-count the number of operations.
-        _together.requests.store(1);
-    } else {
-        _together.logicalBytesIn.fetchAndAdd(bytes);
-        _together.requests.fetchAndAdd(1);
-    }
+    _logicalBytesIn.add(bytes);
+    _requests.add(1);
 }
 
 void NetworkCounter::hitLogicalOut(long long bytes) {
-    static const int64_t MAX = 1ULL << 60;
-
-    // don't care about the race as its just a counter
-    const bool overflow = _logicalBytesOut.loadRelaxed() > MAX;
-
-    if (overflow) {
-        _logicalBytesOut.store(bytes);
-    } else {
-        _logicalBytesOut.fetchAndAdd(bytes);
-    }
+    _logicalBytesOut.add(bytes);
 }
 
 void NetworkCounter::append(BSONObjBuilder& b) {
-    b.append("bytesIn", static_cast<long long>(_together.logicalBytesIn.loadRelaxed()));
-    b.append("bytesOut", static_cast<long long>(_logicalBytesOut.loadRelaxed()));
-    b.append("physicalBytesIn", static_cast<long long>(_physicalBytesIn.loadRelaxed()));
-    b.append("physicalBytesOut", static_cast<long long>(_physicalBytesOut.loadRelaxed()));
-    b.append("numRequests", static_cast<long long>(_together.requests.loadRelaxed()));
-}
+    static const long long MAX = 1LL << 60;
+
+    // Summing the shards is too expensive to do on every hit, so the counters are checked for
+    // overflow when they are read instead. The request count is reset along with the logical
+    // bytes in, as both are counted by hitLogicalIn.
+    auto overflowed = [](ShardedCounter64& counter) {
+        if (counter.load() <= MAX)
+            return false;
+        counter.store(0);
+        return true;
+    };
+
+    if (overflowed(_logicalBytesIn)) {
+        _requests.store(0);
+    }
+    overflowed(_logicalBytesOut);
+    overflowed(_physicalBytesIn);
+    overflowed(_physicalBytesOut);
 
+    b.append("bytesIn", _logicalBytesIn.load());
+    b.append("bytesOut", _logicalBytesOut.load());
+    b.append("physicalBytesIn", _physicalBytesIn.load());
+    b.append("physicalBytesOut", _physicalBytesOut.load());
+    b.append("numRequests", _requests.load());
+}
 
 OpCounters globalOpCounters;
 OpCounters replOpCounters;
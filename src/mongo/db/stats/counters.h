@@ -32,6 +32,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
+#include "mongo/platform/sharded_counter.h"
 #include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
@@ -59,34 +60,35 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicUInt32* getInsert() const {
+    const ShardedCounter64* getInsert() const {
         return &_insert;
     }
-    const AtomicUInt32* getQuery() const {
+    const ShardedCounter64* getQuery() const {
         return &_query;
     }
-    const AtomicUInt32* getUpdate() const {
+    const ShardedCounter64* getUpdate() const {
         return &_update;
     }
-    const AtomicUInt32* getDelete() const {
+    const ShardedCounter64* getDelete() const {
         return &_delete;
     }
-    const AtomicUInt32* getGetMore() const {
+    const ShardedCounter64* getGetMore() const {
         return &_getmore;
     }
-    const AtomicUInt32* getCommand() const {
+    const ShardedCounter64* getCommand() const {
         return &_command;
     }
 
 private:
+    void _checkWrapRarely();
     void _checkWrap();
 
-    CacheAligned<AtomicUInt32> _insert;
-    CacheAligned<AtomicUInt32> _query;
-    CacheAligned<AtomicUInt32> _update;
-    CacheAligned<AtomicUInt32> _delete;
-    CacheAligned<AtomicUInt32> _getmore;
-    CacheAligned<AtomicUInt32> _command;
+    ShardedCounter64 _insert;
+    ShardedCounter64 _query;
+    ShardedCounter64 _update;
+    ShardedCounter64 _delete;
+    ShardedCounter64 _getmore;
+    ShardedCounter64 _command;
 };
 
 extern OpCounters globalOpCounters;
@@ -106,20 +108,16 @@ public:
     void append(BSONObjBuilder& b);
 
 private:
-    CacheAligned<AtomicInt64> _physicalBytesIn{0};
-    CacheAligned<AtomicInt64> _physicalBytesOut{0};
-
-    // These two counters are always incremented at the same time, so
-    // we place them on the same cache line.
-    struct Together {
-        AtomicInt64 logicalBytesIn{0};
-        AtomicInt64 requests{0};
-    };
-    CacheAligned<Together> _together{};
-    static_assert(sizeof(decltype(_together)) <= stdx::hardware_constructive_interference_size,
-                  "cache line spill");
-
-    CacheAligned<AtomicInt64> _logicalBytesOut{0};
+    ShardedCounter64 _physicalBytesIn;
+    ShardedCounter64 _physicalBytesOut;
+
+    // The requests field only gets incremented in hitLogicalIn (and not in hitPhysicalIn) because
+    // the hitLogical and hitPhysical are each called for each operation. Incrementing it in both
+    // functions would double-count the number of operations.
+    ShardedCounter64 _logicalBytesIn;
+    ShardedCounter64 _requests;
+
+    ShardedCounter64 _logicalBytesOut;
 };
 
 extern NetworkCounter networkCounter;
@@ -124,5 +124,23 @@ public:
 
 } lockStatsServerStatusSection;
 
+
+class LockWaitHistogramServerStatusSection : public ServerStatusSection {
+public:
+    LockWaitHistogramServerStatusSection() : ServerStatusSection("lockWaitHistogram") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder ret;
+        reportGlobalLockWaitHistogram(&ret);
+        return ret.obj();
+    }
+
+} lockWaitHistogramServerStatusSection;
+
 }  // namespace
 }  // namespace mongo
@@ -150,24 +150,28 @@ public:
                           const BSONObj& key,
                           const RecordId& loc,
                           bool dupsAllowed) {
-        invariant(loc.isNormal());
-        invariant(!hasFieldNames(key));
-
-        if (key.objsize() >= TempKeyMaxSize) {
-            string msg = mongoutils::str::stream()
-                << "EphemeralForTestBtree::insert: key too large to index, failing " << ' '
-                << key.objsize() << ' ' << key;
-            return Status(ErrorCodes::KeyTooLong, msg);
-        }
+        return _insert(opCtx, key, loc, dupsAllowed, nullptr);
+    }
 
-        // TODO optimization: save the iterator from the dup-check to speed up insert
-        if (!dupsAllowed && isDup(*_data, key, loc))
-            return dupKeyError(key);
+    Status insertKeys(OperationContext* opCtx,
+                      const std::vector<BSONObj>& keys,
+                      const RecordId& loc,
+                      bool dupsAllowed,
+                      const InsertKeyErrorHandler& onError,
+                      int64_t* numInserted) override {
+        // Each key is inserted just before the entry that followed the previous one, which is
+        // where it belongs when the keys come in ascending order.
+        IndexSet::const_iterator hint = _data->end();
+        for (const auto& key : keys) {
+            Status status = _insert(opCtx, key, loc, dupsAllowed, &hint);
+            if (status.isOK()) {
+                ++*numInserted;
+                continue;
+            }
 
-        IndexKeyEntry entry(key.getOwned(), loc);
-        if (_data->insert(entry).second) {
-            _currentKeySize += key.objsize();
-            opCtx->recoveryUnit()->registerChange(new IndexChange(_data, entry, true));
+            status = onError(key, status);
+            if (!status.isOK())
+                return status;
         }
         return Status::OK();
     }
@@ -188,6 +192,33 @@ public:
         }
     }
 
+    void unindexKeys(OperationContext* opCtx,
+                     const std::vector<BSONObj>& keys,
+                     const RecordId& loc,
+                     bool dupsAllowed) override {
+        invariant(loc.isNormal());
+
+        // With the keys in ascending order, the entry to remove is often the one that followed
+        // the entry removed last, in which case there is no need to look for it.
+        IndexSet::const_iterator next = _data->end();
+        for (const auto& key : keys) {
+            invariant(!hasFieldNames(key));
+
+            IndexKeyEntry entry(key.getOwned(), loc);
+            auto it = next;
+            if (it == _data->end() || _data->key_comp()(*it, entry) ||
+                _data->key_comp()(entry, *it)) {
+                it = _data->find(entry);
+            }
+            if (it == _data->end())
+                continue;
+
+            next = _data->erase(it);
+            _currentKeySize -= key.objsize();
+            opCtx->recoveryUnit()->registerChange(new IndexChange(_data, entry, false));
+        }
+    }
+
     virtual void fullValidate(OperationContext* opCtx,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const {
@@ -481,6 +512,44 @@ public:
     }
 
 private:
+    /**
+     * Inserts one entry. If 'hint' is given, the entry is inserted right before it if it belongs
+     * there, and 'hint' is moved to the entry after it, for the next key.
+     */
+    Status _insert(OperationContext* opCtx,
+                   const BSONObj& key,
+                   const RecordId& loc,
+                   bool dupsAllowed,
+                   IndexSet::const_iterator* hint) {
+        invariant(loc.isNormal());
+        invariant(!hasFieldNames(key));
+
+        if (key.objsize() >= TempKeyMaxSize) {
+            string msg = mongoutils::str::stream()
+                << "EphemeralForTestBtree::insert: key too large to index, failing " << ' '
+                << key.objsize() << ' ' << key;
+            return Status(ErrorCodes::KeyTooLong, msg);
+        }
+
+        // TODO optimization: save the iterator from the dup-check to speed up insert
+        if (!dupsAllowed && isDup(*_data, key, loc))
+            return dupKeyError(key);
+
+        IndexKeyEntry entry(key.getOwned(), loc);
+        const size_t sizeBefore = _data->size();
+        if (hint) {
+            *hint = std::next(_data->insert(*hint, entry));
+        } else {
+            _data->insert(entry);
+        }
+
+        if (_data->size() != sizeBefore) {
+            _currentKeySize += key.objsize();
+            opCtx->recoveryUnit()->registerChange(new IndexChange(_data, entry, true));
+        }
+        return Status::OK();
+    }
+
     class IndexChange : public RecoveryUnit::Change {
     public:
         IndexChange(IndexSet* data, const IndexKeyEntry& entry, bool insert)
@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/key_string.h"
 
+#include <algorithm>
 #include <cmath>
 #include <type_traits>
 
@@ -2095,6 +2096,50 @@ std::string KeyString::toString() const {
     return toHex(getBuffer(), getSize());
 }
 
+void KeyString::SequentialBuilder::Stats::add(const Stats& other) {
+    numKeys += other.numKeys;
+    keyBytes += other.keyBytes;
+    sharedPrefixBytes += other.sharedPrefixBytes;
+}
+
+const KeyString& KeyString::SequentialBuilder::build(const BSONObj& obj,
+                                                     Ordering ord,
+                                                     RecordId recordId) {
+    _next().resetToKey(obj, ord, recordId);
+    return _recordBuilt();
+}
+
+const KeyString& KeyString::SequentialBuilder::build(const BSONObj& obj, Ordering ord) {
+    _next().resetToKey(obj, ord);
+    return _recordBuilt();
+}
+
+KeyString& KeyString::SequentialBuilder::_next() {
+    std::swap(_current, _previous);
+    return *_current;
+}
+
+const KeyString& KeyString::SequentialBuilder::_recordBuilt() {
+    const KeyString& key = *_current;
+    const KeyString& previous = *_previous;
+    dassert(_stats.numKeys == 0 || previous.compare(key) <= 0);
+
+    const size_t size = key.getSize();
+    if (_stats.numKeys == 0) {
+        _sharedPrefixSize = 0;
+    } else {
+        const size_t common = std::min(size, previous.getSize());
+        _sharedPrefixSize =
+            std::mismatch(key.getBuffer(), key.getBuffer() + common, previous.getBuffer()).first -
+            key.getBuffer();
+    }
+
+    _stats.numKeys++;
+    _stats.keyBytes += size;
+    _stats.sharedPrefixBytes += _sharedPrefixSize;
+    return key;
+}
+
 int KeyString::compare(const KeyString& other) const {
     int a = getSize();
     int b = other.getSize();
@@ -368,6 +368,11 @@ public:
      */
     std::string toString() const;
 
+    /**
+     * Builds the keys of a bulk load one after another. See the definition below.
+     */
+    class SequentialBuilder;
+
     /**
      * Version to use for conversion to/from KeyString. V1 has different encodings for numeric
      * values.
@@ -423,6 +428,59 @@ private:
     StackBufBuilder _buffer;
 };
 
+/**
+ * Builds the keys of a bulk load one after another, and measures how many bytes each key has in
+ * common with the key before it. Keys must be built in ascending order.
+ *
+ * KeyString encodes a compound key field by field, and the encoding of a field only depends on its
+ * own value, so keys whose leading fields are equal begin with the same bytes. Storage engines
+ * that prefix-compress their keys only store each key's bytes after that shared prefix, which is
+ * what the statistics here estimate.
+ *
+ * The builder alternates between two KeyStrings, so that it neither allocates nor copies the
+ * previous key for each key built. The KeyString returned by build() stays valid until the call
+ * after next.
+ */
+class KeyString::SequentialBuilder {
+public:
+    struct Stats {
+        long long numKeys = 0;
+
+        // The total size of the keys built, and the part of it that repeats the preceding key.
+        long long keyBytes = 0;
+        long long sharedPrefixBytes = 0;
+
+        void add(const Stats& other);
+    };
+
+    explicit SequentialBuilder(Version version) : _first(version), _second(version) {}
+
+    const KeyString& build(const BSONObj& obj, Ordering ord, RecordId recordId);
+    const KeyString& build(const BSONObj& obj, Ordering ord);
+
+    /**
+     * Returns the number of leading bytes the key last built shares with the key before it.
+     */
+    size_t sharedPrefixSize() const {
+        return _sharedPrefixSize;
+    }
+
+    const Stats& stats() const {
+        return _stats;
+    }
+
+private:
+    KeyString& _next();
+    const KeyString& _recordBuilt();
+
+    KeyString _first;
+    KeyString _second;
+    KeyString* _current = &_second;
+    KeyString* _previous = &_first;
+    size_t _sharedPrefixSize = 0;
+    Stats _stats;
+};
+
 inline bool operator<(const KeyString& lhs, const KeyString& rhs) {
     return lhs.compare(rhs) < 0;
 }
@@ -1394,6 +1394,43 @@ TEST_F(KeyStringTest, DecimalFromUniformDoublePerf) {
     perfTest(version, numbers);
 }
 
+TEST_F(KeyStringTest, SequentialBuilderMatchesKeyString) {
+    KeyString::SequentialBuilder builder(version);
+    for (int i = 0; i < 10; i++) {
+        const BSONObj key = BSON("" << (i / 4) << "" << i);
+        const RecordId id(i + 1);
+        const KeyString& built = builder.build(key, ALL_ASCENDING, id);
+        const KeyString expected(version, key, ALL_ASCENDING, id);
+        ASSERT_EQ(built, expected);
+        ASSERT_BSONOBJ_EQ(toBson(built, ALL_ASCENDING), key);
+    }
+}
+
+TEST_F(KeyStringTest, SequentialBuilderMeasuresSharedPrefixes) {
+    KeyString::SequentialBuilder builder(version);
+    const auto leading = std::string(100, 'x');
+
+    const auto& first = builder.build(BSON("" << leading << "" << 1), ALL_ASCENDING);
+    const size_t firstSize = first.getSize();
+    ASSERT_EQ(builder.sharedPrefixSize(), 0U);
+
+    // Everything up to the second field is shared with the first key.
+    const auto& second = builder.build(BSON("" << leading << "" << 2), ALL_ASCENDING);
+    const size_t secondSize = second.getSize();
+    ASSERT_GT(builder.sharedPrefixSize(), leading.size());
+    ASSERT_LT(builder.sharedPrefixSize(), secondSize);
+    const size_t shared = builder.sharedPrefixSize();
+
+    // The key from two builds ago has been reused by now.
+    builder.build(BSON("" << std::string(100, 'y') << "" << 1), ALL_ASCENDING);
+    ASSERT_EQ(builder.sharedPrefixSize(), 1U);
+
+    const auto& stats = builder.stats();
+    ASSERT_EQ(stats.numKeys, 3);
+    ASSERT_EQ(stats.keyBytes, static_cast<long long>(firstSize * 2 + secondSize));
+    ASSERT_EQ(stats.sharedPrefixBytes, static_cast<long long>(shared + 1));
+}
+
 DEATH_TEST(KeyStringTest, ToBsonPromotesAssertionsToTerminate, "terminate() called") {
     const char invalidString[] = {
         60,  // CType::kStringLike
@@ -636,6 +636,10 @@ Timestamp KVStorageEngine::getAllCommittedTimestamp(OperationContext* opCtx) con
     return _engine->getAllCommittedTimestamp(opCtx);
 }
 
+double KVStorageEngine::getCacheDirtyRatio() const {
+    return _engine->getCacheDirtyRatio();
+}
+
 void KVStorageEngine::_dumpCatalog(OperationContext* opCtx) {
     auto catalogRs = _catalogRecordStore.get();
     auto cursor = catalogRs->getCursor(opCtx);
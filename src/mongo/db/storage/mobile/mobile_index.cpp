@@ -38,6 +38,7 @@
 #include "mongo/db/storage/mobile/mobile_recovery_unit.h"
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 namespace {
@@ -91,30 +92,65 @@ Status MobileIndex::insert(OperationContext* opCtx,
         return status;
     }
 
-    return _insert(opCtx, key, recId, dupsAllowed);
+    return _insert(opCtx, key, recId, dupsAllowed, nullptr);
+}
+
+Status MobileIndex::insertKeys(OperationContext* opCtx,
+                               const std::vector<BSONObj>& keys,
+                               const RecordId& recId,
+                               bool dupsAllowed,
+                               const InsertKeyErrorHandler& onError,
+                               int64_t* numInserted) {
+    invariant(recId.isNormal());
+
+    BatchStatements batch;
+    for (const auto& key : keys) {
+        invariant(!hasFieldNames(key));
+
+        Status status = _checkKeySize(key);
+        if (status.isOK())
+            status = _insert(opCtx, key, recId, dupsAllowed, &batch);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        status = onError(key, status);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
 }
 
 template <typename ValueType>
 Status MobileIndex::doInsert(OperationContext* opCtx,
                              const KeyString& key,
                              const ValueType& value,
-                             bool isTransactional) {
-    MobileSession* session;
-    if (isTransactional) {
-        session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
+                             bool isTransactional,
+                             BatchStatements* batch) {
+    std::unique_ptr<SqliteStatement> insertStmt;
+    if (batch && batch->insert) {
+        insertStmt = std::move(batch->insert);
     } else {
-        session = MobileRecoveryUnit::get(opCtx)->getSessionNoTxn(opCtx);
-    }
+        MobileSession* session;
+        if (isTransactional) {
+            session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
+        } else {
+            session = MobileRecoveryUnit::get(opCtx)->getSessionNoTxn(opCtx);
+        }
 
-    std::string insertQuery = "INSERT INTO \"" + _ident + "\" (key, value) VALUES (?, ?);";
-    SqliteStatement insertStmt(*session, insertQuery);
+        std::string insertQuery = "INSERT INTO \"" + _ident + "\" (key, value) VALUES (?, ?);";
+        insertStmt = stdx::make_unique<SqliteStatement>(*session, insertQuery);
+    }
 
-    insertStmt.bindBlob(0, key.getBuffer(), key.getSize());
-    insertStmt.bindBlob(1, value.getBuffer(), value.getSize());
+    insertStmt->bindBlob(0, key.getBuffer(), key.getSize());
+    insertStmt->bindBlob(1, value.getBuffer(), value.getSize());
 
-    int status = insertStmt.step();
+    int status = insertStmt->step();
     if (status == SQLITE_CONSTRAINT) {
-        insertStmt.setExceptionStatus(status);
+        // The failed statement is finalized here rather than reset, so a batch prepares a new one
+        // for its next key.
+        insertStmt->setExceptionStatus(status);
         if (isUnique()) {
             // Return error if duplicate key inserted in a unique index.
             BSONObj bson =
@@ -129,6 +165,10 @@ Status MobileIndex::doInsert(OperationContext* opCtx,
     }
     checkStatus(status, SQLITE_DONE, "sqlite3_step");
 
+    if (batch) {
+        insertStmt->reset();
+        batch->insert = std::move(insertStmt);
+    }
     return Status::OK();
 }
 
@@ -139,25 +179,53 @@ void MobileIndex::unindex(OperationContext* opCtx,
     invariant(recId.isNormal());
     invariant(!hasFieldNames(key));
 
-    return _unindex(opCtx, key, recId, dupsAllowed);
+    return _unindex(opCtx, key, recId, dupsAllowed, nullptr);
 }
 
-void MobileIndex::_doDelete(OperationContext* opCtx, const KeyString& key, KeyString* value) {
-    MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
+void MobileIndex::unindexKeys(OperationContext* opCtx,
+                              const std::vector<BSONObj>& keys,
+                              const RecordId& recId,
+                              bool dupsAllowed) {
+    invariant(recId.isNormal());
 
-    str::stream deleteQuery;
-    deleteQuery << "DELETE FROM \"" << _ident << "\" WHERE key = ?";
-    if (value) {
-        deleteQuery << " AND value = ?";
+    BatchStatements batch;
+    for (const auto& key : keys) {
+        invariant(!hasFieldNames(key));
+        _unindex(opCtx, key, recId, dupsAllowed, &batch);
     }
-    deleteQuery << ";";
-    SqliteStatement deleteStmt(*session, deleteQuery);
+}
 
-    deleteStmt.bindBlob(0, key.getBuffer(), key.getSize());
+void MobileIndex::_doDelete(OperationContext* opCtx,
+                            const KeyString& key,
+                            KeyString* value,
+                            BatchStatements* batch) {
+    // An index always deletes either by key alone or by key and value, so a statement kept in
+    // 'batch' is always the one for the deletion at hand.
+    std::unique_ptr<SqliteStatement> deleteStmt;
+    if (batch && batch->remove) {
+        deleteStmt = std::move(batch->remove);
+    } else {
+        MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
+
+        str::stream deleteQuery;
+        deleteQuery << "DELETE FROM \"" << _ident << "\" WHERE key = ?";
+        if (value) {
+            deleteQuery << " AND value = ?";
+        }
+        deleteQuery << ";";
+        deleteStmt = stdx::make_unique<SqliteStatement>(*session, deleteQuery);
+    }
+
+    deleteStmt->bindBlob(0, key.getBuffer(), key.getSize());
     if (value) {
-        deleteStmt.bindBlob(1, value->getBuffer(), value->getSize());
+        deleteStmt->bindBlob(1, value->getBuffer(), value->getSize());
+    }
+    deleteStmt->step(SQLITE_DONE);
+
+    if (batch) {
+        deleteStmt->reset();
+        batch->remove = std::move(deleteStmt);
     }
-    deleteStmt.step(SQLITE_DONE);
 }
 
 /**
@@ -673,22 +741,24 @@ std::unique_ptr<SortedDataInterface::Cursor> MobileIndexStandard::newCursor(Oper
 Status MobileIndexStandard::_insert(OperationContext* opCtx,
                                     const BSONObj& key,
                                     const RecordId& recId,
-                                    bool dupsAllowed) {
+                                    bool dupsAllowed,
+                                    BatchStatements* batch) {
     invariant(dupsAllowed);
 
     const KeyString keyStr(_keyStringVersion, key, _ordering, recId);
     const KeyString::TypeBits value = keyStr.getTypeBits();
-    return doInsert(opCtx, keyStr, value);
+    return doInsert(opCtx, keyStr, value, true, batch);
 }
 
 void MobileIndexStandard::_unindex(OperationContext* opCtx,
                                    const BSONObj& key,
                                    const RecordId& recId,
-                                   bool dupsAllowed) {
+                                   bool dupsAllowed,
+                                   BatchStatements* batch) {
     invariant(dupsAllowed);
 
     const KeyString keyStr(_keyStringVersion, key, _ordering, recId);
-    _doDelete(opCtx, keyStr);
+    _doDelete(opCtx, keyStr, nullptr, batch);
 }
 
 MobileIndexUnique::MobileIndexUnique(OperationContext* opCtx,
@@ -714,7 +784,8 @@ std::unique_ptr<SortedDataInterface::Cursor> MobileIndexUnique::newCursor(Operat
 Status MobileIndexUnique::_insert(OperationContext* opCtx,
                                   const BSONObj& key,
                                   const RecordId& recId,
-                                  bool dupsAllowed) {
+                                  bool dupsAllowed,
+                                  BatchStatements* batch) {
     // Replication is not supported so dups are not allowed.
     invariant(!dupsAllowed);
     const KeyString keyStr(_keyStringVersion, key, _ordering);
@@ -725,13 +796,14 @@ Status MobileIndexUnique::_insert(OperationContext* opCtx,
         value.appendTypeBits(typeBits);
     }
 
-    return doInsert(opCtx, keyStr, value);
+    return doInsert(opCtx, keyStr, value, true, batch);
 }
 
 void MobileIndexUnique::_unindex(OperationContext* opCtx,
                                  const BSONObj& key,
                                  const RecordId& recId,
-                                 bool dupsAllowed) {
+                                 bool dupsAllowed,
+                                 BatchStatements* batch) {
     // Replication is not supported so dups are not allowed.
     invariant(!dupsAllowed);
     const KeyString keyStr(_keyStringVersion, key, _ordering);
@@ -745,9 +817,9 @@ void MobileIndexUnique::_unindex(OperationContext* opCtx,
             value.appendTypeBits(typeBits);
         }
 
-        _doDelete(opCtx, keyStr, &value);
+        _doDelete(opCtx, keyStr, &value, batch);
     } else {
-        _doDelete(opCtx, keyStr);
+        _doDelete(opCtx, keyStr, nullptr, batch);
     }
 }
 
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/storage/index_entry_comparison.h"
@@ -57,6 +59,18 @@ public:
                  const RecordId& recId,
                  bool dupsAllowed) override;
 
+    Status insertKeys(OperationContext* opCtx,
+                      const std::vector<BSONObj>& keys,
+                      const RecordId& recId,
+                      bool dupsAllowed,
+                      const InsertKeyErrorHandler& onError,
+                      int64_t* numInserted) override;
+
+    void unindexKeys(OperationContext* opCtx,
+                     const std::vector<BSONObj>& keys,
+                     const RecordId& recId,
+                     bool dupsAllowed) override;
+
     void fullValidate(OperationContext* opCtx,
                       long long* numKeysOut,
                       ValidateResults* fullResults) const override;
@@ -83,13 +97,24 @@ public:
     static Status create(OperationContext* opCtx, const std::string& ident);
 
     /**
-     * Performs the insert into the table with the given key and value.
+     * SQLite statements prepared once for a batch of inserts or removals rather than for every
+     * key. A statement is only kept here between keys when it is ready to be bound again.
+     */
+    struct BatchStatements {
+        std::unique_ptr<SqliteStatement> insert;
+        std::unique_ptr<SqliteStatement> remove;
+    };
+
+    /**
+     * Performs the insert into the table with the given key and value. If 'batch' is given, the
+     * insert statement is taken from it, or prepared and left in it for the next key.
      */
     template <typename ValueType>
     Status doInsert(OperationContext* opCtx,
                     const KeyString& key,
                     const ValueType& value,
-                    bool isTransactional = true);
+                    bool isTransactional = true,
+                    BatchStatements* batch = nullptr);
 
     Ordering getOrdering() const {
         return _ordering;
@@ -118,19 +143,25 @@ protected:
     static Status _checkKeySize(const BSONObj& key);
 
     /**
-     * Performs the deletion from the table matching the given key.
+     * Performs the deletion from the table matching the given key. 'batch' is used as for
+     * doInsert().
      */
-    void _doDelete(OperationContext* opCtx, const KeyString& key, KeyString* value = nullptr);
+    void _doDelete(OperationContext* opCtx,
+                   const KeyString& key,
+                   KeyString* value = nullptr,
+                   BatchStatements* batch = nullptr);
 
     virtual Status _insert(OperationContext* opCtx,
                            const BSONObj& key,
                            const RecordId& recId,
-                           bool dupsAllowed) = 0;
+                           bool dupsAllowed,
+                           BatchStatements* batch) = 0;
 
     virtual void _unindex(OperationContext* opCtx,
                           const BSONObj& key,
                           const RecordId& recId,
-                          bool dupsAllowed) = 0;
+                          bool dupsAllowed,
+                          BatchStatements* batch) = 0;
 
     class BulkBuilderBase;
     class BulkBuilderStandard;
@@ -159,12 +190,14 @@ protected:
     Status _insert(OperationContext* opCtx,
                    const BSONObj& key,
                    const RecordId& recId,
-                   bool dupsAllowed) override;
+                   bool dupsAllowed,
+                   BatchStatements* batch) override;
 
     void _unindex(OperationContext* opCtx,
                   const BSONObj& key,
                   const RecordId& recId,
-                  bool dupsAllowed) override;
+                  bool dupsAllowed,
+                  BatchStatements* batch) override;
 };
 
 class MobileIndexUnique final : public MobileIndex {
@@ -184,12 +217,14 @@ protected:
     Status _insert(OperationContext* opCtx,
                    const BSONObj& key,
                    const RecordId& recId,
-                   bool dupsAllowed) override;
+                   bool dupsAllowed,
+                   BatchStatements* batch) override;
 
     void _unindex(OperationContext* opCtx,
                   const BSONObj& key,
                   const RecordId& recId,
-                  bool dupsAllowed) override;
+                  bool dupsAllowed,
+                  BatchStatements* batch) override;
 
     const bool _isPartial = false;
 };
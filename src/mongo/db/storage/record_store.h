@@ -207,6 +207,16 @@ public:
      */
     virtual void invalidate(OperationContext* opCtx, const RecordId& id) {}
 
+    /**
+     * Hints that the caller is going to call next() many times in a row, for example to scan a
+     * large collection, and that the cursor should read the records ahead of its position in the
+     * background so that they are already in memory by the time next() gets to them. The
+     * records next() returns are the same either way.
+     *
+     * Storage engines that cannot read ahead ignore this.
+     */
+    virtual void enableReadAhead() {}
+
     //
     // RecordFetchers
     //
@@ -29,11 +29,13 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/stdx/functional.h"
 
 #pragma once
 
@@ -113,6 +115,97 @@ public:
                          const RecordId& loc,
                          bool dupsAllowed) = 0;
 
+    /**
+     * Decides what happens when one of the keys passed to insertKeys() cannot be inserted:
+     * returning a non-OK Status stops the batch with that Status, returning Status::OK() skips
+     * the key and goes on with the next one.
+     */
+    using InsertKeyErrorHandler = stdx::function<Status(const BSONObj& key, const Status& status)>;
+
+    /**
+     * Insert an entry for each of 'keys', all with RecordId 'loc', as if by calling insert()
+     * for each key in turn.
+     *
+     * Callers should pass the keys in ascending order of 'this' index. Implementations can then
+     * keep a single cursor and move it forward through the index from one key to the next, rather
+     * than searching the index for every key on its own, which matters for multikey documents
+     * with many keys. Other orders are still correct, only slower.
+     *
+     * @param numInserted incremented for each key that was inserted
+     *
+     * @return Status::OK() unless 'onError' stopped the batch, in which case the keys before the
+     *         one that failed have been inserted
+     */
+    virtual Status insertKeys(OperationContext* opCtx,
+                              const std::vector<BSONObj>& keys,
+                              const RecordId& loc,
+                              bool dupsAllowed,
+                              const InsertKeyErrorHandler& onError,
+                              int64_t* numInserted) {
+        for (const auto& key : keys) {
+            Status status = insert(opCtx, key, loc, dupsAllowed);
+            if (status.isOK()) {
+                ++*numInserted;
+                continue;
+            }
+
+            status = onError(key, status);
+            if (!status.isOK())
+                return status;
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Decides what happens when one of the entries passed to insertEntries() cannot be inserted,
+     * in the same way as InsertKeyErrorHandler.
+     */
+    using InsertEntryErrorHandler =
+        stdx::function<Status(const IndexKeyEntry& entry, const Status& status)>;
+
+    /**
+     * Insert each of 'entries', as if by calling insert() for each entry in turn. This is the
+     * multi-document counterpart of insertKeys(): the entries may have different RecordIds, and
+     * callers should pass them in ascending order of 'this' index, breaking ties by RecordId.
+     *
+     * @param numInserted incremented for each entry that was inserted
+     *
+     * @return Status::OK() unless 'onError' stopped the batch, in which case the entries before
+     *         the one that failed have been inserted
+     */
+    virtual Status insertEntries(OperationContext* opCtx,
+                                 const std::vector<IndexKeyEntry>& entries,
+                                 bool dupsAllowed,
+                                 const InsertEntryErrorHandler& onError,
+                                 int64_t* numInserted) {
+        for (const auto& entry : entries) {
+            Status status = insert(opCtx, entry.key, entry.loc, dupsAllowed);
+            if (status.isOK()) {
+                ++*numInserted;
+                continue;
+            }
+
+            status = onError(entry, status);
+            if (!status.isOK())
+                return status;
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Remove the entry for each of 'keys' with RecordId 'loc', as if by calling unindex() for
+     * each key in turn. The keys should be in ascending order of 'this' index, as for
+     * insertKeys().
+     */
+    virtual void unindexKeys(OperationContext* opCtx,
+                             const std::vector<BSONObj>& keys,
+                             const RecordId& loc,
+                             bool dupsAllowed) {
+        for (const auto& key : keys) {
+            unindex(opCtx, key, loc, dupsAllowed);
+        }
+    }
+
     /**
      * Return ErrorCodes::DuplicateKey if 'key' already exists in 'this'
      * index at a RecordId other than 'loc', and Status::OK() otherwise.
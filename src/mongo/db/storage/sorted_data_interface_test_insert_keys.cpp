@@ -0,0 +1,269 @@
+// sorted_data_interface_test_insert_keys.cpp
+
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kNumKeys = 200;
+
+// The keys a multikey document with an array of kNumKeys elements generates, in index order.
+std::vector<BSONObj> makeKeys() {
+    std::vector<BSONObj> keys;
+    for (int i = 0; i < kNumKeys; i++) {
+        keys.push_back(BSON("" << i));
+    }
+    return keys;
+}
+
+SortedDataInterface::InsertKeyErrorHandler failOnError() {
+    return [](const BSONObj& key, const Status& status) { return status; };
+}
+
+// Insert a batch of keys at the same RecordId and verify that each of them is in the index, in
+// order.
+TEST(SortedDataInterface, InsertKeys) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+    const auto keys = makeKeys();
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            int64_t numInserted = 0;
+            ASSERT_OK(
+                sorted->insertKeys(opCtx.get(), keys, loc1, true, failOnError(), &numInserted));
+            ASSERT_EQUALS(kNumKeys, numInserted);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(kNumKeys, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        auto entry = cursor->seek(kMinBSONKey, true);
+        for (const auto& key : keys) {
+            ASSERT(entry);
+            ASSERT_EQ(*entry, IndexKeyEntry(key, loc1));
+            entry = cursor->next();
+        }
+        ASSERT(!entry);
+    }
+}
+
+// Insert a batch of keys into a unique index that already has one of them, and verify that the
+// batch stops at that key when the error handler fails it.
+TEST(SortedDataInterface, InsertKeysStopsWhenErrorHandlerFails) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(true));
+    const auto keys = makeKeys();
+    const auto& existingKey = keys[kNumKeys / 2];
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insert(opCtx.get(), existingKey, loc2, false));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            int64_t numInserted = 0;
+            std::vector<BSONObj> failedKeys;
+            Status status = sorted->insertKeys(
+                opCtx.get(),
+                keys,
+                loc1,
+                false,
+                [&](const BSONObj& key, const Status& status) {
+                    failedKeys.push_back(key);
+                    return status;
+                },
+                &numInserted);
+            ASSERT_EQUALS(ErrorCodes::DuplicateKey, status);
+            ASSERT_EQUALS(kNumKeys / 2, numInserted);
+            ASSERT_EQUALS(1U, failedKeys.size());
+            ASSERT_BSONOBJ_EQ(existingKey, failedKeys.front());
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(kNumKeys / 2 + 1, sorted->numEntries(opCtx.get()));
+    }
+}
+
+// Insert a batch of keys into a unique index that already has one of them, and verify that the
+// batch goes on with the other keys when the error handler ignores the error.
+TEST(SortedDataInterface, InsertKeysContinuesWhenErrorHandlerIgnores) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(true));
+    const auto keys = makeKeys();
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insert(opCtx.get(), keys[kNumKeys / 2], loc2, false));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            int64_t numInserted = 0;
+            ASSERT_OK(sorted->insertKeys(
+                opCtx.get(),
+                keys,
+                loc1,
+                false,
+                [](const BSONObj& key, const Status& status) { return Status::OK(); },
+                &numInserted));
+            ASSERT_EQUALS(kNumKeys - 1, numInserted);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(kNumKeys, sorted->numEntries(opCtx.get()));
+    }
+}
+
+// Insert a batch of keys, then remove every other one of them in another batch, and verify that
+// only the ones not removed are left in the index.
+TEST(SortedDataInterface, UnindexKeys) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+    const auto keys = makeKeys();
+
+    std::vector<BSONObj> removed;
+    std::vector<BSONObj> kept;
+    for (int i = 0; i < kNumKeys; i++) {
+        (i % 2 ? removed : kept).push_back(keys[i]);
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            int64_t numInserted = 0;
+            ASSERT_OK(
+                sorted->insertKeys(opCtx.get(), keys, loc1, true, failOnError(), &numInserted));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            sorted->unindexKeys(opCtx.get(), removed, loc1, true);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(static_cast<long long>(kept.size()), sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        auto entry = cursor->seek(kMinBSONKey, true);
+        for (const auto& key : kept) {
+            ASSERT(entry);
+            ASSERT_EQ(*entry, IndexKeyEntry(key, loc1));
+            entry = cursor->next();
+        }
+        ASSERT(!entry);
+    }
+}
+
+// Insert a batch of entries for several RecordIds, sharing some of the keys, and verify that each
+// of them is in the index, in order.
+TEST(SortedDataInterface, InsertEntries) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+
+    std::vector<IndexKeyEntry> entries;
+    for (const auto& key : makeKeys()) {
+        entries.emplace_back(key, loc1);
+        entries.emplace_back(key, loc2);
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            int64_t numInserted = 0;
+            ASSERT_OK(sorted->insertEntries(
+                opCtx.get(),
+                entries,
+                true,
+                [](const IndexKeyEntry& entry, const Status& status) { return status; },
+                &numInserted));
+            ASSERT_EQUALS(2 * kNumKeys, numInserted);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(2 * kNumKeys, sorted->numEntries(opCtx.get()));
+
+        const std::unique_ptr<SortedDataInterface::Cursor> cursor(sorted->newCursor(opCtx.get()));
+        auto entry = cursor->seek(kMinBSONKey, true);
+        for (const auto& expected : entries) {
+            ASSERT(entry);
+            ASSERT_EQ(*entry, expected);
+            entry = cursor->next();
+        }
+        ASSERT(!entry);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
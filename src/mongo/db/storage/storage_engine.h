@@ -404,6 +404,16 @@ public:
      * implementation.
      */
     virtual Timestamp getAllCommittedTimestamp(OperationContext* opCtx) const = 0;
+
+    /**
+     * Returns the fraction of the storage engine's cache, between 0 and 1, that holds modified data
+     * not yet written to disk. Background work such as orphan range deletion can use this to back
+     * off before the storage engine starts stalling application threads to evict dirty data.
+     * Storage engines without a cache of dirty data return 0.
+     */
+    virtual double getCacheDirtyRatio() const {
+        return 0;
+    }
 };
 
 }  // namespace mongo
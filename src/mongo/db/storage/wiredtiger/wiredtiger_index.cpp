@@ -349,6 +349,83 @@ void WiredTigerIndex::unindex(OperationContext* opCtx,
     _unindex(opCtx, c, key, id, dupsAllowed);
 }
 
+Status WiredTigerIndex::insertKeys(OperationContext* opCtx,
+                                   const std::vector<BSONObj>& keys,
+                                   const RecordId& id,
+                                   bool dupsAllowed,
+                                   const InsertKeyErrorHandler& onError,
+                                   int64_t* numInserted) {
+    invariant(id.isNormal());
+
+    // One cursor serves the whole batch. With the keys in index order, each insert lands at or
+    // just after the previous one, mostly on leaf pages the cursor has just visited.
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& key : keys) {
+        dassert(!hasFieldNames(key));
+
+        Status status = checkKeySize(key);
+        if (status.isOK())
+            status = _insert(opCtx, c, key, id, dupsAllowed);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        status = onError(key, status);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
+Status WiredTigerIndex::insertEntries(OperationContext* opCtx,
+                                      const std::vector<IndexKeyEntry>& entries,
+                                      bool dupsAllowed,
+                                      const InsertEntryErrorHandler& onError,
+                                      int64_t* numInserted) {
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& entry : entries) {
+        invariant(entry.loc.isNormal());
+        dassert(!hasFieldNames(entry.key));
+
+        Status status = checkKeySize(entry.key);
+        if (status.isOK())
+            status = _insert(opCtx, c, entry.key, entry.loc, dupsAllowed);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        status = onError(entry, status);
+        if (!status.isOK())
+            return status;
+    }
+    return Status::OK();
+}
+
+void WiredTigerIndex::unindexKeys(OperationContext* opCtx,
+                                  const std::vector<BSONObj>& keys,
+                                  const RecordId& id,
+                                  bool dupsAllowed) {
+    invariant(id.isNormal());
+
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    for (const auto& key : keys) {
+        dassert(!hasFieldNames(key));
+        _unindex(opCtx, c, key, id, dupsAllowed);
+    }
+}
+
 void WiredTigerIndex::fullValidate(OperationContext* opCtx,
                                    long long* numKeysOut,
                                    ValidateResults* fullResults) const {
@@ -415,6 +492,11 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
         output->append("type", type);
     }
 
+    _appendBulkLoadStats(output,
+                         metadataResult.isOK() &&
+                             metadataResult.getValue().find("prefix_compression=true") !=
+                                 std::string::npos);
+
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSession();
     WT_SESSION* s = session->getSession();
     Status status =
@@ -427,6 +509,29 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
     return true;
 }
 
+void WiredTigerIndex::_recordBulkLoad(const KeyString::SequentialBuilder::Stats& stats) {
+    stdx::lock_guard<stdx::mutex> lk(_bulkLoadStatsMutex);
+    _bulkLoadStats = stats;
+}
+
+void WiredTigerIndex::_appendBulkLoadStats(BSONObjBuilder* output, bool prefixCompression) const {
+    stdx::lock_guard<stdx::mutex> lk(_bulkLoadStatsMutex);
+    if (!_bulkLoadStats || _bulkLoadStats->numKeys == 0)
+        return;
+
+    const auto& stats = *_bulkLoadStats;
+    BSONObjBuilder bulkLoad(output->subobjStart("bulkLoad"));
+    bulkLoad.append("numKeys", stats.numKeys);
+    bulkLoad.append("prefixCompression", prefixCompression);
+    bulkLoad.append("bytesPerKey", static_cast<double>(stats.keyBytes) / stats.numKeys);
+
+    // What is left of each key once the prefix it shares with the preceding key is elided, as
+    // WiredTiger prefix compression does.
+    bulkLoad.append("bytesPerKeyAfterPrefixCompression",
+                    static_cast<double>(stats.keyBytes - stats.sharedPrefixBytes) /
+                        stats.numKeys);
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx,
                                     const BSONObj& key,
                                     const RecordId& id) {
@@ -568,7 +673,8 @@ public:
           _opCtx(opCtx),
           _session(WiredTigerRecoveryUnit::get(_opCtx)->getSessionCache()->getSession()),
           _cursor(openBulkCursor(idx)),
-          _prefix(prefix) {}
+          _prefix(prefix),
+          _keyBuilder(idx->keyStringVersion()) {}
 
     ~BulkBuilder() {
         _cursor->close(_cursor);
@@ -613,6 +719,9 @@ protected:
     UniqueWiredTigerSession const _session;
     WT_CURSOR* const _cursor;
     KVPrefix _prefix;
+
+    // Keys arrive in order, so consecutive keys are built into the same pair of buffers.
+    KeyString::SequentialBuilder _keyBuilder;
 };
 
 /**
@@ -630,7 +739,7 @@ public:
                 return s;
         }
 
-        KeyString data(_idx->keyStringVersion(), key, _idx->_ordering, id);
+        const KeyString& data = _keyBuilder.build(key, _idx->_ordering, id);
 
         // Can't use WiredTigerCursor since we aren't using the cache.
         WiredTigerItem item(data.getBuffer(), data.getSize());
@@ -652,6 +761,7 @@ public:
         // this is bizarre, but required as part of the contract
         WriteUnitOfWork uow(_opCtx);
         uow.commit();
+        _idx->_recordBulkLoad(_keyBuilder.stats());
     }
 
 private:
@@ -672,10 +782,7 @@ public:
                       OperationContext* opCtx,
                       bool dupsAllowed,
                       KVPrefix prefix)
-        : BulkBuilder(idx, opCtx, prefix),
-          _idx(idx),
-          _dupsAllowed(dupsAllowed),
-          _keyString(idx->keyStringVersion()) {}
+        : BulkBuilder(idx, opCtx, prefix), _idx(idx), _dupsAllowed(dupsAllowed) {}
 
     Status addKey(const BSONObj& newKey, const RecordId& id) override {
         if (_idx->isTimestampSafeUniqueIdx()) {
@@ -691,6 +798,7 @@ public:
             doInsert();
         }
         uow.commit();
+        _idx->_recordBulkLoad(_keyBuilder.stats());
     }
 
 private:
@@ -714,16 +822,16 @@ private:
             invariant(_previousKey.isEmpty() || cmp > 0);
         }
 
-        _keyString.resetToKey(newKey, _idx->ordering(), id);
+        const KeyString& keyString = _keyBuilder.build(newKey, _idx->ordering(), id);
 
         // Can't use WiredTigerCursor since we aren't using the cache.
-        WiredTigerItem keyItem(_keyString.getBuffer(), _keyString.getSize());
+        WiredTigerItem keyItem(keyString.getBuffer(), keyString.getSize());
         setKey(_cursor, keyItem.Get());
 
-        WiredTigerItem valueItem = _keyString.getTypeBits().isAllZeros()
+        WiredTigerItem valueItem = keyString.getTypeBits().isAllZeros()
             ? emptyItem
-            : WiredTigerItem(_keyString.getTypeBits().getBuffer(),
-                             _keyString.getTypeBits().getSize());
+            : WiredTigerItem(keyString.getTypeBits().getBuffer(),
+                             keyString.getTypeBits().getSize());
 
         _cursor->set_value(_cursor, valueItem.Get());
 
@@ -760,8 +868,15 @@ private:
             // _previousKey which is correct since any dups seen later are likely to be newer.
         }
 
-        _keyString.resetToKey(newKey, _idx->ordering());
-        _records.push_back(std::make_pair(id, _keyString.getTypeBits()));
+        if (cmp == 0 && !_records.empty()) {
+            // A duplicate encodes to the same bytes as the key whose ids are being collected, so
+            // only its TypeBits are needed, and it is not a key of its own in the statistics.
+            KeyString duplicate(_idx->keyStringVersion(), newKey, _idx->ordering());
+            _records.push_back(std::make_pair(id, duplicate.getTypeBits()));
+        } else {
+            _keyString = &_keyBuilder.build(newKey, _idx->ordering());
+            _records.push_back(std::make_pair(id, _keyString->getTypeBits()));
+        }
         _previousKey = newKey.getOwned();
 
         return Status::OK();
@@ -780,7 +895,7 @@ private:
             }
         }
 
-        WiredTigerItem keyItem(_keyString.getBuffer(), _keyString.getSize());
+        WiredTigerItem keyItem(_keyString->getBuffer(), _keyString->getSize());
         WiredTigerItem valueItem(value.getBuffer(), value.getSize());
 
         setKey(_cursor, keyItem.Get());
@@ -793,7 +908,9 @@ private:
 
     WiredTigerIndex* _idx;
     const bool _dupsAllowed;
-    KeyString _keyString;
+
+    // The last key built, which stays valid until the next one is built.
+    const KeyString* _keyString = nullptr;
     std::vector<std::pair<RecordId, KeyString::TypeBits>> _records;
     BSONObj _previousKey;
 };
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <wiredtiger.h>
 
 #include "mongo/base/status_with.h"
@@ -37,6 +38,7 @@
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -100,6 +102,24 @@ public:
                          const RecordId& id,
                          bool dupsAllowed);
 
+    Status insertKeys(OperationContext* opCtx,
+                      const std::vector<BSONObj>& keys,
+                      const RecordId& id,
+                      bool dupsAllowed,
+                      const InsertKeyErrorHandler& onError,
+                      int64_t* numInserted) override;
+
+    Status insertEntries(OperationContext* opCtx,
+                         const std::vector<IndexKeyEntry>& entries,
+                         bool dupsAllowed,
+                         const InsertEntryErrorHandler& onError,
+                         int64_t* numInserted) override;
+
+    void unindexKeys(OperationContext* opCtx,
+                     const std::vector<BSONObj>& keys,
+                     const RecordId& id,
+                     bool dupsAllowed) override;
+
     virtual void fullValidate(OperationContext* opCtx,
                               long long* numKeysOut,
                               ValidateResults* fullResults) const;
@@ -172,6 +192,13 @@ protected:
 
     void setKey(WT_CURSOR* cursor, const WT_ITEM* item);
 
+    /**
+     * Remembers the key statistics of the last bulk load, which collStats reports. They are kept
+     * in memory only.
+     */
+    void _recordBulkLoad(const KeyString::SequentialBuilder::Stats& stats);
+    void _appendBulkLoadStats(BSONObjBuilder* output, bool prefixCompression) const;
+
     class BulkBuilder;
     class StandardBulkBuilder;
     class UniqueBulkBuilder;
@@ -187,6 +214,9 @@ protected:
     std::string _indexName;
     KVPrefix _prefix;
     bool _isIdIndex;
+
+    mutable stdx::mutex _bulkLoadStatsMutex;
+    boost::optional<KeyString::SequentialBuilder::Stats> _bulkLoadStats;
 };
 
 class WiredTigerIndexUnique : public WiredTigerIndex {
@@ -79,6 +79,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/ticket_tuner.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
@@ -331,11 +332,236 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// Tickets only internal operations may take once the ones above have run out, so that replication
+// and traffic from other members of the cluster are never starved by user operations.
+TicketHolder openWritePriorityTransaction(16);
+TicketServerParameter openWritePriorityTransactionParam(
+    &openWritePriorityTransaction, "wiredTigerConcurrentPriorityWriteTransactions");
+
+TicketHolder openReadPriorityTransaction(16);
+TicketServerParameter openReadPriorityTransactionParam(
+    &openReadPriorityTransaction, "wiredTigerConcurrentPriorityReadTransactions");
+
+// When enabled at startup, the number of read and write tickets is adjusted every
+// wiredTigerAdaptiveConcurrentTransactionsIntervalMillis, within the bounds below, instead of
+// staying at the value of wiredTigerConcurrent{Read,Write}Transactions, and internal operations
+// may take the priority tickets above.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactions, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMin, int, 16);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsMax, int, 512);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactionsIntervalMillis, int, 1000);
+
+// The tuners are only touched by the tuning thread and by serverStatus.
+stdx::mutex ticketTunersMutex;
+TicketTuner writeTicketTuner(16, 512);
+TicketTuner readTicketTuner(16, 512);
+
+// Share of the cache above which the tuner considers WiredTiger to be under pressure.
+const double kTicketTuningCacheUsedThreshold = 0.95;
+const double kTicketTuningCacheDirtyThreshold = 0.20;
+
+void appendTicketStats(const TicketHolder& holder,
+                       const TicketHolder& priorityHolder,
+                       const TicketTuner& tuner,
+                       BSONObjBuilder* bob) {
+    bob->append("out", holder.used());
+    bob->append("available", holder.available());
+    bob->append("totalTickets", holder.outof());
+    {
+        BSONObjBuilder priority(bob->subobjStart("priority"));
+        priority.append("out", priorityHolder.used());
+        priority.append("available", priorityHolder.available());
+        priority.append("totalTickets", priorityHolder.outof());
+    }
+    {
+        BSONObjBuilder tuning(bob->subobjStart("tuning"));
+        tuning.append("enabled", wiredTigerAdaptiveConcurrentTransactions);
+        tuner.appendStats(&tuning);
+    }
+}
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
 }  // namespace
 
+/**
+ * Periodically resizes the read and write TicketHolders. Only runs when
+ * wiredTigerAdaptiveConcurrentTransactions is set at startup. See TicketTuner for how the sizes are
+ * chosen; this thread feeds it what the TicketHolders and the WiredTiger cache statistics saw
+ * during each interval.
+ */
+class WiredTigerKVEngine::WiredTigerTicketTuner : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTuner(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock,
+                    stdx::chrono::milliseconds(std::max(
+                        1, wiredTigerAdaptiveConcurrentTransactionsIntervalMillis.load())),
+                    [&] { return _shuttingDown.load(); });
+            }
+
+            if (_shuttingDown.load())
+                break;
+
+            try {
+                _tune();
+            } catch (const AssertionException& ex) {
+                invariant(ErrorCodes::isShutdownError(ex.code()), ex.what());
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    struct Totals {
+        long long acquired = 0;
+        long long waited = 0;
+        Microseconds waitTime{0};
+    };
+
+    static Totals _totalsOf(const TicketHolder& holder) {
+        Totals totals;
+        totals.acquired = holder.totalAcquired();
+        totals.waited = holder.totalWaited();
+        totals.waitTime = holder.totalWaitTime();
+        return totals;
+    }
+
+    /**
+     * Returns whether WiredTiger struggled to keep up during the last interval: application
+     * threads had to evict pages themselves, or the cache is nearly full or heavily dirty.
+     */
+    bool _storagePressure() {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+
+        auto stat = [&](int key) -> int64_t {
+            auto value = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+                s, "statistics:", "statistics=(fast)", key);
+            return value.isOK() ? value.getValue() : 0;
+        };
+
+        const auto appEvictions = stat(WT_STAT_CONN_CACHE_EVICTION_APP);
+        const bool appEvicting = _lastAppEvictions >= 0 && appEvictions > _lastAppEvictions;
+        _lastAppEvictions = appEvictions;
+
+        const auto bytesMax = stat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (bytesMax <= 0)
+            return appEvicting;
+
+        const double used = static_cast<double>(stat(WT_STAT_CONN_CACHE_BYTES_INUSE)) / bytesMax;
+        const double dirty = static_cast<double>(stat(WT_STAT_CONN_CACHE_BYTES_DIRTY)) / bytesMax;
+        return appEvicting || used > kTicketTuningCacheUsedThreshold ||
+            dirty > kTicketTuningCacheDirtyThreshold;
+    }
+
+    void _tune() {
+        const auto writeTotals = _totalsOf(openWriteTransaction);
+        const auto readTotals = _totalsOf(openReadTransaction);
+        const bool storagePressure = _storagePressure();
+
+        // Take the first interval as the baseline.
+        if (_haveBaseline) {
+            const int minTickets = std::max(1, wiredTigerAdaptiveConcurrentTransactionsMin.load());
+            const int maxTickets =
+                std::max(minTickets, wiredTigerAdaptiveConcurrentTransactionsMax.load());
+
+            int writeTarget;
+            int readTarget;
+            {
+                stdx::lock_guard<stdx::mutex> lk(ticketTunersMutex);
+                writeTarget = _target(&writeTicketTuner,
+                                      openWriteTransaction,
+                                      _lastWriteTotals,
+                                      writeTotals,
+                                      storagePressure,
+                                      minTickets,
+                                      maxTickets);
+                readTarget = _target(&readTicketTuner,
+                                     openReadTransaction,
+                                     _lastReadTotals,
+                                     readTotals,
+                                     storagePressure,
+                                     minTickets,
+                                     maxTickets);
+            }
+
+            // Shrinking waits for tickets to be returned, so it must not hold up serverStatus.
+            _resize(&openWriteTransaction, writeTarget);
+            _resize(&openReadTransaction, readTarget);
+        }
+
+        _haveBaseline = true;
+        _lastWriteTotals = writeTotals;
+        _lastReadTotals = readTotals;
+    }
+
+    static int _target(TicketTuner* tuner,
+                       const TicketHolder& holder,
+                       const Totals& last,
+                       const Totals& current,
+                       bool storagePressure,
+                       int minTickets,
+                       int maxTickets) {
+        TicketTuner::Sample sample;
+        sample.acquired = current.acquired - last.acquired;
+        sample.waited = current.waited - last.waited;
+        sample.waitTime = current.waitTime - last.waitTime;
+        sample.storagePressure = storagePressure;
+
+        tuner->setBounds(minTickets, maxTickets);
+        const int target = tuner->tune(holder.outof(), sample);
+        if (target != holder.outof()) {
+            LOG(1) << "Resizing WiredTiger tickets from " << holder.outof() << " to " << target
+                   << " (" << TicketTuner::decisionToString(tuner->lastDecision()) << ")";
+        }
+        return target;
+    }
+
+    static void _resize(TicketHolder* holder, int target) {
+        if (target == holder->outof())
+            return;
+
+        Status status = holder->resize(target);
+        if (!status.isOK()) {
+            LOG(1) << "Failed to resize WiredTiger tickets: " << status;
+        }
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+
+    bool _haveBaseline = false;
+    int64_t _lastAppEvictions = -1;
+    Totals _lastWriteTotals;
+    Totals _lastReadTotals;
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -482,6 +708,13 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer->fillCache();
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    if (wiredTigerAdaptiveConcurrentTransactions) {
+        Locker::setGlobalPriorityThrottling(&openReadPriorityTransaction,
+                                            &openWritePriorityTransaction);
+
+        _ticketTuner = stdx::make_unique<WiredTigerTicketTuner>(_sessionCache.get());
+        _ticketTuner->go();
+    }
 }
 
 
@@ -495,18 +728,16 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
 
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
+    stdx::lock_guard<stdx::mutex> lk(ticketTunersMutex);
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        appendTicketStats(
+            openWriteTransaction, openWritePriorityTransaction, writeTicketTuner, &bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        appendTicketStats(openReadTransaction, openReadPriorityTransaction, readTicketTuner, &bbb);
         bbb.done();
     }
     bb.done();
@@ -521,6 +752,8 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketTuner)
+        _ticketTuner->shutdown();
     if (_journalFlusher)
         _journalFlusher->shutdown();
     if (_checkpointThread) {
@@ -1211,6 +1444,21 @@ Timestamp WiredTigerKVEngine::getAllCommittedTimestamp(OperationContext* opCtx)
     return Timestamp(_oplogManager->fetchAllCommittedValue(opCtx));
 }
 
+double WiredTigerKVEngine::getCacheDirtyRatio() const {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    auto bytesDirty = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        s, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    auto bytesMax = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+        s, "statistics:", "statistics=(fast)", WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (!bytesDirty.isOK() || !bytesMax.isOK() || bytesMax.getValue() <= 0) {
+        return 0;
+    }
+
+    return std::min(1.0, static_cast<double>(bytesDirty.getValue()) / bytesMax.getValue());
+}
+
 boost::optional<Timestamp> WiredTigerKVEngine::getRecoveryTimestamp() const {
     if (!supportsRecoverToStableTimestamp()) {
         severe() << "WiredTiger is configured to not support recover to a stable timestamp";
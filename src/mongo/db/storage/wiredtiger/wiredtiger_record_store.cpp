@@ -37,6 +37,9 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <deque>
+#include <limits>
+
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
@@ -47,6 +50,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
@@ -59,9 +63,13 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -92,6 +100,12 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 MONGO_FP_DECLARE(WTWriteConflictException);
 MONGO_FP_DECLARE(WTWriteConflictExceptionForReads);
 
+// How far ahead of a cursor, in megabytes of record data, its read-ahead thread may read.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerReadAheadMB, int, 32);
+
+// Cursors that ask for read-ahead beyond this many at a time go without.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerMaxReadAheadThreads, int, 8);
+
 const std::string kWiredTigerEngineName = "wiredTiger";
 
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
@@ -1173,6 +1187,11 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
+
+    // Reserve the ids for the whole batch up front so that concurrent inserters contend on the
+    // counter once per batch rather than once per record, and so the records are inserted in
+    // RecordId order through the single cursor above.
+    int64_t firstId = _isOplog ? 0 : _reserveIds(nRecords).repr();
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         if (_isOplog) {
@@ -1181,10 +1200,8 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
         } else {
-            record.id = _nextId();
+            record.id = RecordId(firstId + static_cast<int64_t>(i));
         }
         dassert(record.id > highestId);
         highestId = record.id;
@@ -1592,11 +1609,13 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     }
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+RecordId WiredTigerRecordStore::_reserveIds(size_t nRecords) {
     invariant(!_isOplog);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
-    invariant(out.isNormal());
-    return out;
+    invariant(nRecords > 0);
+    RecordId first = RecordId(_nextIdNum.fetchAndAdd(static_cast<int64_t>(nRecords)));
+    invariant(first.isNormal());
+    invariant(RecordId(first.repr() + static_cast<int64_t>(nRecords) - 1).isNormal());
+    return first;
 }
 
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* opCtx) {
@@ -1786,6 +1805,220 @@ Status WiredTigerRecordStore::oplogDiskLocRegister(OperationContext* opCtx,
 
 // Cursor Base:
 
+/**
+ * Reads the records ahead of a forward cursor over a standard record store on a thread of its
+ * own, with a WiredTiger session of its own, so that the pages the cursor is about to visit are
+ * already in the WiredTiger cache when it gets to them. WiredTiger has no way to ask for pages to
+ * be read asynchronously, so this is done by reading them.
+ *
+ * The thread reads in chunks and stops once it is wiredTigerReadAheadMB ahead of the cursor, until
+ * the cursor gets past the first chunk it has not consumed yet. It only opens a WiredTiger cursor
+ * while the cursor it reads for is not saved: once saved, the cursor's operation may give up its
+ * locks, after which the collection could be dropped or the storage engine shut down.
+ */
+class WiredTigerRecordStoreCursorBase::ReadAhead {
+    MONGO_DISALLOW_COPYING(ReadAhead);
+
+public:
+    ReadAhead(std::string uri, UniqueWiredTigerSession session, const RecordId& start)
+        : _uri(std::move(uri)), _session(std::move(session)), _cursorPosition(start.repr()) {
+        _thread = stdx::thread([this, start] { _run(start); });
+    }
+
+    ~ReadAhead() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stop = true;
+            _pauseRequested.store(true);
+            _cond.notify_all();
+        }
+        _thread.join();
+        activeThreads.subtractAndFetch(1);
+    }
+
+    /**
+     * Called each time the cursor returns the record 'id'.
+     */
+    void advanced(const RecordId& id) {
+        _cursorPosition.store(id.repr());
+        if (id.repr() >= _wakeUpAt.load()) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _cond.notify_all();
+        }
+    }
+
+    /**
+     * Returns once the read-ahead thread has closed its WiredTiger cursor, and keeps it from
+     * opening a new one until resume().
+     */
+    void pause() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _paused = true;
+        _pauseRequested.store(true);
+        _cond.notify_all();
+        _cond.wait(lk, [&] { return !_active; });
+    }
+
+    void resume() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _paused = false;
+        _pauseRequested.store(false);
+        _cond.notify_all();
+    }
+
+    // The number of read-ahead threads running, across all cursors.
+    static AtomicInt32 activeThreads;
+
+private:
+    static constexpr int64_t kChunkBytes = 1024 * 1024;
+    static constexpr int64_t kNoWakeUp = std::numeric_limits<int64_t>::max();
+
+    struct Chunk {
+        int64_t lastId;
+        int64_t bytes;
+    };
+
+    void _run(RecordId position) {
+        setThreadName("WTReadAhead");
+
+        WT_CURSOR* c = nullptr;
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_stop) {
+            // Forget about the chunks the cursor has gone past.
+            while (!_chunks.empty() && _chunks.front().lastId <= _cursorPosition.load()) {
+                _bytesAhead -= _chunks.front().bytes;
+                _chunks.pop_front();
+            }
+
+            const int64_t windowBytes =
+                std::max(wiredTigerReadAheadMB.load(), 1) * static_cast<int64_t>(1024 * 1024);
+            if (_paused || _bytesAhead >= windowBytes) {
+                if (_paused && c) {
+                    invariantWTOK(c->close(c));
+                    c = nullptr;
+                    _active = false;
+                    _cond.notify_all();
+                }
+                _wakeUpAt.store(_chunks.empty() ? kNoWakeUp : _chunks.front().lastId);
+
+                MONGO_IDLE_THREAD_BLOCK;
+                _cond.wait(lk);
+                continue;
+            }
+
+            _active = true;
+            _wakeUpAt.store(kNoWakeUp);
+            lk.unlock();
+            const auto bytes = _readChunk(&c, &position);
+            lk.lock();
+
+            if (!bytes)
+                break;
+            _chunks.push_back({position.repr(), *bytes});
+            _bytesAhead += *bytes;
+        }
+
+        if (c) {
+            invariantWTOK(c->close(c));
+        }
+        _active = false;
+        _cond.notify_all();
+    }
+
+    /**
+     * Reads up to kChunkBytes of the records after 'position', or after the cursor's position if
+     * the cursor has already gone past it, and sets 'position' to the last one read. Returns how
+     * many bytes were read, or boost::none once there is nothing more to read.
+     */
+    boost::optional<int64_t> _readChunk(WT_CURSOR** c, RecordId* position) {
+        if (!*c) {
+            WT_SESSION* session = _session->getSession();
+            int ret = session->open_cursor(session, _uri.c_str(), nullptr, nullptr, c);
+            if (ret != 0) {
+                LOG(1) << "Read-ahead for " << _uri
+                       << " could not open a cursor: " << wiredtiger_strerror(ret);
+                *c = nullptr;
+                return boost::none;
+            }
+        }
+        WT_CURSOR* cursor = *c;
+
+        const RecordId cursorPosition(_cursorPosition.load());
+        if (cursorPosition > *position)
+            *position = cursorPosition;
+
+        int ret;
+        if (position->isNull()) {
+            ret = cursor->next(cursor);
+        } else {
+            cursor->set_key(cursor, position->repr());
+            int cmp;
+            ret = cursor->search_near(cursor, &cmp);
+            if (ret == 0 && cmp <= 0)
+                ret = cursor->next(cursor);
+        }
+
+        int64_t bytes = 0;
+        while (ret == 0) {
+            int64_t id;
+            WT_ITEM value;
+            ret = cursor->get_key(cursor, &id);
+            if (ret == 0)
+                ret = cursor->get_value(cursor, &value);
+            if (ret != 0)
+                break;
+
+            *position = RecordId(id);
+            bytes += value.size;
+            if (bytes >= kChunkBytes || _pauseRequested.load())
+                break;
+
+            ret = cursor->next(cursor);
+        }
+
+        // Let go of the pages under the cursor while we wait. The next chunk starts with a search.
+        invariantWTOK(cursor->reset(cursor));
+
+        if (ret == WT_NOTFOUND)
+            return boost::none;
+        if (ret != 0) {
+            LOG(1) << "Read-ahead for " << _uri << " stopped: " << wiredtiger_strerror(ret);
+            return boost::none;
+        }
+        return bytes;
+    }
+
+    const std::string _uri;
+    const UniqueWiredTigerSession _session;
+
+    // The last record the cursor returned.
+    AtomicInt64 _cursorPosition;
+
+    // The cursor wakes the thread up once it gets to this record.
+    AtomicInt64 _wakeUpAt{kNoWakeUp};
+
+    // Checked by the thread between records, to stop reading as soon as it is told to pause or
+    // stop.
+    AtomicWord<bool> _pauseRequested{false};
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cond;
+
+    // The chunks read ahead of the cursor, oldest first.
+    std::deque<Chunk> _chunks;
+    int64_t _bytesAhead = 0;
+
+    bool _paused = false;
+    bool _stop = false;
+
+    // True while the thread has a WiredTiger cursor open.
+    bool _active = false;
+
+    stdx::thread _thread;
+};
+
+AtomicInt32 WiredTigerRecordStoreCursorBase::ReadAhead::activeThreads;
+
 WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContext* opCtx,
                                                                  const WiredTigerRecordStore& rs,
                                                                  bool forward)
@@ -1793,10 +2026,40 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
     _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
 }
 
+WiredTigerRecordStoreCursorBase::~WiredTigerRecordStoreCursorBase() = default;
+
+void WiredTigerRecordStoreCursorBase::_startReadAhead() {
+    invariant(_forward);
+
+    // The oplog is read from its end, which is in the cache already, and reading ahead of an
+    // in-memory table gains nothing.
+    WiredTigerSessionCache* sessionCache = WiredTigerRecoveryUnit::get(_opCtx)->getSessionCache();
+    if (_rs._isOplog || sessionCache->isEphemeral()) {
+        _readAheadEnabled = false;
+        return;
+    }
+
+    if (ReadAhead::activeThreads.addAndFetch(1) > wiredTigerMaxReadAheadThreads.load()) {
+        ReadAhead::activeThreads.subtractAndFetch(1);
+        LOG(2) << "Not reading ahead of a scan of " << _rs.ns()
+               << ", wiredTigerMaxReadAheadThreads are already running";
+        _readAheadEnabled = false;
+        return;
+    }
+
+    // Sessions must be taken from the cache while holding the global lock, which our caller
+    // does.
+    _readAhead = stdx::make_unique<ReadAhead>(
+        _rs.getURI(), sessionCache->getSession(), _lastReturnedId);
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     if (_eof)
         return {};
 
+    if (_readAheadEnabled && !_readAhead)
+        _startReadAhead();
+
     WT_CURSOR* c = _cursor->get();
 
     RecordId id;
@@ -1835,6 +2098,8 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     invariantWTOK(c->get_value(c, &value));
 
     _lastReturnedId = id;
+    if (_readAhead)
+        _readAhead->advanced(id);
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
@@ -1861,6 +2126,9 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 
 
 void WiredTigerRecordStoreCursorBase::save() {
+    if (_readAhead)
+        _readAhead->pause();
+
     try {
         if (_cursor)
             _cursor->reset();
@@ -1887,6 +2155,9 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     invariant(WiredTigerRecoveryUnit::get(_opCtx)->getSession() == _cursor->getSession());
     _skipNextAdvance = false;
 
+    if (_readAhead)
+        _readAhead->resume();
+
     // If we've hit EOF, then this iterator is done and need not be restored.
     if (_eof)
         return true;
@@ -1937,6 +2208,8 @@ bool WiredTigerRecordStoreCursorBase::restore() {
 void WiredTigerRecordStoreCursorBase::detachFromOperationContext() {
     _opCtx = nullptr;
     _cursor = boost::none;
+    // Don't keep a thread around while the cursor waits for a getMore, next() starts a new one.
+    _readAhead.reset();
 }
 
 void WiredTigerRecordStoreCursorBase::reattachToOperationContext(OperationContext* opCtx) {
@@ -1987,6 +2260,12 @@ WiredTigerRecordStoreStandardCursor::WiredTigerRecordStoreStandardCursor(
     OperationContext* opCtx, const WiredTigerRecordStore& rs, bool forward)
     : WiredTigerRecordStoreCursorBase(opCtx, rs, forward) {}
 
+void WiredTigerRecordStoreStandardCursor::enableReadAhead() {
+    // The read-ahead thread only knows the key format of standard record stores.
+    if (_forward)
+        _readAheadEnabled = true;
+}
+
 void WiredTigerRecordStoreStandardCursor::setKey(WT_CURSOR* cursor, RecordId id) const {
     cursor->set_key(cursor, id.repr());
 }
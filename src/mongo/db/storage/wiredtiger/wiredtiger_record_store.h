@@ -293,7 +293,11 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Reserves 'nRecords' consecutive RecordIds and returns the first one. Not used for the oplog,
+     * whose RecordIds come from the timestamps of the entries.
+     */
+    RecordId _reserveIds(size_t nRecords);
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
@@ -408,6 +412,8 @@ public:
                                     const WiredTigerRecordStore& rs,
                                     bool forward);
 
+    ~WiredTigerRecordStoreCursorBase();
+
     boost::optional<Record> next();
 
     boost::optional<Record> seekExact(const RecordId& id);
@@ -449,8 +455,18 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
 
+    // Set by implementations of enableReadAhead(). The read-ahead thread itself is only started
+    // by the first call to next(), and stopped when the cursor is detached from its operation.
+    bool _readAheadEnabled = false;
+
 private:
+    class ReadAhead;
+
     bool isVisible(const RecordId& id);
+
+    void _startReadAhead();
+
+    std::unique_ptr<ReadAhead> _readAhead;
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
@@ -459,6 +475,8 @@ public:
                                         const WiredTigerRecordStore& rs,
                                         bool forward = true);
 
+    void enableReadAhead() override;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const override;
 
@@ -32,6 +32,7 @@
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -403,6 +404,51 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+// Scan a collection large enough for the read-ahead thread to get ahead of the cursor, yielding
+// and detaching along the way, and verify that the cursor still returns every record in order.
+TEST(WiredTigerRecordStoreTest, ReadAheadCursorReturnsEveryRecord) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int kNumRecords = 4000;
+    const std::string data(1024, 'x');
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < kNumRecords; i++) {
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    auto opCtx = harnessHelper->newOperationContext();
+    auto cursor = rs->getCursor(opCtx.get());
+    cursor->enableReadAhead();
+
+    for (int i = 0; i < kNumRecords; i++) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(ids[i], record->id);
+
+        if (i % 1000 == 999) {
+            cursor->save();
+            cursor->detachFromOperationContext();
+            opCtx = harnessHelper->newOperationContext();
+            cursor->reattachToOperationContext(opCtx.get());
+            ASSERT(cursor->restore());
+        } else if (i % 100 == 99) {
+            cursor->save();
+            opCtx->recoveryUnit()->abandonSnapshot();
+            ASSERT(cursor->restore());
+        }
+    }
+    ASSERT(!cursor->next());
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
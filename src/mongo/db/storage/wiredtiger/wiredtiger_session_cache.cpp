@@ -35,6 +35,8 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -107,13 +109,17 @@ WiredTigerSession::~WiredTigerSession() {
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool forRecordStore) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
-        }
+    auto indexed = _cursorIndex.find(id);
+    if (indexed != _cursorIndex.end()) {
+        auto i = indexed->second.back();
+        indexed->second.pop_back();
+        if (indexed->second.empty())
+            _cursorIndex.erase(indexed);
+
+        WT_CURSOR* c = i->_cursor;
+        _cursors.erase(i);
+        _cursorsOut++;
+        return c;
     }
 
     WT_CURSOR* c = NULL;
@@ -135,11 +141,19 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorIndex[id].push_back(_cursors.begin());
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(kWiredTigerCursorCacheSize.load());
 
     while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
+        // The oldest cursor in the cache is also the oldest one cached for its table.
+        auto indexed = _cursorIndex.find(_cursors.back()._id);
+        dassert(indexed->second.front() == std::prev(_cursors.end()));
+        indexed->second.erase(indexed->second.begin());
+        if (indexed->second.empty())
+            _cursorIndex.erase(indexed);
+
         cursor = _cursors.back()._cursor;
         _cursors.pop_back();
         invariantWTOK(cursor->close(cursor));
@@ -158,6 +172,7 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
         } else
             ++i;
     }
+    _rebuildCursorIndex();
 }
 
 void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
@@ -165,6 +180,8 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty())
+        _rebuildCursorIndex();
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -174,6 +191,15 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
     }
 }
 
+void WiredTigerSession::_rebuildCursorIndex() {
+    _cursorIndex.clear();
+    // Walk from the back so that each table's cursors are indexed least recently used first.
+    for (auto i = _cursors.end(); i != _cursors.begin();) {
+        --i;
+        _cursorIndex[i->_id].push_back(i);
+    }
+}
+
 namespace {
 AtomicUInt64 nextTableId(1);
 }
@@ -308,35 +334,121 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
-    }
+    _forEachCachedSession([&](WiredTigerSession* session) {
+        session->closeAllCursors(uri);
+        return true;
+    });
 }
 
 void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
-    }
+    _forEachCachedSession([&](WiredTigerSession* session) {
+        session->closeCursorsForQueuedDrops(_engine);
+        return true;
+    });
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
-
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions of an
+    // older epoch that are released into a shard after this are freed by whoever takes them.
     {
         stdx::lock_guard<stdx::mutex> lock(_cacheLock);
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
     }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+    _forEachCachedSession([](WiredTigerSession* session) {
+        delete session;
+        return false;
+    });
+}
+
+size_t WiredTigerSessionCache::_currentShard() {
+    static AtomicWord<unsigned> nextShard{0};
+    static thread_local size_t shard = kNumSessionShards;
+    if (MONGO_unlikely(shard == kNumSessionShards)) {
+        shard = nextShard.fetchAndAdd(1) % kNumSessionShards;
+    }
+    return shard;
+}
+
+WiredTigerSession* WiredTigerSessionCache::_takeCachedSession() {
+    const auto home = _currentShard();
+    for (size_t i = 0; i < kNumSessionShards; i++) {
+        auto& shard = _sessionShards[(home + i) % kNumSessionShards];
+        for (auto& slot : shard.slots) {
+            // Only try to claim slots that look full, to avoid writing to other threads' cache
+            // lines for nothing.
+            if (!slot.loadRelaxed())
+                continue;
+
+            auto session = slot.swap(nullptr);
+            if (!session)
+                continue;
+
+            if (session->_getEpoch() != _epoch.load()) {
+                // Released into the shard concurrently with closeAll.
+                delete session;
+                continue;
+            }
+
+            return session;
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    if (_sessions.empty())
+        return nullptr;
+
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones
+    WiredTigerSession* cachedSession = _sessions.back();
+    _sessions.pop_back();
+    return cachedSession;
+}
+
+bool WiredTigerSessionCache::_putCachedSession(WiredTigerSession* session) {
+    for (auto& slot : _sessionShards[_currentShard()].slots) {
+        if (!slot.loadRelaxed() && slot.compareAndSwap(nullptr, session) == nullptr)
+            return true;
     }
+    return false;
+}
+
+template <typename Functor>
+void WiredTigerSessionCache::_forEachCachedSession(const Functor& functor) {
+    for (auto& shard : _sessionShards) {
+        for (auto& slot : shard.slots) {
+            if (!slot.loadRelaxed())
+                continue;
+
+            // Only the claimed slot is empty while 'functor' runs, so getSession() keeps finding
+            // the other cached sessions.
+            auto session = slot.swap(nullptr);
+            if (!session || !functor(session))
+                continue;
+
+            if (slot.compareAndSwap(nullptr, session) == nullptr)
+                continue;
+
+            // A released session refilled the slot in the meantime.
+            {
+                stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+                if (session->_getEpoch() == _epoch.load()) {
+                    _sessions.push_back(session);
+                    continue;
+                }
+            }
+            delete session;
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    _sessions.erase(std::remove_if(_sessions.begin(),
+                                   _sessions.end(),
+                                   [&](WiredTigerSession* session) { return !functor(session); }),
+                    _sessions.end());
 }
 
 bool WiredTigerSessionCache::isEphemeral() {
@@ -348,15 +460,8 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            return UniqueWiredTigerSession(cachedSession);
-        }
+    if (auto cachedSession = _takeCachedSession()) {
+        return UniqueWiredTigerSession(cachedSession);
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
@@ -413,10 +518,14 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+        if (_putCachedSession(session)) {
             returnedToCache = true;
-            _sessions.push_back(session);
+        } else {
+            stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+            if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+                returnedToCache = true;
+                _sessions.push_back(session);
+            }
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
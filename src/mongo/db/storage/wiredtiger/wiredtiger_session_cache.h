@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -40,6 +43,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
@@ -60,6 +64,8 @@ public:
 /**
  * This is a structure that caches 1 cursor for each uri.
  * The idea is that there is a pool of these somewhere.
+ * The cached cursors are indexed by table id, so finding one does not depend on how many other
+ * tables the session has cursors open on.
  * NOT THREADSAFE
  */
 class WiredTigerSession {
@@ -129,6 +135,12 @@ private:
     // The cursor cache is a list of pairs that contain an ID and cursor
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Maps a table id to its cached cursors in _cursors, least recently used first.
+    typedef std::unordered_map<uint64_t, std::vector<CursorCache::iterator>> CursorIndex;
+
+    // Rebuilds _cursorIndex after cursors were removed from _cursors in bulk.
+    void _rebuildCursorIndex();
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -144,6 +156,7 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorIndex _cursorIndex;
     uint64_t _cursorGen;
     int _cursorsOut;
     bool _dropQueuedIdentsAtSessionEnd = true;
@@ -152,6 +165,12 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  Released sessions are kept in a set of shards, each of which has a few slots that are claimed
+ *  and filled with atomic operations, so that handing a session from one operation to the next
+ *  does not take a lock. A thread releases sessions into its own shard and takes sessions from
+ *  it first, stealing from the other shards when its own is empty. Sessions that do not fit into
+ *  a shard go into a list protected by a mutex.
  */
 class WiredTigerSessionCache {
 public:
@@ -263,6 +282,18 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
+    static constexpr size_t kNumSessionShards = 16;
+    static constexpr size_t kSessionsPerShard = 8;
+
+    struct alignas(stdx::hardware_destructive_interference_size) SessionShard {
+        // A slot holds either nullptr or a released session; whoever swaps the session out of
+        // the slot owns it.
+        std::array<AtomicWord<WiredTigerSession*>, kSessionsPerShard> slots;
+    };
+
+    std::array<SessionShard, kNumSessionShards> _sessionShards;
+
+    // Holds the sessions that did not fit into a shard.
     stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
     SessionCache _sessions;
@@ -295,6 +326,32 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the shard the calling thread releases sessions into and first takes them from.
+     */
+    static size_t _currentShard();
+
+    /**
+     * Takes a cached session from the calling thread's shard, another shard or the overflow list,
+     * in that order. Returns nullptr if there are none.
+     */
+    WiredTigerSession* _takeCachedSession();
+
+    /**
+     * Puts 'session' into a free slot of the calling thread's shard. Returns false if there is
+     * none, in which case the caller still owns the session.
+     */
+    bool _putCachedSession(WiredTigerSession* session);
+
+    /**
+     * Calls 'functor' on every cached session. Sessions in a shard are claimed one slot at a time
+     * and put back afterwards, and the overflow list is walked under _cacheLock, so concurrent
+     * getSession() calls keep reusing the rest of the cache. 'functor' returns false if it freed
+     * the session, in which case it is not put back.
+     */
+    template <typename Functor>
+    void _forEachCachedSession(const Functor& functor);
 };
 
 /**
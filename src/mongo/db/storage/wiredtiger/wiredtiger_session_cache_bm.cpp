@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 64;
+const int kMaxTables = 64;
+
+/**
+ * An in-memory WiredTiger connection with kMaxTables tables, shared by all of the benchmarks and
+ * their threads.
+ */
+class WiredTigerHarness {
+public:
+    WiredTigerHarness()
+        : _path(boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("wt_session_cache_bm-%%%%-%%%%")) {
+        boost::filesystem::create_directories(_path);
+        invariantWTOK(
+            wiredtiger_open(_path.string().c_str(), nullptr, "create,in_memory=true", &_conn));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+
+        auto session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        for (int i = 0; i < kMaxTables; i++) {
+            _tables.push_back({"table:bm" + std::to_string(i), WiredTigerSession::genTableId()});
+            invariantWTOK(
+                s->create(s, _tables.back().uri.c_str(), "key_format=q,value_format=u"));
+        }
+    }
+
+    ~WiredTigerHarness() {
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+        boost::filesystem::remove_all(_path);
+    }
+
+    struct Table {
+        std::string uri;
+        uint64_t id;
+    };
+
+    WiredTigerSessionCache* sessionCache() {
+        return _sessionCache.get();
+    }
+
+    const Table& table(int i) const {
+        return _tables[i];
+    }
+
+private:
+    boost::filesystem::path _path;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+    std::vector<Table> _tables;
+};
+
+WiredTigerHarness& harness() {
+    static WiredTigerHarness harness;
+    return harness;
+}
+
+void BM_GetAndReleaseSession(benchmark::State& state) {
+    auto sessionCache = harness().sessionCache();
+    for (auto _ : state) {
+        auto session = sessionCache->getSession();
+        benchmark::DoNotOptimize(session.get());
+    }
+}
+
+// Takes the cursor on one table from a session that has cursors cached for state.range(0) tables.
+void BM_GetAndReleaseCachedCursor(benchmark::State& state) {
+    const int numTables = state.range(0);
+    auto session = harness().sessionCache()->getSession();
+
+    std::vector<WT_CURSOR*> cursors;
+    for (int i = 0; i < numTables; i++) {
+        const auto& table = harness().table(i);
+        cursors.push_back(session->getCursor(table.uri, table.id, true));
+    }
+    for (int i = 0; i < numTables; i++) {
+        session->releaseCursor(harness().table(i).id, cursors[i]);
+    }
+
+    // The first table released is the one furthest from the front of the cache.
+    const auto& table = harness().table(0);
+    for (auto _ : state) {
+        auto cursor = session->getCursor(table.uri, table.id, true);
+        session->releaseCursor(table.id, cursor);
+    }
+}
+
+BENCHMARK(BM_GetAndReleaseSession)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_GetAndReleaseCachedCursor)->Range(1, kMaxTables);
+
+}  // namespace
+}  // namespace mongo
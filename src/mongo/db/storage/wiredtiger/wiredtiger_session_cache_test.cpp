@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <vector>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const char* const kTableURI = "table:session_cache_test";
+
+class WiredTigerSessionCacheTest : public unittest::Test {
+public:
+    WiredTigerSessionCacheTest() : _dbpath("wt_session_cache_test") {
+        ASSERT_OK(wtRCToStatus(
+            wiredtiger_open(_dbpath.path().c_str(), nullptr, "create,in_memory=true", &_conn)));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+
+        auto session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        ASSERT_OK(wtRCToStatus(s->create(s, kTableURI, "key_format=q,value_format=u")));
+    }
+
+    ~WiredTigerSessionCacheTest() {
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+    }
+
+protected:
+    WiredTigerSessionCache* sessionCache() {
+        return _sessionCache.get();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+TEST_F(WiredTigerSessionCacheTest, SweepingKeepsCachedSessionsAvailable) {
+    const int kCachedSessions = 24;
+    const int kWorkers = 4;
+    const int kIterations = 20000;
+
+    // Fill both the shards and the overflow list. These sessions stay alive for the whole test,
+    // so any other pointer handed out below is a freshly opened session.
+    std::set<WiredTigerSession*> cached;
+    {
+        std::vector<UniqueWiredTigerSession> sessions;
+        for (int i = 0; i < kCachedSessions; i++) {
+            sessions.push_back(sessionCache()->getSession());
+            cached.insert(sessions.back().get());
+        }
+    }
+
+    const uint64_t tableId = WiredTigerSession::genTableId();
+    AtomicWord<bool> done{false};
+    AtomicWord<int> freshSessions{0};
+
+    std::vector<stdx::thread> workers;
+    for (int i = 0; i < kWorkers; i++) {
+        workers.emplace_back([&] {
+            for (int j = 0; j < kIterations; j++) {
+                auto session = sessionCache()->getSession();
+                if (cached.find(session.get()) == cached.end())
+                    freshSessions.fetchAndAdd(1);
+
+                auto cursor = session->getCursor(kTableURI, tableId, true);
+                session->releaseCursor(tableId, cursor);
+            }
+        });
+    }
+
+    stdx::thread sweeper([&] {
+        while (!done.load()) {
+            sessionCache()->closeAllCursors("");
+            sessionCache()->closeAllCursors(kTableURI);
+        }
+    });
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    done.store(true);
+    sweeper.join();
+
+    ASSERT_EQ(0, freshSessions.load());
+
+    // Every session went back into the cache, none was lost or duplicated by the sweeps.
+    std::vector<UniqueWiredTigerSession> sessions;
+    std::set<WiredTigerSession*> returned;
+    for (int i = 0; i < kCachedSessions; i++) {
+        sessions.push_back(sessionCache()->getSession());
+        returned.insert(sessions.back().get());
+    }
+    ASSERT(returned == cached);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,221 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/util/timer.h"
+
+namespace InsertBatchTests {
+
+class Base {
+public:
+    Base() : _lk(&_opCtx, nsToDatabaseSubstring(ns()), MODE_X), _context(&_opCtx, ns()) {
+        _database = _context.db();
+        resetCollection();
+    }
+
+    ~Base() {
+        try {
+            WriteUnitOfWork wunit(&_opCtx);
+            uassertStatusOK(_database->dropCollection(&_opCtx, ns()));
+            wunit.commit();
+        } catch (...) {
+            FAIL("Exception while cleaning up collection");
+        }
+    }
+
+protected:
+    static const char* ns() {
+        return "unittests.insert_batch_tests";
+    }
+
+    /**
+     * Drops and recreates the collection, with an index on 'a' besides the _id index.
+     */
+    void resetCollection(bool uniqueA = false) {
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            if (_database->getCollection(&_opCtx, ns())) {
+                uassertStatusOK(_database->dropCollection(&_opCtx, ns()));
+            }
+            _collection = _database->createCollection(&_opCtx, ns());
+            wunit.commit();
+        }
+        ASSERT_OK(dbtests::createIndex(&_opCtx, ns(), BSON("a" << 1), uniqueA));
+    }
+
+    /**
+     * Inserts 'docs' through a single call to insertDocuments(), in one WriteUnitOfWork which is
+     * only committed if the insert succeeds.
+     */
+    Status insertBatch(const std::vector<InsertStatement>& docs) {
+        WriteUnitOfWork wunit(&_opCtx);
+        OpDebug* const nullOpDebug = nullptr;
+        Status status =
+            _collection->insertDocuments(&_opCtx, docs.begin(), docs.end(), nullOpDebug, false);
+        if (status.isOK())
+            wunit.commit();
+        return status;
+    }
+
+    IndexDescriptor* indexA() {
+        IndexDescriptor* desc =
+            _collection->getIndexCatalog()->findIndexByName(&_opCtx, "a_1");
+        ASSERT(desc);
+        return desc;
+    }
+
+    int64_t numKeys(IndexDescriptor* desc) {
+        int64_t numKeys = 0;
+        _collection->getIndexCatalog()->getIndex(desc)->validate(&_opCtx, &numKeys, nullptr);
+        return numKeys;
+    }
+
+    const ServiceContext::UniqueOperationContext _opCtxPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_opCtxPtr;
+    Lock::DBLock _lk;
+
+    OldClientContext _context;
+
+    Database* _database;
+    Collection* _collection;
+};
+
+/**
+ * The keys of a batch of documents are inserted out of document order, but every document still
+ * ends up in every index.
+ */
+class IndexesEveryDocument : public Base {
+public:
+    void run() {
+        const int kDocs = 100;
+        std::vector<InsertStatement> docs;
+        for (int i = 0; i < kDocs; ++i) {
+            docs.emplace_back(BSON("_id" << i << "a" << (kDocs - i)));
+        }
+        ASSERT_OK(insertBatch(docs));
+
+        ASSERT_EQUALS(kDocs, _collection->numRecords(&_opCtx));
+        ASSERT_EQUALS(kDocs, numKeys(_collection->getIndexCatalog()->findIdIndex(&_opCtx)));
+        ASSERT_EQUALS(kDocs, numKeys(indexA()));
+        ASSERT_FALSE(_collection->getIndexCatalog()->isMultikey(&_opCtx, indexA()));
+    }
+};
+
+/**
+ * A document with an array in the batch makes the index multikey.
+ */
+class SetsMultikey : public Base {
+public:
+    void run() {
+        std::vector<InsertStatement> docs;
+        docs.emplace_back(BSON("_id" << 0 << "a" << 1));
+        docs.emplace_back(BSON("_id" << 1 << "a" << BSON_ARRAY(2 << 3)));
+        docs.emplace_back(BSON("_id" << 2 << "a" << 4));
+        ASSERT_OK(insertBatch(docs));
+
+        ASSERT_EQUALS(4, numKeys(indexA()));
+        ASSERT_TRUE(_collection->getIndexCatalog()->isMultikey(&_opCtx, indexA()));
+    }
+};
+
+/**
+ * A duplicate key between two documents of the same batch fails the whole batch.
+ */
+class DuplicateKeyFailsBatch : public Base {
+public:
+    void run() {
+        resetCollection(true);
+
+        std::vector<InsertStatement> docs;
+        docs.emplace_back(BSON("_id" << 0 << "a" << 1));
+        docs.emplace_back(BSON("_id" << 1 << "a" << 2));
+        docs.emplace_back(BSON("_id" << 2 << "a" << 1));
+        ASSERT_EQUALS(ErrorCodes::DuplicateKey, insertBatch(docs));
+
+        ASSERT_EQUALS(0, _collection->numRecords(&_opCtx));
+        ASSERT_EQUALS(0, numKeys(indexA()));
+    }
+};
+
+/**
+ * Not a correctness test: logs how many small documents per second insertDocuments() sustains
+ * for a range of batch sizes, with the _id index and one secondary index.
+ */
+class Benchmark : public Base {
+public:
+    void run() {
+        const int kDocs = 20000;
+        for (int batchSize : {1, 10, 100, 1000}) {
+            resetCollection();
+
+            Timer timer;
+            std::vector<InsertStatement> docs;
+            for (int i = 0; i < kDocs; i += batchSize) {
+                docs.clear();
+                for (int j = i; j < std::min(i + batchSize, kDocs); ++j) {
+                    docs.emplace_back(BSON("_id" << j << "a" << (j % 97) << "s"
+                                                 << "abcdefghij"));
+                }
+                ASSERT_OK(insertBatch(docs));
+            }
+            const long long micros = std::max(timer.micros(), 1LL);
+
+            ASSERT_EQUALS(kDocs, _collection->numRecords(&_opCtx));
+            ASSERT_EQUALS(kDocs, numKeys(indexA()));
+            log() << "insertDocuments() with batches of " << batchSize << ": "
+                  << (kDocs * 1000000LL / micros) << " docs/sec";
+        }
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("insert_batch") {}
+
+    void setupTests() {
+        add<IndexesEveryDocument>();
+        add<SetsMultikey>();
+        add<DuplicateKeyFailsBatch>();
+        add<Benchmark>();
+    }
+};
+
+SuiteInstance<All> all;
+
+}  // namespace InsertBatchTests
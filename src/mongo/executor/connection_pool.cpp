@@ -32,6 +32,8 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <cmath>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
@@ -151,6 +153,27 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of requests waiting for a connection.
+     */
+    size_t queuedRequests(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the total number of requests that had to wait because the host was at
+     * maxInFlight.
+     */
+    size_t inFlightLimitedRequests(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the total time requests have spent waiting for a connection.
+     */
+    Milliseconds queueTime(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the number of connections predictive warm-up is currently keeping open.
+     */
+    size_t warmupTarget(const stdx::unique_lock<stdx::mutex>& lk);
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -184,10 +207,14 @@ private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, SharedPromise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t enqueued;
+        SharedPromise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -197,6 +224,8 @@ private:
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk);
 
+    void sampleDemand(const stdx::unique_lock<stdx::mutex>& lk);
+
     void shutdown();
 
     template <typename OwnershipPoolType>
@@ -228,6 +257,16 @@ private:
 
     size_t _created;
 
+    size_t _inFlightLimited;
+    Milliseconds _queueTime;
+
+    // Predictive warm-up state. The highest demand seen since the last sample is folded into
+    // _demandAverage once per warmupInterval, and _warmupTarget is the rounded-up average.
+    size_t _peakDemand;
+    double _demandAverage;
+    Date_t _lastDemandSample;
+    size_t _warmupTarget;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -260,6 +299,7 @@ constexpr Milliseconds ConnectionPool::kDefaultHostTimeout;
 size_t const ConnectionPool::kDefaultMaxConns = std::numeric_limits<size_t>::max();
 size_t const ConnectionPool::kDefaultMinConns = 1;
 size_t const ConnectionPool::kDefaultMaxConnecting = std::numeric_limits<size_t>::max();
+size_t const ConnectionPool::kDefaultMaxInFlight = std::numeric_limits<size_t>::max();
 constexpr Milliseconds ConnectionPool::kDefaultRefreshRequirement;
 constexpr Milliseconds ConnectionPool::kDefaultRefreshTimeout;
 
@@ -420,6 +460,10 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
                                      pool->refreshingConnections(lk)};
+        hostStats.queued = pool->queuedRequests(lk);
+        hostStats.inFlightLimited = pool->inFlightLimitedRequests(lk);
+        hostStats.queueTimeMillis = durationCount<Milliseconds>(pool->queueTime(lk));
+        hostStats.warmupTarget = pool->warmupTarget(lk);
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -458,6 +502,12 @@ ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAnd
       _inFulfillRequests(false),
       _inSpawnConnections(false),
       _created(0),
+      _inFlightLimited(0),
+      _queueTime(0),
+      _peakDemand(0),
+      _demandAverage(0),
+      _lastDemandSample(parent->_factory->now()),
+      _warmupTarget(0),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -486,21 +536,44 @@ size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<std
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
 
+size_t ConnectionPool::SpecificPool::queuedRequests(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _requests.size();
+}
+
+size_t ConnectionPool::SpecificPool::inFlightLimitedRequests(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    return _inFlightLimited;
+}
+
+Milliseconds ConnectionPool::SpecificPool::queueTime(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _queueTime;
+}
+
+size_t ConnectionPool::SpecificPool::warmupTarget(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _warmupTarget;
+}
+
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnection(
     const HostAndPort& hostAndPort, Milliseconds timeout, stdx::unique_lock<stdx::mutex> lk) {
     if (timeout < Milliseconds(0) || timeout > _parent->_options.refreshTimeout) {
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    const auto now = _parent->_factory->now();
+    const auto expiration = now + timeout;
 
     Promise<ConnectionHandle> promise;
     auto future = promise.getFuture();
 
-    _requests.push_back(make_pair(expiration, promise.share()));
+    _requests.push_back(Request{expiration, now, promise.share()});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
+    if (_checkedOutPool.size() >= _parent->_options.maxInFlight) {
+        ++_inFlightLimited;
+    }
+
     updateStateInLock();
+    sampleDemand(lk);
 
     spawnConnections(lk);
     fulfillRequests(lk);
@@ -515,6 +588,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
     auto conn = takeFromPool(_checkedOutPool, connPtr);
 
     updateStateInLock();
+    sampleDemand(lk);
 
     // Users are required to call indicateSuccess() or indicateFailure() before allowing
     // a connection to be returned. Otherwise, we have entered an unknown state.
@@ -537,8 +611,9 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
-            // If we already have minConnections, just let the connection lapse
+            std::max(_parent->_options.minConnections, _warmupTarget)) {
+            // If we already have minConnections (or as many as warm-up predicts we need), just
+            // let the connection lapse
             log() << "Ending idle connection to host " << _hostAndPort
                   << " because the pool meets constraints; " << openConnections(lk)
                   << " connections to that host remain open";
@@ -668,12 +743,20 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     // Update state to reflect the lack of requests
     updateStateInLock();
 
+    // When the connections were deliberately dropped (for instance after a stepdown) rather than
+    // lost to a failing host, start re-establishing the ones warm-up predicts we'll need right
+    // away instead of making the next burst of requests pay for them.
+    if (_warmupTarget && status.code() == ErrorCodes::PooledConnectionsDropped &&
+        _state != State::kInShutdown) {
+        spawnConnections(lk);
+    }
+
     // Drop the lock and process all of the requests
     // with the same failed status
     lk.unlock();
 
     for (auto& request : requestsToFail) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 }
 
@@ -688,6 +771,11 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
     auto guard = MakeGuard([&] { _inFulfillRequests = false; });
 
     while (_requests.size()) {
+        // Leave the remaining requests queued if the host already has as many connections checked
+        // out as it is allowed.
+        if (_checkedOutPool.size() >= _parent->_options.maxInFlight)
+            break;
+
         // _readyPool is an LRUCache, so its begin() object is the MRU item.
         auto iter = _readyPool.begin();
 
@@ -715,7 +803,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        _queueTime += _parent->_factory->now() - _requests.front().enqueued;
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -745,11 +834,15 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     _inSpawnConnections = true;
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections <= outstanding requests <= maxConnections. Requests held back by
+    // maxInFlight don't need a connection of their own, and warm-up may ask for more than
+    // are outstanding right now.
     auto target = [&] {
+        auto outstanding = std::min(_requests.size() + _checkedOutPool.size(),
+                                    _parent->_options.maxInFlight);
         return std::max(
             _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+            std::min(std::max(outstanding, _warmupTarget), _parent->_options.maxConnections));
     };
 
     // While all of our inflight connections are less than our target
@@ -803,6 +896,36 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     }
 }
 
+// Folds the current demand into the moving average that drives predictive warm-up
+void ConnectionPool::SpecificPool::sampleDemand(const stdx::unique_lock<stdx::mutex>& lk) {
+    const auto interval = _parent->_options.warmupInterval;
+    if (interval <= Milliseconds(0))
+        return;
+
+    // Each sample moves the average this far towards the peak demand seen since the last one.
+    constexpr double kSmoothing = 0.25;
+
+    _peakDemand = std::max(_peakDemand, _requests.size() + _checkedOutPool.size());
+
+    const auto now = _parent->_factory->now();
+    if (now - _lastDemandSample < interval)
+        return;
+
+    // Intervals that went by without any activity count as zero demand, so a host that has gone
+    // quiet lets its connections lapse again.
+    auto elapsed = durationCount<Milliseconds>(now - _lastDemandSample);
+    auto samples = std::min<int64_t>(elapsed / durationCount<Milliseconds>(interval), 64);
+    for (int64_t i = 0; i < samples; ++i) {
+        auto demand = (i == 0) ? _peakDemand : 0;
+        _demandAverage += kSmoothing * (demand - _demandAverage);
+    }
+
+    _lastDemandSample = now;
+    _peakDemand = _requests.size() + _checkedOutPool.size();
+    _warmupTarget = std::min(static_cast<size_t>(std::ceil(_demandAverage)),
+                             _parent->_options.maxConnections);
+}
+
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
     stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
@@ -869,16 +992,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.front().first;
+        _requestTimerExpiration = _requests.front().expiration;
 
-        auto timeout = _requests.front().first - _parent->_factory->now();
+        auto timeout = _requests.front().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -889,8 +1012,9 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.front();
 
-                    if (x.first <= now) {
-                        auto promise = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto promise = std::move(x.promise);
+                        _queueTime += now - x.enqueued;
                         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
                         _requests.pop_back();
 
@@ -76,6 +76,7 @@ public:
     static const size_t kDefaultMaxConns;
     static const size_t kDefaultMinConns;
     static const size_t kDefaultMaxConnecting;
+    static const size_t kDefaultMaxInFlight;
     static constexpr Milliseconds kDefaultRefreshRequirement = Milliseconds(60000);  // 1min
     static constexpr Milliseconds kDefaultRefreshTimeout = Milliseconds(20000);      // 20secs
 
@@ -104,6 +105,20 @@ public:
          */
         size_t maxConnecting = kDefaultMaxConnecting;
 
+        /**
+         * The maximum number of connections that may be checked out for a host at once. Requests
+         * beyond this limit wait in the pool's queue until a connection is returned.
+         */
+        size_t maxInFlight = kDefaultMaxInFlight;
+
+        /**
+         * How often each host's demand (connections checked out plus requests waiting) is folded
+         * into a moving average. When set, the pool keeps enough connections to meet the average
+         * open ahead of requests and re-establishes them right after they are dropped. Zero
+         * disables predictive warm-up so connections are only created on demand.
+         */
+        Milliseconds warmupInterval = Milliseconds(0);
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
@@ -35,6 +35,16 @@
 
 namespace mongo {
 namespace executor {
+namespace {
+
+void appendQueueStats(BSONObjBuilder& hostInfo, const ConnectionStatsPer& hostStats) {
+    hostInfo.appendNumber("queued", hostStats.queued);
+    hostInfo.appendNumber("inFlightLimited", hostStats.inFlightLimited);
+    hostInfo.appendNumber("queueTimeMillis", hostStats.queueTimeMillis);
+    hostInfo.appendNumber("warmupTarget", hostStats.warmupTarget);
+}
+
+}  // namespace
 
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
@@ -49,6 +59,10 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    queued += other.queued;
+    inFlightLimited += other.inFlightLimited;
+    queueTimeMillis += other.queueTimeMillis;
+    warmupTarget += other.warmupTarget;
 
     return *this;
 }
@@ -66,6 +80,7 @@ void ConnectionPoolStats::updateStatsForHost(std::string pool,
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
     totalRefreshing += newStats.refreshing;
+    totalQueued += newStats.queued;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
@@ -73,6 +88,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    result.appendNumber("totalQueued", totalQueued);
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -83,6 +99,10 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolInfo.appendNumber("poolQueued", poolStats.queued);
+            poolInfo.appendNumber("poolInFlightLimited", poolStats.inFlightLimited);
+            poolInfo.appendNumber("poolQueueTimeMillis", poolStats.queueTimeMillis);
+            poolInfo.appendNumber("poolWarmupTarget", poolStats.warmupTarget);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +110,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                appendQueueStats(hostInfo, hostStats);
             }
         }
     }
@@ -102,6 +123,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            appendQueueStats(hostInfo, hostStats);
         }
     }
 }
@@ -49,6 +49,15 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // Requests currently waiting for a connection.
+    size_t queued = 0u;
+    // Requests that had to wait because their host was at its in-flight limit.
+    size_t inFlightLimited = 0u;
+    // Total time requests have spent waiting for a connection.
+    size_t queueTimeMillis = 0u;
+    // Number of connections predictive warm-up is keeping open.
+    size_t warmupTarget = 0u;
 };
 
 /**
@@ -65,6 +74,7 @@ struct ConnectionPoolStats {
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
+    size_t totalQueued = 0u;
 
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -807,6 +808,101 @@ TEST_F(ConnectionPoolTest, maxConnectingWithMultipleRefresh) {
     }
 }
 
+/**
+ * Verify that maxInFlight holds requests in the queue until a connection is returned
+ */
+TEST_F(ConnectionPoolTest, maxInFlightRespected) {
+    ConnectionPool::Options options;
+    options.maxInFlight = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    ConnectionPool::ConnectionHandle conn1;
+    ConnectionPool::ConnectionHandle conn2;
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn1 = std::move(swConn.getValue());
+             });
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn2 = std::move(swConn.getValue());
+             });
+
+    // Only the first request is in flight, and no connection was opened for the second
+    ASSERT(conn1);
+    ASSERT(!conn2);
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 1u);
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    ASSERT_EQ(stats.totalQueued, 1u);
+    ASSERT_EQ(stats.statsByHost[HostAndPort()].inFlightLimited, 1u);
+
+    // Returning the first connection hands it to the queued request
+    ConnectionPool::ConnectionInterface* conn1Ptr = conn1.get();
+    doneWith(conn1);
+    conn1.reset();
+
+    ASSERT_EQ(conn1Ptr, conn2.get());
+    doneWith(conn2);
+}
+
+/**
+ * Verify that predictive warm-up reopens the connections a host has been using after they are
+ * dropped
+ */
+TEST_F(ConnectionPoolTest, warmupReestablishesDroppedConnections) {
+    ConnectionPool::Options options;
+    options.warmupInterval = Seconds(1);
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // Keep three connections checked out at once over several sampling intervals
+    for (int round = 0; round < 4; ++round) {
+        std::vector<ConnectionPool::ConnectionHandle> conns;
+        for (int i = 0; i < 3; ++i) {
+            // Later rounds reuse the connections returned by the first one
+            if (round == 0)
+                ConnectionImpl::pushSetup(Status::OK());
+            pool.get(HostAndPort(),
+                     Milliseconds(5000),
+                     [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                         ASSERT(swConn.isOK());
+                         conns.push_back(std::move(swConn.getValue()));
+                     });
+        }
+        ASSERT_EQ(conns.size(), 3u);
+
+        now += Seconds(1);
+        PoolImpl::setNow(now);
+        for (auto& conn : conns) {
+            doneWith(conn);
+        }
+    }
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    ASSERT_EQ(stats.statsByHost[HostAndPort()].warmupTarget, 3u);
+
+    // Dropping the pool's connections immediately starts setting up replacements for all three
+    pool.dropConnections(HostAndPort());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 3u);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 3u);
+}
+
 /**
  * Verify that minConnections is respected
  */
@@ -33,14 +33,43 @@
 #include "mongo/executor/network_interface_tl.h"
 
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace executor {
+namespace {
+
+// The maximum number of commands NetworkInterfaceTL pipelines on one shared connection to a host.
+// Commands beyond it check out a connection of their own, as do commands run on a baton. Zero
+// turns multiplexing off.
+MONGO_EXPORT_SERVER_PARAMETER(networkInterfaceMaxPipelinedRequests, int, 0);
+
+/**
+ * Returns whether the command may be pipelined on a shared connection. Only commands which the
+ * remote answers right away are, so that a command which blocks on the remote, e.g. a getMore
+ * waiting for data or a write waiting for its write concern, doesn't hold up the replies to the
+ * commands pipelined behind it.
+ */
+bool isPipelinableCommand(const BSONObj& cmdObj) {
+    static const StringMap<bool> kPipelinableCommands = {{"buildInfo", true},
+                                                         {"buildinfo", true},
+                                                         {"getShardVersion", true},
+                                                         {"isMaster", true},
+                                                         {"ismaster", true},
+                                                         {"ping", true},
+                                                         {"replSetHeartbeat", true},
+                                                         {"replSetUpdatePosition", true}};
+    return !cmdObj.isEmpty() &&
+        kPipelinableCommands.find(cmdObj.firstElementFieldName()) != kPipelinableCommands.end();
+}
+
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -168,6 +197,26 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         state->deadline = state->start + state->request.timeout;
     }
 
+    // Short commands that don't run on a baton may share a connection with other commands to the
+    // same host, as long as that connection doesn't already have too many commands pipelined on it.
+    const auto maxPipelined = networkInterfaceMaxPipelinedRequests.load();
+    if (!baton && maxPipelined > 0 && isPipelinableCommand(state->request.cmdObj)) {
+        if (auto attached = _attachMultiplexed(state, maxPipelined)) {
+            std::move(*attached).getAsync([this, state, onFinish](Status status) {
+                auto run = [&] {
+                    if (!status.isOK()) {
+                        auto abandoned = state->done.swap(true);
+                        _finishMultiplexed(state->multiplexed, abandoned, Status::OK());
+                        uassertStatusOK(status);
+                    }
+                    return _onAcquireMultiplexed(state);
+                };
+                _finishCommand(makeReadyFutureWith(run), state, onFinish);
+            });
+            return Status::OK();
+        }
+    }
+
     // Interacting with the connection pool can involve more work than just getting a connection
     // out.  In particular, we can end up having to spin up new connections, and fulfilling promises
     // for other requesters.  Returning connections has the same issue.
@@ -196,27 +245,12 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
 
     auto remainingWork = [this, state, baton, onFinish](
         StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) {
-        makeReadyFutureWith(
-            [&] { return _onAcquireConn(state, std::move(*uassertStatusOK(swConn)), baton); })
-            .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
-                // The TransportLayer has, for historical reasons returned SocketException for
-                // network errors, but sharding assumes HostUnreachable on network errors.
-                if (error == ErrorCodes::SocketException) {
-                    error = Status(ErrorCodes::HostUnreachable, error.reason());
-                }
-                return error;
-            })
-            .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
-                auto duration = now() - state->start;
-                if (!response.isOK()) {
-                    onFinish(RemoteCommandResponse(response.getStatus(), duration));
-                } else {
-                    const auto& rs = response.getValue();
-                    LOG(2) << "Request " << state->request.id << " finished with response: "
-                           << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
-                    onFinish(rs);
-                }
-            });
+        _finishCommand(makeReadyFutureWith([&] {
+                           return _onAcquireConn(
+                               state, std::move(*uassertStatusOK(swConn)), baton);
+                       }),
+                       state,
+                       onFinish);
     };
 
     if (baton) {
@@ -328,6 +362,256 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireConn(
     return std::move(state->mergedFuture);
 }
 
+void NetworkInterfaceTL::_finishCommand(Future<RemoteCommandResponse> future,
+                                        std::shared_ptr<CommandState> state,
+                                        const RemoteCommandCompletionFn& onFinish) {
+    std::move(future)
+        .onError([](Status error) -> StatusWith<RemoteCommandResponse> {
+            // The TransportLayer has, for historical reasons returned SocketException for
+            // network errors, but sharding assumes HostUnreachable on network errors.
+            if (error == ErrorCodes::SocketException) {
+                error = Status(ErrorCodes::HostUnreachable, error.reason());
+            }
+            return error;
+        })
+        .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
+            auto duration = now() - state->start;
+            if (!response.isOK()) {
+                onFinish(RemoteCommandResponse(response.getStatus(), duration));
+            } else {
+                const auto& rs = response.getValue();
+                LOG(2) << "Request " << state->request.id << " finished with response: "
+                       << redact(rs.isOK() ? rs.data.toString() : rs.status.toString());
+                onFinish(rs);
+            }
+        });
+}
+
+boost::optional<Future<void>> NetworkInterfaceTL::_attachMultiplexed(
+    const std::shared_ptr<CommandState>& state, size_t maxPipelined) {
+    stdx::unique_lock<stdx::mutex> lk(_multiplexedMutex);
+    auto& mconn = _multiplexed[state->request.target];
+    if (mconn && mconn->outstanding >= maxPipelined) {
+        return boost::none;
+    }
+
+    std::shared_ptr<MultiplexedConnection> toAcquire;
+    if (!mconn) {
+        mconn = std::make_shared<MultiplexedConnection>(state->request.target);
+        toAcquire = mconn;
+    }
+
+    mconn->outstanding++;
+    mconn->live++;
+    state->multiplexed = mconn;
+
+    if (mconn->conn) {
+        return Future<void>::makeReady();
+    }
+
+    Promise<void> promise;
+    auto future = promise.getFuture();
+    mconn->waiters.push_back(std::move(promise));
+    lk.unlock();
+
+    if (toAcquire) {
+        _acquireMultiplexed(std::move(toAcquire), state->request);
+    }
+
+    return std::move(future);
+}
+
+void NetworkInterfaceTL::_acquireMultiplexed(std::shared_ptr<MultiplexedConnection> mconn,
+                                             const RemoteCommandRequest& request) {
+    // As in startCommand(), the pool is only touched from the reactor thread.
+    auto connFuture = _reactor->execute([this, request] {
+        return makeReadyFutureWith(
+                   [this, request] { return _pool->get(request.target, request.timeout); })
+            .then([this](ConnectionPool::ConnectionHandle conn) {
+                auto deleter = conn.get_deleter();
+                return std::make_shared<CommandState::ConnHandle>(
+                    conn.release(), CommandState::Deleter{deleter, _reactor});
+            });
+    });
+
+    std::move(connFuture)
+        .getAsync([this, mconn](StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) {
+            std::vector<Promise<void>> waiters;
+            {
+                stdx::lock_guard<stdx::mutex> lk(_multiplexedMutex);
+                waiters.swap(mconn->waiters);
+                if (swConn.isOK()) {
+                    mconn->conn = std::move(swConn.getValue());
+                } else {
+                    LOG(2) << "Failed to get a shared connection to " << mconn->target << ": "
+                           << swConn.getStatus();
+                    mconn->status = swConn.getStatus();
+                    _retireMultiplexedInLock(mconn);
+                }
+            }
+
+            for (auto& waiter : waiters) {
+                if (swConn.isOK()) {
+                    waiter.emplaceValue();
+                } else {
+                    waiter.setError(swConn.getStatus());
+                }
+            }
+        });
+}
+
+// Like _onAcquireConn(), this is only called from within a future callback, so throwing is
+// equivalent to returning a ready Future with a not-OK status.
+Future<RemoteCommandResponse> NetworkInterfaceTL::_onAcquireMultiplexed(
+    std::shared_ptr<CommandState> state) {
+    auto mconn = state->multiplexed;
+
+    // Commands that were canceled or ran out of time while the connection was being checked out
+    // are never sent.
+    auto failBeforeSend = [&](Status status) {
+        _finishMultiplexed(mconn, state->done.swap(true), Status::OK());
+        uassertStatusOK(status);
+    };
+
+    if (state->done.load()) {
+        failBeforeSend({ErrorCodes::CallbackCanceled, "Command was canceled"});
+    }
+
+    if (state->deadline != RemoteCommandRequest::kNoExpirationDate) {
+        auto nowVal = now();
+        if (nowVal >= state->deadline) {
+            failBeforeSend({ErrorCodes::NetworkInterfaceExceededTimeLimit,
+                            str::stream() << "Remote command timed out while waiting to get a "
+                                             "shared connection, took "
+                                          << (nowVal - state->start)
+                                          << ", timeout was set to "
+                                          << state->request.timeout});
+        }
+
+        state->timer = _reactor->makeTimer();
+        state->timer->waitUntil(state->deadline).getAsync([this, state](Status status) {
+            if (status == ErrorCodes::CallbackCanceled) {
+                invariant(state->done.load());
+                return;
+            }
+
+            if (state->done.swap(true)) {
+                return;
+            }
+
+            LOG(2) << "Request " << state->request.id << " timed out"
+                   << ", deadline was " << state->deadline << ", op was "
+                   << redact(state->request.toString());
+            state->promise.setError(
+                Status(ErrorCodes::NetworkInterfaceExceededTimeLimit, "timed out"));
+
+            _abandonMultiplexed(state->multiplexed);
+        });
+    }
+
+    auto client = checked_cast<connection_pool_tl::TLConnection*>(mconn->conn->get())->client();
+    client->runPipelinedCommandRequest(state->request)
+        .then([this, mconn](RemoteCommandResponse response) {
+            if (_metadataHook && response.status.isOK()) {
+                response.status = _metadataHook->readReplyMetadata(
+                    nullptr, mconn->target.toString(), response.metadata);
+            }
+
+            return RemoteCommandResponse(std::move(response));
+        })
+        .getAsync([this, state, mconn](StatusWith<RemoteCommandResponse> swr) {
+            _eraseInUseConn(state->cbHandle);
+
+            // A command which failed on the remote leaves the connection intact, only a failure to
+            // exchange the messages with the remote has to take it out of service.
+            auto abandoned = state->done.swap(true);
+            _finishMultiplexed(mconn, abandoned, swr.getStatus());
+            if (abandoned)
+                return;
+
+            if (state->timer) {
+                state->timer->cancel();
+            }
+
+            state->promise.setFromStatusWith(std::move(swr));
+        });
+
+    return std::move(state->mergedFuture);
+}
+
+void NetworkInterfaceTL::_finishMultiplexed(const std::shared_ptr<MultiplexedConnection>& mconn,
+                                            bool abandoned,
+                                            Status status) {
+    std::shared_ptr<CommandState::ConnHandle> conn;
+    Status connStatus = Status::OK();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexedMutex);
+        invariant(mconn->outstanding > 0);
+        mconn->outstanding--;
+        if (!abandoned) {
+            invariant(mconn->live > 0);
+            mconn->live--;
+        }
+
+        if (!status.isOK()) {
+            if (mconn->status.isOK()) {
+                mconn->status = std::move(status);
+            }
+            _retireMultiplexedInLock(mconn);
+        }
+
+        if (mconn->outstanding > 0) {
+            return;
+        }
+
+        // No more replies are due on the connection, so hand it back to the pool.
+        _retireMultiplexedInLock(mconn);
+        conn = std::move(mconn->conn);
+        connStatus = mconn->status;
+    }
+
+    if (!conn) {
+        return;
+    }
+
+    if (connStatus.isOK()) {
+        (*conn)->indicateSuccess();
+    } else {
+        (*conn)->indicateFailure(connStatus);
+    }
+}
+
+void NetworkInterfaceTL::_abandonMultiplexed(const std::shared_ptr<MultiplexedConnection>& mconn) {
+    std::shared_ptr<CommandState::ConnHandle> conn;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_multiplexedMutex);
+        invariant(mconn->live > 0);
+        mconn->live--;
+
+        // Commands started from now on shouldn't queue up on the remote behind one that timed out
+        // or was canceled.
+        _retireMultiplexedInLock(mconn);
+
+        if (mconn->live == 0) {
+            conn = mconn->conn;
+        }
+    }
+
+    // If nobody wants the replies still due on the connection there's no point waiting for them.
+    // Canceling fails the outstanding reads, after which the connection is dropped.
+    if (conn) {
+        checked_cast<connection_pool_tl::TLConnection*>(conn->get())->client()->cancel();
+    }
+}
+
+void NetworkInterfaceTL::_retireMultiplexedInLock(
+    const std::shared_ptr<MultiplexedConnection>& mconn) {
+    auto it = _multiplexed.find(mconn->target);
+    if (it != _multiplexed.end() && it->second == mconn) {
+        _multiplexed.erase(it);
+    }
+}
+
 void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbHandle) {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
     _inProgress.erase(cbHandle);
@@ -355,6 +639,8 @@ void NetworkInterfaceTL::cancelCommand(const TaskExecutor::CallbackHandle& cbHan
     if (state->conn) {
         auto client = checked_cast<connection_pool_tl::TLConnection*>(state->conn.get());
         client->client()->cancel(baton);
+    } else if (state->multiplexed) {
+        _abandonMultiplexed(state->multiplexed);
     }
 }
 
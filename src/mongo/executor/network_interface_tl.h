@@ -29,6 +29,9 @@
 #pragma once
 
 #include <deque>
+#include <vector>
+
+#include <boost/optional.hpp>
 
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
@@ -77,6 +80,8 @@ public:
     void dropConnections(const HostAndPort& hostAndPort) override;
 
 private:
+    struct MultiplexedConnection;
+
     struct CommandState {
         CommandState(RemoteCommandRequest request_, TaskExecutor::CallbackHandle cbHandle_)
             : request(std::move(request_)), cbHandle(std::move(cbHandle_)) {}
@@ -100,15 +105,62 @@ private:
         ConnHandle conn;
         std::unique_ptr<transport::ReactorTimer> timer;
 
+        // Set instead of conn when the command is pipelined on a connection shared with other
+        // commands to the same host.
+        std::shared_ptr<MultiplexedConnection> multiplexed;
+
         AtomicBool done;
         Promise<RemoteCommandResponse> promise;
         Future<RemoteCommandResponse> mergedFuture;
     };
 
+    /**
+     * A pooled connection that several commands to the same host pipeline their requests on.
+     * It is checked out of the pool when the first command is attached to it and returned once
+     * no replies are expected on it anymore.
+     */
+    struct MultiplexedConnection {
+        explicit MultiplexedConnection(HostAndPort target_) : target(std::move(target_)) {}
+
+        const HostAndPort target;
+
+        // Empty until the connection has been checked out of the pool.
+        std::shared_ptr<CommandState::ConnHandle> conn;
+        std::vector<Promise<void>> waiters;
+
+        // Commands attached to this connection whose replies haven't been received yet, and how
+        // many of those are still wanted by their callers.
+        size_t outstanding = 0;
+        size_t live = 0;
+
+        // The first network error seen on the connection.
+        Status status = Status::OK();
+    };
+
     void _eraseInUseConn(const TaskExecutor::CallbackHandle& handle);
     Future<RemoteCommandResponse> _onAcquireConn(std::shared_ptr<CommandState> state,
                                                  CommandState::ConnHandle conn,
                                                  const transport::BatonHandle& baton);
+    void _finishCommand(Future<RemoteCommandResponse> future,
+                        std::shared_ptr<CommandState> state,
+                        const RemoteCommandCompletionFn& onFinish);
+
+    boost::optional<Future<void>> _attachMultiplexed(const std::shared_ptr<CommandState>& state,
+                                                     size_t maxPipelined);
+    void _acquireMultiplexed(std::shared_ptr<MultiplexedConnection> mconn,
+                             const RemoteCommandRequest& request);
+    Future<RemoteCommandResponse> _onAcquireMultiplexed(std::shared_ptr<CommandState> state);
+
+    /**
+     * Detaches a command from its shared connection. 'status' is the outcome of exchanging the
+     * command's messages with the remote, not of the command itself; an error retires the
+     * connection, and the pool drops it once no more replies are due on it.
+     */
+    void _finishMultiplexed(const std::shared_ptr<MultiplexedConnection>& mconn,
+                            bool abandoned,
+                            Status status);
+    void _abandonMultiplexed(const std::shared_ptr<MultiplexedConnection>& mconn);
+    void _retireMultiplexedInLock(const std::shared_ptr<MultiplexedConnection>& mconn);
 
     std::string _instanceName;
     ServiceContext* _svcCtx;
@@ -129,6 +181,9 @@ private:
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<CommandState>> _inProgress;
     stdx::unordered_set<std::shared_ptr<transport::ReactorTimer>> _inProgressAlarms;
 
+    stdx::mutex _multiplexedMutex;
+    stdx::unordered_map<HostAndPort, std::shared_ptr<MultiplexedConnection>> _multiplexed;
+
     stdx::mutex _mutex;
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
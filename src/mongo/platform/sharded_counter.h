@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/new.h"
+
+namespace mongo {
+
+/**
+ * A counter for statistics that are incremented far more often than they are read, such as the
+ * opcounters. Each thread increments its own cache line sized shard of the counter, so threads
+ * running on different cores do not contend for the same cache line, and a read sums all of the
+ * shards.
+ *
+ * Threads are assigned to shards in turn the first time they use any sharded counter. Increments
+ * are atomic, so threads that share a shard still count correctly. A read is not a consistent
+ * snapshot: increments made concurrently with it may or may not be included.
+ */
+template <typename T>
+class ShardedCounter {
+public:
+    using WordType = T;
+
+    static constexpr size_t kNumShards = 32;
+
+    /**
+     * Adds 'n' to the calling thread's shard.
+     */
+    void add(WordType n = 1) {
+        _shards[currentShard()].value.fetchAndAdd(n);
+    }
+
+    /**
+     * Returns the sum of all of the shards.
+     */
+    WordType load() const {
+        WordType sum = 0;
+        for (const auto& shard : _shards) {
+            sum += shard.value.loadRelaxed();
+        }
+        return sum;
+    }
+
+    /**
+     * Sets the counter to 'value'. Increments that race with this may be lost.
+     */
+    void store(WordType value) {
+        for (auto& shard : _shards) {
+            shard.value.store(0);
+        }
+        _shards[0].value.store(value);
+    }
+
+    operator WordType() const {
+        return load();
+    }
+
+    /**
+     * Returns the shard the calling thread increments.
+     */
+    static size_t currentShard() {
+        static AtomicWord<unsigned> nextShard{0};
+        static thread_local size_t shard = kNumShards;
+        if (MONGO_unlikely(shard == kNumShards)) {
+            shard = nextShard.fetchAndAdd(1) % kNumShards;
+        }
+        return shard;
+    }
+
+private:
+    struct alignas(stdx::hardware_destructive_interference_size) Shard {
+        AtomicWord<WordType> value{0};
+    };
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+template <typename T>
+constexpr size_t ShardedCounter<T>::kNumShards;
+
+using ShardedCounter64 = ShardedCounter<long long>;
+
+}  // namespace mongo
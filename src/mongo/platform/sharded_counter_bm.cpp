@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/sharded_counter.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 64;
+
+// Both counters are shared by all of the benchmark threads, as the server's statistics are.
+CacheAligned<AtomicInt64> atomicCounter{0};
+ShardedCounter64 shardedCounter;
+
+void BM_AtomicWordAdd(benchmark::State& state) {
+    for (auto _ : state) {
+        atomicCounter.fetchAndAdd(1);
+    }
+}
+
+void BM_ShardedCounterAdd(benchmark::State& state) {
+    for (auto _ : state) {
+        shardedCounter.add(1);
+    }
+}
+
+void BM_AtomicWordLoad(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(atomicCounter.load());
+    }
+}
+
+void BM_ShardedCounterLoad(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shardedCounter.load());
+    }
+}
+
+BENCHMARK(BM_AtomicWordAdd)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_ShardedCounterAdd)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_AtomicWordLoad);
+BENCHMARK(BM_ShardedCounterLoad);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/sharded_counter.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(ShardedCounterTest, AddLoadAndStore) {
+    ShardedCounter64 counter;
+    ASSERT_EQ(counter.load(), 0);
+
+    counter.add();
+    counter.add(41);
+    ASSERT_EQ(counter.load(), 42);
+    ASSERT_EQ(static_cast<long long>(counter), 42);
+
+    counter.store(7);
+    ASSERT_EQ(counter.load(), 7);
+}
+
+TEST(ShardedCounterTest, ThreadsStayOnTheirShard) {
+    const auto shard = ShardedCounter64::currentShard();
+    ASSERT_LT(shard, ShardedCounter64::kNumShards);
+    ASSERT_EQ(ShardedCounter64::currentShard(), shard);
+}
+
+TEST(ShardedCounterTest, ConcurrentAddsAreAllCounted) {
+    constexpr int kThreads = 2 * ShardedCounter64::kNumShards + 1;
+    constexpr int kAddsPerThread = 10000;
+
+    ShardedCounter64 counter;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < kAddsPerThread; j++) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(counter.load(), static_cast<long long>(kThreads) * kAddsPerThread);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -111,6 +111,30 @@ void ChunkInfo::clearBytesWritten() {
     _dataWritten = 0;
 }
 
+void ChunkInfo::addPendingWriteHeat(uint64_t bytes) {
+    _pendingWriteBytes.fetchAndAdd(bytes);
+    _pendingWriteOps.fetchAndAdd(1);
+}
+
+boost::optional<ChunkInfo::PendingWriteHeat> ChunkInfo::takePendingWriteHeat(
+    Date_t now, Milliseconds interval) {
+    const long long lastTakenMillis = _pendingWriteHeatTakenMillis.load();
+    if (now.toMillisSinceEpoch() - lastTakenMillis < durationCount<Milliseconds>(interval)) {
+        return boost::none;
+    }
+
+    if (_pendingWriteHeatTakenMillis.compareAndSwap(lastTakenMillis,
+                                                    now.toMillisSinceEpoch()) != lastTakenMillis) {
+        return boost::none;
+    }
+
+    // Writes which land between the two swaps are only split between this and the next interval
+    PendingWriteHeat pending;
+    pending.bytes = _pendingWriteBytes.swap(0);
+    pending.numWrites = _pendingWriteOps.swap(0);
+    return pending;
+}
+
 bool ChunkInfo::shouldSplit(uint64_t desiredChunkSize, bool minIsInf, bool maxIsInf) const {
     // If this chunk is at either end of the range, trigger auto-split at 10% less data written in
     // order to trigger the top-chunk optimization.
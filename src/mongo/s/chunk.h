@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -41,6 +43,14 @@ class BSONObj;
  */
 class ChunkInfo {
 public:
+    /**
+     * Writes to the chunk, which were not yet passed on to the shard's write heat tracker.
+     */
+    struct PendingWriteHeat {
+        uint64_t bytes;
+        uint64_t numWrites;
+    };
+
     explicit ChunkInfo(const ChunkType& from);
 
     const BSONObj& getMin() const {
@@ -83,6 +93,19 @@ public:
     uint64_t addBytesWritten(uint64_t bytesWrittenIncrement);
     void clearBytesWritten();
 
+    /**
+     * Accounts for a write of 'bytes' to this chunk. Only uses atomic counters, so that the write
+     * rate of a chunk can be tracked on every write without serializing the writers.
+     */
+    void addPendingWriteHeat(uint64_t bytes);
+
+    /**
+     * Returns the writes accounted for by addPendingWriteHeat since they were last taken and
+     * resets them, if they were last taken at least 'interval' before 'now'. Otherwise returns
+     * boost::none, so that only one writer per interval passes them on.
+     */
+    boost::optional<PendingWriteHeat> takePendingWriteHeat(Date_t now, Milliseconds interval);
+
     bool shouldSplit(uint64_t desiredChunkSize, bool minIsInf, bool maxIsInf) const;
 
     /**
@@ -105,6 +128,12 @@ private:
 
     // Statistics for the approximate data written to this chunk
     mutable uint64_t _dataWritten;
+
+    // Writes not yet passed on to the write heat tracker and when they were last taken, in
+    // milliseconds since the epoch
+    AtomicUInt64 _pendingWriteBytes;
+    AtomicUInt64 _pendingWriteOps;
+    AtomicInt64 _pendingWriteHeatTakenMillis;
 };
 
 class Chunk {
@@ -167,6 +196,17 @@ public:
         _chunkInfo.clearBytesWritten();
     }
 
+    /**
+     * Accumulate and take the writes to this chunk, which are passed on to the write heat tracker.
+     */
+    void addPendingWriteHeat(uint64_t bytes) {
+        _chunkInfo.addPendingWriteHeat(bytes);
+    }
+    boost::optional<ChunkInfo::PendingWriteHeat> takePendingWriteHeat(Date_t now,
+                                                                      Milliseconds interval) {
+        return _chunkInfo.takePendingWriteHeat(now, interval);
+    }
+
     bool shouldSplit(uint64_t desiredChunkSize, bool minIsInf, bool maxIsInf) const {
         return _chunkInfo.shouldSplit(desiredChunkSize, minIsInf, maxIsInf);
     }
@@ -98,6 +98,14 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
 
+// Limits how many connections one pool may have checked out to a single host at a time; requests
+// beyond it queue in the pool. -1 leaves only ShardingTaskExecutorPoolMaxSize in effect.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolMaxInFlight, int, -1);
+
+// How often pools sample per-host demand to predict how many connections to keep warm. 0 turns
+// predictive warm-up off.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolWarmupIntervalMS, int, 0);
+
 namespace {
 
 using executor::NetworkInterface;
@@ -193,6 +201,10 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.maxInFlight = (ShardingTaskExecutorPoolMaxInFlight != -1)
+        ? ShardingTaskExecutorPoolMaxInFlight
+        : ConnectionPool::kDefaultMaxInFlight;
+    connPoolOptions.warmupInterval = Milliseconds(ShardingTaskExecutorPoolWarmupIntervalMS);
 
     if (connPoolOptions.refreshRequirement <= connPoolOptions.refreshTimeout) {
         auto newRefreshTimeout = connPoolOptions.refreshRequirement - Milliseconds(1);
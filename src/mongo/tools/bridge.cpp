@@ -85,6 +85,18 @@ boost::optional<HostAndPort> extractHostInfo(const OpMsgRequest& request) {
     return boost::none;
 }
 
+/**
+ * Returns whether 'response' is part of an OP_MSG exhaust stream which 'dest' continues sending.
+ */
+bool isMoreToComeReply(const Message& response) {
+    if (response.operation() == dbCompressed) {
+        MessageCompressorManager compressorMgr;
+        return OpMsg::isFlagSet(uassertStatusOK(compressorMgr.decompressMessage(response)),
+                                OpMsg::kMoreToCome);
+    }
+    return OpMsg::isFlagSet(response, OpMsg::kMoreToCome);
+}
+
 ServiceContextRegistrar serviceContextCreator([]() {
     return std::make_unique<ServiceContextNoop>();
 });
@@ -267,6 +279,16 @@ DbResponse ServiceEntryPointBridge::handleRequest(OperationContext* opCtx, const
     auto& dest = ProxiedConnection::get(source);
     auto brCtx = BridgeContext::get();
 
+    if (dest.inExhaust() && request.operation() == dbMsg) {
+        // Keep relaying the batches of an OP_MSG exhaust stream until 'dest' sends the last one.
+        auto response = uassertStatusOK(dest->sourceMessage());
+        if (isMoreToComeReply(response)) {
+            return {std::move(response), {}, OpMsg::parse(request).body.getOwned()};
+        }
+        dest.setExhaust(false);
+        return {std::move(response)};
+    }
+
     if (dest.inExhaust()) {
         DbMessage dbm(request);
 
@@ -385,6 +407,9 @@ DbResponse ServiceEntryPointBridge::handleRequest(OperationContext* opCtx, const
             if (dest.inExhaust()) {
                 exhaustNS = d.getns();
             }
+        } else if (request.operation() == dbMsg && isMoreToComeReply(response)) {
+            dest.setExhaust(true);
+            return {std::move(response), {}, cmdRequest->body.getOwned()};
         } else {
             dest.setExhaust(false);
         }
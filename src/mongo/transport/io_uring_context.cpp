@@ -0,0 +1,795 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring_context.h"
+
+#include <asio.hpp>
+
+#ifdef MONGO_CONFIG_HAVE_LINUX_IO_URING
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/asio_utils.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+
+#ifdef MONGO_CONFIG_HAVE_LINUX_IO_URING
+
+namespace {
+
+// The number of entries of the submission ring of each context. The completion ring is four times
+// larger, because all the sessions of a reactor can have a read outstanding at the same time.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ioUringQueueDepth, int, 1024);
+
+// The number of buffers registered with each context for receiving messages. Registered memory is
+// locked and counts against RLIMIT_MEMLOCK, so if the registration fails reads are done directly
+// into the message buffers instead.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ioUringRegisteredBuffers, int, 64);
+
+constexpr size_t kFixedBufferSize = 16 * 1024;
+
+// The user data of submissions, whose completions are not tied to any operation
+constexpr uint64_t kNoOperation = 0;
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned opcode, const void* arg, unsigned numArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, ringFd, opcode, arg, numArgs));
+}
+
+// The ring indexes are shared with the kernel, which reads and writes them concurrently
+unsigned loadAcquire(const unsigned* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned* ptr, unsigned value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+}  // namespace
+
+struct IoUringContext::Ring {
+    ~Ring() {
+        if (eventDescriptor) {
+            std::error_code ec;
+            eventDescriptor->cancel(ec);
+        }
+        eventDescriptor.reset();
+
+        if (fixedBuffers)
+            ::munmap(fixedBuffers, fixedBuffersSize);
+        if (sqes)
+            ::munmap(sqes, sqesSize);
+        if (cqRing)
+            ::munmap(cqRing, cqRingSize);
+        if (sqRing)
+            ::munmap(sqRing, sqRingSize);
+        if (ringFd >= 0)
+            ::close(ringFd);
+    }
+
+    int ringFd = -1;
+
+    void* sqRing = nullptr;
+    size_t sqRingSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqEntries = 0;
+
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+
+    void* cqRing = nullptr;
+    size_t cqRingSize = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    // Number of entries added to the submission ring, which have not been submitted yet
+    unsigned pendingSubmissions = 0;
+
+    char* fixedBuffers = nullptr;
+    size_t fixedBuffersSize = 0;
+
+    // Wraps the eventfd, which the kernel signals whenever completions are posted
+    std::unique_ptr<asio::posix::stream_descriptor> eventDescriptor;
+};
+
+struct IoUringContext::Operation {
+    enum class Type { kRecv, kSend };
+
+    uint64_t id = 0;
+    Type type = Type::kRecv;
+    int fd = -1;
+    char* buf = nullptr;
+    size_t len = 0;
+    size_t done = 0;
+
+    // Index of the registered buffer the submitted read is done into or -1 if none
+    int fixedBuffer = -1;
+
+    // Whether the operation is waiting for the socket to become ready after it returned EAGAIN
+    bool polling = false;
+
+    // Whether the operation is waiting for space in the submission ring
+    bool deferred = false;
+
+    bool canceled = false;
+
+    Promise<void> promise;
+};
+
+bool IoUringContext::isSupported() {
+    static const bool supported = [] {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        const int ringFd = ioUringSetup(2, &params);
+        if (ringFd < 0) {
+            LOG(1) << "io_uring is not available: " << errnoWithDescription();
+            return false;
+        }
+        const auto guard = MakeGuard([ringFd] { ::close(ringFd); });
+
+        const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+        std::vector<char> probeBuffer(probeSize, 0);
+        auto probe = reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+        if (ioUringRegister(ringFd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+            LOG(1) << "Unable to probe io_uring operations: " << errnoWithDescription();
+            return false;
+        }
+
+        for (auto op : {IORING_OP_RECV,
+                        IORING_OP_SEND,
+                        IORING_OP_READ_FIXED,
+                        IORING_OP_POLL_ADD,
+                        IORING_OP_ASYNC_CANCEL}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                LOG(1) << "io_uring operation " << static_cast<int>(op) << " is not supported";
+                return false;
+            }
+        }
+
+        return true;
+    }();
+
+    return supported;
+}
+
+StatusWith<std::unique_ptr<IoUringContext>> IoUringContext::create(asio::io_context& ioContext) {
+    if (!isSupported()) {
+        return {ErrorCodes::IllegalOperation, "io_uring is not supported by the running kernel"};
+    }
+
+    auto ring = stdx::make_unique<Ring>();
+    auto makeError = [](StringData what) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "Unable to " << what << ": " << errnoWithDescription());
+    };
+
+    const unsigned entries = static_cast<unsigned>(std::max(ioUringQueueDepth, 1));
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+
+    ring->ringFd = ioUringSetup(entries, &params);
+    if (ring->ringFd < 0) {
+        return makeError("set up io_uring");
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->sqRing = ::mmap(nullptr,
+                          ring->sqRingSize,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          ring->ringFd,
+                          IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        ring->sqRing = nullptr;
+        return makeError("map the io_uring submission ring");
+    }
+
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->cqRing = ::mmap(nullptr,
+                          ring->cqRingSize,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          ring->ringFd,
+                          IORING_OFF_CQ_RING);
+    if (ring->cqRing == MAP_FAILED) {
+        ring->cqRing = nullptr;
+        return makeError("map the io_uring completion ring");
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    auto sqes = ::mmap(nullptr,
+                       ring->sqesSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       ring->ringFd,
+                       IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return makeError("map the io_uring submission entries");
+    }
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto sqBase = static_cast<char*>(ring->sqRing);
+    ring->sqHead = reinterpret_cast<unsigned*>(sqBase + params.sq_off.head);
+    ring->sqTail = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+    ring->sqEntries = params.sq_entries;
+
+    auto cqBase = static_cast<char*>(ring->cqRing);
+    ring->cqHead = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+    const int eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0) {
+        return makeError("create the io_uring completion eventfd");
+    }
+    ring->eventDescriptor = stdx::make_unique<asio::posix::stream_descriptor>(ioContext, eventFd);
+
+    if (ioUringRegister(ring->ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0) {
+        return makeError("register the io_uring completion eventfd");
+    }
+
+    const size_t numFixedBuffers = static_cast<size_t>(std::max(ioUringRegisteredBuffers, 0));
+    if (numFixedBuffers > 0) {
+        ring->fixedBuffersSize = numFixedBuffers * kFixedBufferSize;
+        auto fixedBuffers = ::mmap(nullptr,
+                                   ring->fixedBuffersSize,
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS,
+                                   -1,
+                                   0);
+        if (fixedBuffers == MAP_FAILED) {
+            return makeError("allocate the io_uring receive buffers");
+        }
+        ring->fixedBuffers = static_cast<char*>(fixedBuffers);
+
+        std::vector<iovec> iovecs(numFixedBuffers);
+        for (size_t i = 0; i < numFixedBuffers; i++) {
+            iovecs[i].iov_base = ring->fixedBuffers + i * kFixedBufferSize;
+            iovecs[i].iov_len = kFixedBufferSize;
+        }
+
+        if (ioUringRegister(
+                ring->ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) < 0) {
+            warning() << "Unable to register io_uring receive buffers, reads will not use them: "
+                      << errnoWithDescription();
+            ::munmap(ring->fixedBuffers, ring->fixedBuffersSize);
+            ring->fixedBuffers = nullptr;
+            ring->fixedBuffersSize = 0;
+        }
+    }
+
+    std::unique_ptr<IoUringContext> context(new IoUringContext(ioContext, std::move(ring)));
+    context->_armCompletionEvent();
+    return {std::move(context)};
+}
+
+IoUringContext::IoUringContext(asio::io_context& ioContext, std::unique_ptr<Ring> ring)
+    : _ioContext(ioContext), _ring(std::move(ring)) {
+    for (size_t i = 0; i < _ring->fixedBuffersSize / kFixedBufferSize; i++) {
+        _freeFixedBuffers.push_back(static_cast<int>(i));
+    }
+}
+
+IoUringContext::~IoUringContext() = default;
+
+Future<void> IoUringContext::recv(int fd, char* buf, size_t len) {
+    auto op = stdx::make_unique<Operation>();
+    op->type = Operation::Type::kRecv;
+    op->fd = fd;
+    op->buf = buf;
+    op->len = len;
+    return _startOperation(std::move(op));
+}
+
+Future<void> IoUringContext::send(int fd, const char* buf, size_t len) {
+    auto op = stdx::make_unique<Operation>();
+    op->type = Operation::Type::kSend;
+    op->fd = fd;
+    op->buf = const_cast<char*>(buf);
+    op->len = len;
+    return _startOperation(std::move(op));
+}
+
+Future<void> IoUringContext::_startOperation(std::unique_ptr<Operation> op) {
+    if (op->len == 0) {
+        return Future<void>::makeReady();
+    }
+
+    auto future = op->promise.getFuture();
+
+    FinishedOperations finished;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        op->id = _nextOperationId++;
+        auto opPtr = op.get();
+        _operations.emplace(op->id, std::move(op));
+        _queueOperation(lk, opPtr);
+        _scheduleFlush(lk);
+        finished.swap(_finished);
+    }
+
+    _fulfill(std::move(finished));
+    return future;
+}
+
+void IoUringContext::cancel(int fd) {
+    FinishedOperations finished;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        std::vector<uint64_t> toCancel;
+        for (auto it = _operations.begin(); it != _operations.end();) {
+            auto op = it->second.get();
+            if (op->fd != fd || op->canceled) {
+                ++it;
+                continue;
+            }
+
+            op->canceled = true;
+
+            // Nothing is in the kernel for an operation waiting for space in the submission ring,
+            // so it can be finished right away.
+            if (op->deferred) {
+                it = _finishOperation(lk, it, errorCodeToStatus(asio::error::operation_aborted));
+                continue;
+            }
+
+            toCancel.push_back(op->id);
+            ++it;
+        }
+
+        // Queueing a cancellation can flush the submission ring, which fails the operations being
+        // submitted if the kernel refuses them, so look the operations up again.
+        for (auto id : toCancel) {
+            auto it = _operations.find(id);
+            if (it != _operations.end()) {
+                _queueCancel(lk, it->second.get());
+            }
+        }
+
+        // Cancellations are not batched, so that the operations complete as soon as possible.
+        if (!toCancel.empty()) {
+            _flush(lk);
+        }
+
+        finished.swap(_finished);
+    }
+
+    _fulfill(std::move(finished));
+}
+
+IoUringContext::Stats IoUringContext::getStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _stats;
+}
+
+bool IoUringContext::_hasSubmissionSpace(WithLock lk) {
+    if (*_ring->sqTail - loadAcquire(_ring->sqHead) < _ring->sqEntries)
+        return true;
+
+    // The submission ring is full, so hand the queued entries over to the kernel. This does not
+    // free up any space if the kernel is short of resources, until completions have been reaped.
+    _flush(lk);
+    return *_ring->sqTail - loadAcquire(_ring->sqHead) < _ring->sqEntries;
+}
+
+io_uring_sqe* IoUringContext::_nextSubmissionEntry(WithLock lk) {
+    if (!_hasSubmissionSpace(lk))
+        return nullptr;
+
+    const auto tail = *_ring->sqTail;
+    const auto index = tail & *_ring->sqMask;
+    auto sqe = &_ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    _ring->sqArray[index] = index;
+    storeRelease(_ring->sqTail, tail + 1);
+
+    _ring->pendingSubmissions++;
+    _stats.submitted++;
+    return sqe;
+}
+
+void IoUringContext::_deferSubmission(WithLock,
+                                      DeferredSubmission::Kind kind,
+                                      Operation* op) {
+    if (kind != DeferredSubmission::Kind::kCancel) {
+        op->deferred = true;
+    }
+
+    _deferredSubmissions.push_back({kind, op->id});
+    _stats.deferredSubmissions++;
+}
+
+void IoUringContext::_submitDeferred(WithLock lk) {
+    while (!_deferredSubmissions.empty()) {
+        if (!_hasSubmissionSpace(lk))
+            return;
+
+        const auto deferred = _deferredSubmissions.front();
+        _deferredSubmissions.pop_front();
+
+        // The operation has been canceled or has failed in the meantime.
+        auto it = _operations.find(deferred.operationId);
+        if (it == _operations.end())
+            continue;
+
+        auto op = it->second.get();
+        switch (deferred.kind) {
+            case DeferredSubmission::Kind::kOperation:
+                op->deferred = false;
+                _queueOperation(lk, op);
+                break;
+            case DeferredSubmission::Kind::kPoll:
+                op->deferred = false;
+                _queuePoll(lk, op);
+                break;
+            case DeferredSubmission::Kind::kCancel:
+                _queueCancel(lk, op);
+                break;
+        }
+    }
+}
+
+void IoUringContext::_queueOperation(WithLock lk, Operation* op) {
+    auto sqe = _nextSubmissionEntry(lk);
+    if (!sqe) {
+        _deferSubmission(lk, DeferredSubmission::Kind::kOperation, op);
+        return;
+    }
+
+    const size_t remaining = op->len - op->done;
+
+    if (op->type == Operation::Type::kRecv && remaining <= kFixedBufferSize &&
+        !_freeFixedBuffers.empty()) {
+        op->fixedBuffer = _freeFixedBuffers.back();
+        _freeFixedBuffers.pop_back();
+    }
+
+    sqe->fd = op->fd;
+    sqe->user_data = op->id;
+    sqe->len = static_cast<uint32_t>(remaining);
+
+    if (op->fixedBuffer >= 0) {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = reinterpret_cast<uint64_t>(_ring->fixedBuffers +
+                                               op->fixedBuffer * kFixedBufferSize);
+        sqe->buf_index = static_cast<uint16_t>(op->fixedBuffer);
+        _stats.fixedBufferReads++;
+    } else if (op->type == Operation::Type::kRecv) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->addr = reinterpret_cast<uint64_t>(op->buf + op->done);
+    } else {
+        sqe->opcode = IORING_OP_SEND;
+        sqe->addr = reinterpret_cast<uint64_t>(op->buf + op->done);
+        sqe->msg_flags = MSG_NOSIGNAL;
+    }
+}
+
+void IoUringContext::_queuePoll(WithLock lk, Operation* op) {
+    op->polling = true;
+
+    auto sqe = _nextSubmissionEntry(lk);
+    if (!sqe) {
+        _deferSubmission(lk, DeferredSubmission::Kind::kPoll, op);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = op->fd;
+    sqe->user_data = op->id;
+    sqe->poll_events = (op->type == Operation::Type::kRecv) ? POLLIN : POLLOUT;
+}
+
+void IoUringContext::_queueCancel(WithLock lk, Operation* op) {
+    auto sqe = _nextSubmissionEntry(lk);
+    if (!sqe) {
+        _deferSubmission(lk, DeferredSubmission::Kind::kCancel, op);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = op->id;
+    sqe->user_data = kNoOperation;
+}
+
+IoUringContext::OperationMap::iterator IoUringContext::_finishOperation(WithLock,
+                                                                       OperationMap::iterator it,
+                                                                       Status status) {
+    auto op = it->second.get();
+    if (op->fixedBuffer >= 0) {
+        _freeFixedBuffers.push_back(op->fixedBuffer);
+    }
+
+    _finished.emplace_back(std::move(op->promise), std::move(status));
+    return _operations.erase(it);
+}
+
+void IoUringContext::_failPendingSubmissions(WithLock lk, Status status) {
+    // The kernel has not consumed the entries between the head and the tail of the submission
+    // ring, so take them back and fail the operations they belong to.
+    const auto head = loadAcquire(_ring->sqHead);
+    const auto tail = *_ring->sqTail;
+    for (auto i = head; i != tail; i++) {
+        const auto& sqe = _ring->sqes[_ring->sqArray[i & *_ring->sqMask]];
+        if (sqe.user_data == kNoOperation)
+            continue;
+
+        auto it = _operations.find(sqe.user_data);
+        if (it != _operations.end()) {
+            _finishOperation(lk, it, status);
+        }
+    }
+
+    storeRelease(_ring->sqTail, head);
+    _ring->pendingSubmissions = 0;
+}
+
+void IoUringContext::_flush(WithLock lk) {
+    _flushScheduled = false;
+
+    while (_ring->pendingSubmissions > 0) {
+        const int submitted = ioUringEnter(_ring->ringFd, _ring->pendingSubmissions);
+        if (submitted < 0) {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+
+            // The kernel is out of resources or the completion ring is full. The entries stay
+            // queued and get submitted again after completions have been reaped.
+            if (err == EAGAIN || err == EBUSY)
+                break;
+
+            error() << "io_uring_enter failed, failing the operations being submitted: "
+                    << errnoWithDescription(err);
+            const std::error_code ec(err, std::system_category());
+            _failPendingSubmissions(lk, errorCodeToStatus(ec));
+            break;
+        }
+
+        _stats.enterCalls++;
+        _ring->pendingSubmissions -= std::min(static_cast<unsigned>(submitted),
+                                              _ring->pendingSubmissions);
+    }
+}
+
+void IoUringContext::_scheduleFlush(WithLock) {
+    if (_flushScheduled)
+        return;
+
+    // Defer the submission until the io_context gets to run the posted flush, so that every
+    // operation requested by the handlers running in the meantime is submitted along with it.
+    _flushScheduled = true;
+    asio::post(_ioContext, [this] {
+        FinishedOperations finished;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_flushScheduled) {
+                _flush(lk);
+            }
+            finished.swap(_finished);
+        }
+
+        _fulfill(std::move(finished));
+    });
+}
+
+void IoUringContext::_armCompletionEvent() {
+    _ring->eventDescriptor->async_read_some(
+        asio::null_buffers(), [this](const std::error_code& ec, size_t) {
+            if (ec == asio::error::operation_aborted)
+                return;
+
+            // Drain the eventfd before reaping, so a completion posted after the reaping wakes up
+            // the io_context again.
+            uint64_t count;
+            while (::read(_ring->eventDescriptor->native_handle(), &count, sizeof(count)) > 0) {
+            }
+
+            _reapCompletions();
+            _armCompletionEvent();
+        });
+}
+
+void IoUringContext::_reapCompletions() {
+    FinishedOperations finished;
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto finish = [&](OperationMap::iterator it, Status status) {
+            _finishOperation(lk, it, std::move(status));
+        };
+
+        auto head = *_ring->cqHead;
+        const auto tail = loadAcquire(_ring->cqTail);
+        for (; head != tail; head++) {
+            const auto& cqe = _ring->cqes[head & *_ring->cqMask];
+            const auto userData = cqe.user_data;
+            const int res = cqe.res;
+
+            if (userData == kNoOperation)
+                continue;
+
+            auto it = _operations.find(userData);
+            if (it == _operations.end())
+                continue;
+
+            auto op = it->second.get();
+            _stats.completed++;
+
+            if (op->fixedBuffer >= 0) {
+                if (res > 0) {
+                    memcpy(op->buf + op->done,
+                           _ring->fixedBuffers + op->fixedBuffer * kFixedBufferSize,
+                           res);
+                }
+                _freeFixedBuffers.push_back(op->fixedBuffer);
+                op->fixedBuffer = -1;
+            }
+
+            if (res == -ECANCELED || (op->canceled && (res < 0 || op->polling))) {
+                finish(it, errorCodeToStatus(asio::error::operation_aborted));
+                continue;
+            }
+
+            if (op->polling) {
+                // The socket became ready (or failed, in which case the retried operation reports
+                // the error).
+                op->polling = false;
+                _queueOperation(lk, op);
+                continue;
+            }
+
+            if (res == -EAGAIN || res == -EWOULDBLOCK) {
+                _queuePoll(lk, op);
+                continue;
+            }
+
+            if (res == -EINTR) {
+                _queueOperation(lk, op);
+                continue;
+            }
+
+            if (res < 0) {
+                finish(it, errorCodeToStatus(std::error_code(-res, std::system_category())));
+                continue;
+            }
+
+            if (res == 0 && op->type == Operation::Type::kRecv) {
+                finish(it, errorCodeToStatus(asio::error::eof));
+                continue;
+            }
+
+            op->done += res;
+            if (op->done < op->len && !op->canceled) {
+                _queueOperation(lk, op);
+            } else if (op->done < op->len) {
+                finish(it, errorCodeToStatus(asio::error::operation_aborted));
+            } else {
+                finish(it, Status::OK());
+            }
+        }
+
+        storeRelease(_ring->cqHead, head);
+
+        // The kernel has consumed entries or released resources for the reaped completions, so
+        // the deferred submissions may fit now.
+        _submitDeferred(lk);
+
+        // This runs on a thread running the io_context, so submit the follow-up operations right
+        // away instead of posting another flush.
+        _flush(lk);
+
+        finished.swap(_finished);
+    }
+
+    _fulfill(std::move(finished));
+}
+
+void IoUringContext::_fulfill(FinishedOperations finished) {
+    for (auto& entry : finished) {
+        if (entry.second.isOK()) {
+            entry.first.emplaceValue();
+        } else {
+            entry.first.setError(std::move(entry.second));
+        }
+    }
+}
+
+#else  // !MONGO_CONFIG_HAVE_LINUX_IO_URING
+
+struct IoUringContext::Ring {};
+struct IoUringContext::Operation {};
+
+bool IoUringContext::isSupported() {
+    return false;
+}
+
+StatusWith<std::unique_ptr<IoUringContext>> IoUringContext::create(asio::io_context& ioContext) {
+    return {ErrorCodes::IllegalOperation, "io_uring is not supported on this platform"};
+}
+
+IoUringContext::~IoUringContext() = default;
+
+Future<void> IoUringContext::recv(int fd, char* buf, size_t len) {
+    MONGO_UNREACHABLE;
+}
+
+Future<void> IoUringContext::send(int fd, const char* buf, size_t len) {
+    MONGO_UNREACHABLE;
+}
+
+void IoUringContext::cancel(int fd) {
+    MONGO_UNREACHABLE;
+}
+
+IoUringContext::Stats IoUringContext::getStats() const {
+    MONGO_UNREACHABLE;
+}
+
+#endif  // MONGO_CONFIG_HAVE_LINUX_IO_URING
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/config.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/future.h"
+
+struct io_uring_sqe;
+
+namespace asio {
+class io_context;
+}  // namespace asio
+
+namespace mongo {
+namespace transport {
+
+/**
+ * Performs socket reads and writes through a Linux io_uring instance instead of through ASIO's
+ * epoll reactor. One context is associated with each ingress reactor.
+ *
+ * Operations requested while the reactor is running its handlers are queued in the submission ring
+ * and submitted to the kernel together with a single io_uring_enter call, so that all the sessions
+ * served by the reactor share one system call per turn of the event loop. Completions are signaled
+ * through an eventfd which is watched by the reactor's io_context, so completion callbacks run on
+ * the threads running the reactor just like regular ASIO completion handlers.
+ *
+ * Reads small enough to fit are done into buffers registered with the kernel up front, which saves
+ * mapping the destination pages for every reception.
+ *
+ * Submissions which do not fit into the submission ring, because the kernel is not consuming the
+ * entries fast enough, are kept aside and added to the ring as completions get reaped. If the
+ * kernel refuses the submitted entries, only the operations they belong to fail.
+ *
+ * This class is thread-safe.
+ */
+class IoUringContext {
+    MONGO_DISALLOW_COPYING(IoUringContext);
+
+public:
+    struct Stats {
+        int64_t submitted = 0;
+        int64_t enterCalls = 0;
+        int64_t completed = 0;
+        int64_t fixedBufferReads = 0;
+        int64_t deferredSubmissions = 0;
+    };
+
+    /**
+     * Returns whether both this build and the running kernel support the io_uring operations this
+     * class relies on. The result of the check is cached.
+     */
+    static bool isSupported();
+
+    /**
+     * Creates an io_uring instance whose completions are processed by the specified io_context.
+     */
+    static StatusWith<std::unique_ptr<IoUringContext>> create(asio::io_context& ioContext);
+
+    ~IoUringContext();
+
+    /**
+     * Reads exactly len bytes from the socket into buf. The returned future is ready once all the
+     * bytes have been read or the read failed. The buffer must stay valid until then.
+     */
+    Future<void> recv(int fd, char* buf, size_t len);
+
+    /**
+     * Writes exactly len bytes from buf to the socket. The returned future is ready once all the
+     * bytes have been written or the write failed. The buffer must stay valid until then.
+     */
+    Future<void> send(int fd, const char* buf, size_t len);
+
+    /**
+     * Cancels all outstanding operations on the specified socket. Their futures are set to
+     * CallbackCanceled.
+     */
+    void cancel(int fd);
+
+    Stats getStats() const;
+
+private:
+    struct Ring;
+    struct Operation;
+
+    struct DeferredSubmission {
+        enum class Kind { kOperation, kPoll, kCancel };
+
+        Kind kind;
+        uint64_t operationId;
+    };
+
+    using OperationMap = std::unordered_map<uint64_t, std::unique_ptr<Operation>>;
+    using FinishedOperations = std::vector<std::pair<Promise<void>, Status>>;
+
+    IoUringContext(asio::io_context& ioContext, std::unique_ptr<Ring> ring);
+
+    Future<void> _startOperation(std::unique_ptr<Operation> op);
+    bool _hasSubmissionSpace(WithLock);
+    io_uring_sqe* _nextSubmissionEntry(WithLock);
+    void _deferSubmission(WithLock, DeferredSubmission::Kind kind, Operation* op);
+    void _submitDeferred(WithLock);
+    void _queueOperation(WithLock, Operation* op);
+    void _queuePoll(WithLock, Operation* op);
+    void _queueCancel(WithLock, Operation* op);
+    OperationMap::iterator _finishOperation(WithLock, OperationMap::iterator it, Status status);
+    void _failPendingSubmissions(WithLock, Status status);
+    void _flush(WithLock);
+    void _scheduleFlush(WithLock);
+    void _armCompletionEvent();
+    void _reapCompletions();
+
+    static void _fulfill(FinishedOperations finished);
+
+    asio::io_context& _ioContext;
+    std::unique_ptr<Ring> _ring;
+
+    mutable stdx::mutex _mutex;
+
+    // Operations which have been submitted, keyed by the user data of their submission entries
+    OperationMap _operations;
+    uint64_t _nextOperationId = 1;
+
+    // Submissions waiting for space in the submission ring, in the order they were requested
+    std::deque<DeferredSubmission> _deferredSubmissions;
+
+    // Operations which have finished, but whose promises have not been fulfilled yet, because that
+    // must not happen while holding the mutex
+    FinishedOperations _finished;
+
+    // Indexes of the registered buffers, which are not currently used by a read
+    std::vector<int> _freeFixedBuffers;
+
+    // Whether a flush of the submission queue has been posted to the io_context
+    bool _flushScheduled = false;
+
+    Stats _stats;
+};
+
+}  // namespace transport
+}  // namespace mongo
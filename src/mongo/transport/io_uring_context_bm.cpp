@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <asio.hpp>
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mongo/transport/io_uring_context.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+using GenericSocket = asio::generic::stream_protocol::socket;
+
+constexpr size_t kMessageSize = 64;
+
+/**
+ * A set of connected socket pairs standing in for the sessions of one reactor. The server ends are
+ * non-blocking like the sockets of sessions in asynchronous mode.
+ */
+class SocketPairs {
+public:
+    explicit SocketPairs(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int fds[2];
+            invariant(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+            invariant(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0);
+            _server.push_back(fds[0]);
+            _client.push_back(fds[1]);
+        }
+    }
+
+    ~SocketPairs() {
+        for (auto fd : _client)
+            ::close(fd);
+        for (auto fd : _server)
+            ::close(fd);
+    }
+
+    void sendToAll(const char* message) {
+        for (auto fd : _client) {
+            invariant(::send(fd, message, kMessageSize, 0) == static_cast<ssize_t>(kMessageSize));
+        }
+    }
+
+    const std::vector<int>& serverFds() const {
+        return _server;
+    }
+
+private:
+    std::vector<int> _server;
+    std::vector<int> _client;
+};
+
+/**
+ * Receives one small message on each of state.range(0) sessions per iteration through ASIO's epoll
+ * reactor, the way TransportLayerASIO sessions read: an opportunistic non-blocking read, followed
+ * by an asynchronous read if no data is available yet. With state.range(1) == 0 the messages are
+ * already buffered when the reads are issued, otherwise they arrive after the reads are waiting.
+ */
+void BM_EpollRecv(benchmark::State& state) {
+    const size_t numSessions = state.range(0);
+    const bool readsWait = state.range(1);
+
+    asio::io_context ioContext;
+    SocketPairs pairs(numSessions);
+    std::vector<std::unique_ptr<GenericSocket>> sockets;
+    for (auto fd : pairs.serverFds()) {
+        sockets.push_back(std::make_unique<GenericSocket>(
+            ioContext, asio::generic::stream_protocol(AF_UNIX, SOCK_STREAM), ::dup(fd)));
+    }
+
+    const std::vector<char> message(kMessageSize, 'x');
+    std::vector<std::vector<char>> buffers(numSessions, std::vector<char>(kMessageSize));
+
+    for (auto keepRunning : state) {
+        if (!readsWait)
+            pairs.sendToAll(message.data());
+
+        size_t completed = 0;
+        for (size_t i = 0; i < numSessions; i++) {
+            std::error_code ec;
+            const auto size = asio::read(*sockets[i], asio::buffer(buffers[i]), ec);
+            if (ec == asio::error::would_block || ec == asio::error::try_again) {
+                asio::async_read(*sockets[i],
+                                 asio::buffer(buffers[i].data() + size, kMessageSize - size),
+                                 [&completed](const std::error_code& ec, size_t) {
+                                     invariant(!ec);
+                                     completed++;
+                                 });
+            } else {
+                invariant(!ec);
+                completed++;
+            }
+        }
+
+        if (readsWait)
+            pairs.sendToAll(message.data());
+
+        while (completed < numSessions) {
+            ioContext.run_one();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numSessions);
+}
+
+/**
+ * Same as BM_EpollRecv, but the reads go through an IoUringContext, which submits all of them with
+ * a single system call.
+ */
+void BM_IoUringRecv(benchmark::State& state) {
+    if (!IoUringContext::isSupported()) {
+        state.SkipWithError("io_uring is not supported by the running kernel");
+        return;
+    }
+
+    const size_t numSessions = state.range(0);
+    const bool readsWait = state.range(1);
+
+    asio::io_context ioContext;
+    auto context = std::move(IoUringContext::create(ioContext).getValue());
+    SocketPairs pairs(numSessions);
+
+    const std::vector<char> message(kMessageSize, 'x');
+    std::vector<std::vector<char>> buffers(numSessions, std::vector<char>(kMessageSize));
+
+    for (auto keepRunning : state) {
+        if (!readsWait)
+            pairs.sendToAll(message.data());
+
+        size_t completed = 0;
+        for (size_t i = 0; i < numSessions; i++) {
+            context->recv(pairs.serverFds()[i], buffers[i].data(), kMessageSize)
+                .getAsync([&completed](Status status) {
+                    invariant(status.isOK());
+                    completed++;
+                });
+        }
+
+        if (readsWait) {
+            // Let the posted flush submit the reads before the data arrives.
+            ioContext.poll();
+            pairs.sendToAll(message.data());
+        }
+
+        while (completed < numSessions) {
+            ioContext.run_one();
+        }
+    }
+
+    const auto stats = context->getStats();
+    state.SetItemsProcessed(state.iterations() * numSessions);
+    state.counters["submitsPerEnter"] =
+        static_cast<double>(stats.submitted) / std::max<int64_t>(stats.enterCalls, 1);
+    state.counters["fixedBufferReads"] = stats.fixedBufferReads;
+}
+
+void sessionArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"sessions", "readsWait"});
+    for (int sessions : {1, 16, 256}) {
+        for (int readsWait : {0, 1}) {
+            b->Args({sessions, readsWait});
+        }
+    }
+}
+
+BENCHMARK(BM_EpollRecv)->Apply(sessionArgs);
+BENCHMARK(BM_IoUringRecv)->Apply(sessionArgs);
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
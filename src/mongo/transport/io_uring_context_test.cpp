@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring_context.h"
+
+#include <asio.hpp>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+class IoUringContextTest : public unittest::Test {
+protected:
+    void setUp() override {
+        if (!IoUringContext::isSupported()) {
+            log() << "io_uring is not supported, skipping test";
+            return;
+        }
+
+        int fds[2];
+        ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+        _localFd = fds[0];
+        _remoteFd = fds[1];
+
+        _context = uassertStatusOK(IoUringContext::create(_ioContext));
+    }
+
+    void tearDown() override {
+        _context.reset();
+        if (_localFd >= 0)
+            ::close(_localFd);
+        if (_remoteFd >= 0)
+            ::close(_remoteFd);
+    }
+
+    bool supported() const {
+        return bool(_context);
+    }
+
+    Status waitFor(Future<void>& future) {
+        while (!future.isReady()) {
+            _ioContext.run_one();
+        }
+        return future.getNoThrow();
+    }
+
+    asio::io_context _ioContext;
+    std::unique_ptr<IoUringContext> _context;
+    int _localFd = -1;
+    int _remoteFd = -1;
+};
+
+TEST_F(IoUringContextTest, RecvWaitsForAllBytes) {
+    if (!supported())
+        return;
+
+    char buf[8];
+    auto future = _context->recv(_localFd, buf, sizeof(buf));
+
+    ASSERT_EQ(4, ::send(_remoteFd, "abcd", 4, 0));
+    _ioContext.poll();
+    ASSERT_FALSE(future.isReady());
+
+    ASSERT_EQ(4, ::send(_remoteFd, "efgh", 4, 0));
+    ASSERT_OK(waitFor(future));
+    ASSERT_EQ(0, memcmp(buf, "abcdefgh", sizeof(buf)));
+}
+
+TEST_F(IoUringContextTest, LargeMessageRoundTrip) {
+    if (!supported())
+        return;
+
+    // Larger than a registered buffer and than the socket buffer, so both directions need
+    // several submissions.
+    std::vector<char> sent(1024 * 1024);
+    for (size_t i = 0; i < sent.size(); i++) {
+        sent[i] = static_cast<char>(i * 7);
+    }
+    std::vector<char> received(sent.size());
+
+    auto sendFuture = _context->send(_remoteFd, sent.data(), sent.size());
+    auto recvFuture = _context->recv(_localFd, received.data(), received.size());
+
+    ASSERT_OK(waitFor(sendFuture));
+    ASSERT_OK(waitFor(recvFuture));
+    ASSERT(sent == received);
+
+    auto stats = _context->getStats();
+    ASSERT_GT(stats.completed, 2);
+    ASSERT_LTE(stats.enterCalls, stats.submitted);
+}
+
+TEST_F(IoUringContextTest, CancelCompletesOutstandingRecv) {
+    if (!supported())
+        return;
+
+    char buf[8];
+    auto future = _context->recv(_localFd, buf, sizeof(buf));
+    _ioContext.poll();
+
+    _context->cancel(_localFd);
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, waitFor(future));
+}
+
+TEST_F(IoUringContextTest, RecvFailsWhenPeerCloses) {
+    if (!supported())
+        return;
+
+    char buf[8];
+    auto future = _context->recv(_localFd, buf, sizeof(buf));
+
+    ::close(_remoteFd);
+    _remoteFd = -1;
+    ASSERT_EQ(ErrorCodes::HostUnreachable, waitFor(future));
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
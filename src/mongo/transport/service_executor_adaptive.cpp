@@ -42,6 +42,7 @@
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stringutils.h"
@@ -93,6 +94,20 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kRunQueues = "runQueues"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kDepth = "depth"_sd;
+constexpr auto kNumLocalQueues = "numQueues"_sd;
+constexpr auto kQueueLatencyUs = "queueLatencyMicros"_sd;
+
+constexpr std::array<StringData, 8> kLatencyBucketNames = {"lt4"_sd,
+                                                          "lt16"_sd,
+                                                          "lt64"_sd,
+                                                          "lt256"_sd,
+                                                          "lt1024"_sd,
+                                                          "lt4096"_sd,
+                                                          "lt16384"_sd,
+                                                          "ge16384"_sd};
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -152,6 +167,72 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
 thread_local ServiceExecutorAdaptive::ThreadState* ServiceExecutorAdaptive::_localThreadState =
     nullptr;
 
+void ServiceExecutorAdaptive::QueueLatencyHistogram::record(int64_t micros) {
+    size_t bucket = 0;
+    while (bucket + 1 < kBuckets && micros >= (int64_t{4} << (2 * bucket))) {
+        bucket++;
+    }
+    _counts[bucket].addAndFetch(1);
+}
+
+void ServiceExecutorAdaptive::QueueLatencyHistogram::add(const QueueLatencyHistogram& other) {
+    for (size_t i = 0; i < kBuckets; i++) {
+        _counts[i].addAndFetch(other._counts[i].load());
+    }
+}
+
+void ServiceExecutorAdaptive::QueueLatencyHistogram::append(BSONObjBuilder* bob) const {
+    static_assert(kLatencyBucketNames.size() == kBuckets, "every bucket must have a name");
+    BSONObjBuilder histogram(bob->subobjStart(kQueueLatencyUs));
+    for (size_t i = 0; i < kBuckets; i++) {
+        histogram << kLatencyBucketNames[i] << _counts[i].load();
+    }
+    histogram.doneFast();
+}
+
+bool ServiceExecutorAdaptive::LocalQueue::push(Task* task) {
+    auto bottom = _bottom.load();
+    if (bottom - _top.load() >= kCapacity)
+        return false;
+
+    _slots[bottom % kCapacity].store(task);
+    _bottom.store(bottom + 1);
+    return true;
+}
+
+ServiceExecutorAdaptive::Task* ServiceExecutorAdaptive::LocalQueue::pop() {
+    auto bottom = _bottom.load() - 1;
+    _bottom.store(bottom);
+    auto top = _top.load();
+    if (top > bottom) {
+        // The queue was already empty.
+        _bottom.store(bottom + 1);
+        return nullptr;
+    }
+
+    auto task = _slots[bottom % kCapacity].load();
+    if (top == bottom) {
+        // This is the last task in the queue, so race any thieves for it.
+        if (_top.compareAndSwap(top, top + 1) != top)
+            task = nullptr;
+        _bottom.store(bottom + 1);
+    }
+    return task;
+}
+
+ServiceExecutorAdaptive::Task* ServiceExecutorAdaptive::LocalQueue::steal() {
+    auto top = _top.load();
+    if (top >= _bottom.load())
+        return nullptr;
+
+    auto task = _slots[top % kCapacity].load();
+    if (_top.compareAndSwap(top, top + 1) != top)
+        return nullptr;
+
+    totalStolen.addAndFetch(1);
+    return task;
+}
+
 ServiceExecutorAdaptive::ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor)
     : ServiceExecutorAdaptive(
           ctx, std::move(reactor), stdx::make_unique<ServerParameterOptions>()) {}
@@ -210,11 +291,39 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
     }
 
-    auto wrappedTask =
-        [ this, task = std::move(task), scheduleTime, pendingCounterPtr, taskName, flags ] {
+    // Tasks that may recurse run immediately on the scheduling worker if it is not over the depth
+    // limit. Otherwise a worker queues the task locally so the session it belongs to keeps running
+    // on the same thread ahead of new sessions, which always go through the reactor along with
+    // anything scheduled from outside the pool.
+    auto localQueue = _localThreadState ? _localThreadState->localQueue : nullptr;
+    const bool runInline = _localThreadState && (flags & kMayRecurse) &&
+        (_localThreadState->recursionDepth + 1 < _config->recursionLimit());
+    const bool useLocalQueue = !runInline && localQueue &&
+        taskName != ServiceExecutorTaskName::kSSMStartSession &&
+        localQueue->depth() < LocalQueue::kCapacity;
+
+    QueueLatencyHistogram* latencyHistogram = nullptr;
+    if (useLocalQueue) {
+        latencyHistogram = &localQueue->latency;
+    } else if (!runInline) {
+        latencyHistogram = &_sharedQueueLatency;
+    }
+
+    auto wrappedTask = [
+        this,
+        task = std::move(task),
+        scheduleTime,
+        pendingCounterPtr,
+        taskName,
+        flags,
+        latencyHistogram
+    ] {
         pendingCounterPtr->subtractAndFetch(1);
         auto start = _tickSource->getTicks();
         _totalSpentQueued.addAndFetch(start - scheduleTime);
+        if (latencyHistogram) {
+            latencyHistogram->record(ticksToMicros(start - scheduleTime, _tickSource));
+        }
 
         _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
             ._totalSpentQueued.addAndFetch(start - scheduleTime);
@@ -244,17 +353,21 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         }
     };
 
-    // Dispatching a task on the io_context will run the task immediately, and may run it
-    // on the current thread (if the current thread is running the io_context right now).
-    //
-    // Posting a task on the io_context will run the task without recursion.
-    //
-    // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
-    // can be called immediately and recursively.
-    if ((flags & kMayRecurse) &&
-        (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
-        _reactorHandle->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    if (runInline) {
+        wrappedTask();
+    } else if (useLocalQueue) {
+        // Only this thread pushes onto its own queue and we checked the depth above, so this
+        // cannot fail.
+        invariant(localQueue->push(new Task(std::move(wrappedTask))));
+        localQueue->totalQueued.addAndFetch(1);
+
+        // The owner will pick up one queued task as soon as its current task returns. If more are
+        // backing up behind it, wake an idle worker so it can steal them.
+        if (localQueue->depth() > 1 && _threadsRunning.load() > _threadsInUse.load()) {
+            _reactorHandle->schedule(Reactor::kPost, [] {});
+        }
     } else {
+        _totalSharedQueued.addAndFetch(1);
         _reactorHandle->schedule(Reactor::kPost, std::move(wrappedTask));
     }
 
@@ -524,6 +637,75 @@ void ServiceExecutorAdaptive::_accumulateAllTaskMetrics(
     }
 }
 
+ServiceExecutorAdaptive::LocalQueue* ServiceExecutorAdaptive::_acquireLocalQueue() {
+    stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+    if (!_freeLocalQueues.empty()) {
+        auto queue = _freeLocalQueues.back();
+        _freeLocalQueues.pop_back();
+        return queue;
+    }
+
+    auto numQueues = _numLocalQueues.load();
+    if (numQueues == kMaxLocalQueues)
+        return nullptr;
+
+    _localQueues[numQueues] = stdx::make_unique<LocalQueue>();
+    _numLocalQueues.store(numQueues + 1);
+    return _localQueues[numQueues].get();
+}
+
+void ServiceExecutorAdaptive::_releaseLocalQueue(LocalQueue* queue) {
+    // Anything left over goes back through the reactor so another worker can run it. If the
+    // executor is shutting down the reactor has been stopped and the tasks are just dropped.
+    while (auto task = queue->pop()) {
+        std::unique_ptr<Task> owned(task);
+        if (_isRunning.load()) {
+            _reactorHandle->schedule(Reactor::kPost, std::move(*owned));
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+    _freeLocalQueues.push_back(queue);
+}
+
+ServiceExecutorAdaptive::Task* ServiceExecutorAdaptive::_stealTask(LocalQueue* thief,
+                                                                   int numaNode) {
+    static thread_local size_t nextVictim = 0;
+
+    // Workers bound to a NUMA node first look for work on their own node, whose sessions' memory
+    // is most likely to be local, and only then on the other nodes.
+    auto numQueues = _numLocalQueues.load();
+    for (bool sameNodeOnly : {numaNode >= 0, false}) {
+        for (size_t i = 0; i < numQueues; i++) {
+            auto victim = _localQueues[nextVictim++ % numQueues].get();
+            if (victim == thief || victim->depth() == 0)
+                continue;
+            if (sameNodeOnly && victim->numaNode.load() != numaNode)
+                continue;
+
+            if (auto task = victim->steal())
+                return task;
+        }
+
+        if (!sameNodeOnly)
+            break;
+    }
+
+    return nullptr;
+}
+
+bool ServiceExecutorAdaptive::_runLocalTask(ThreadState* state) {
+    auto task = state->localQueue ? state->localQueue->pop() : nullptr;
+    if (!task)
+        task = _stealTask(state->localQueue, state->numaNode);
+    if (!task)
+        return false;
+
+    std::unique_ptr<Task> owned(task);
+    (*owned)();
+    return true;
+}
+
 TickSource::Tick ServiceExecutorAdaptive::_getThreadTimerTotal(
     ThreadTimer which, const stdx::unique_lock<stdx::mutex>& lk) const {
     TickSource::Tick accumulator;
@@ -561,8 +743,24 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
 
     log() << "Started new database worker thread " << threadId;
 
+    if (numaAwareThreadPlacement) {
+        const auto& topology = NumaTopology::get();
+        auto swNode = topology.bindCurrentThreadToNode(threadId);
+        if (swNode.isOK()) {
+            state->numaNode = topology.nodes()[swNode.getValue()]->id;
+        } else {
+            warning() << swNode.getStatus();
+        }
+    }
+
+    state->localQueue = _acquireLocalQueue();
+    if (state->localQueue)
+        state->localQueue->numaNode.store(state->numaNode);
+
     bool guardThreadsRunning = true;
     const auto guard = MakeGuard([this, &guardThreadsRunning, state] {
+        if (state->localQueue)
+            _releaseLocalQueue(state->localQueue);
         if (guardThreadsRunning)
             _threadsRunning.subtractAndFetch(1);
         _pastThreadsSpentRunning.addAndFetch(state->running.totalTime());
@@ -590,7 +788,15 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         // If we're still "pending" only try to run one task, that way the controller will
         // know that it's okay to start adding threads to avoid starvation again.
         state->running.markRunning();
-        _reactorHandle->runFor(runTime);
+
+        // Work from the local run queues takes priority over the reactor, so only wait on the
+        // reactor once there is nothing left to run or steal.
+        TickTimer runTimer(_tickSource);
+        for (auto remaining = runTime; remaining > Milliseconds{0} && _isRunning.load();
+             remaining = runTime - runTimer.sinceStart()) {
+            if (!_runLocalTask(&(*state)))
+                _reactorHandle->runOneFor(remaining);
+        }
 
         auto spentRunning = state->running.markStopped();
 
@@ -685,6 +891,35 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
 
     threadStartReasons.doneFast();
 
+    // The local queues are reported in aggregate so the shape of serverStatus doesn't depend on
+    // how many workers have been started.
+    BSONObjBuilder runQueues(section.subobjStart(kRunQueues));
+    {
+        BSONObjBuilder shared(runQueues.subobjStart("shared"));
+        shared << kTotalQueued << _totalSharedQueued.load();
+        _sharedQueueLatency.append(&shared);
+        shared.doneFast();
+    }
+    {
+        QueueLatencyHistogram localLatency;
+        int64_t localQueued = 0, localStolen = 0, localDepth = 0;
+        auto numQueues = _numLocalQueues.load();
+        for (size_t i = 0; i < numQueues; i++) {
+            const auto& queue = *_localQueues[i];
+            localQueued += queue.totalQueued.load();
+            localStolen += queue.totalStolen.load();
+            localDepth += queue.depth();
+            localLatency.add(queue.latency);
+        }
+
+        BSONObjBuilder local(runQueues.subobjStart("local"));
+        local << kNumLocalQueues << static_cast<long long>(numQueues) << kTotalQueued
+              << localQueued << kTotalStolen << localStolen << kDepth << localDepth;
+        localLatency.append(&local);
+        local.doneFast();
+    }
+    runQueues.doneFast();
+
     BSONObjBuilder metricsByTask(section.subobjStart("metricsByTask"));
     MetricsArray totalMetrics;
     _accumulateAllTaskMetrics(&totalMetrics, lk);
@@ -48,6 +48,15 @@ namespace transport {
  * This is an ASIO-based adaptive ServiceExecutor. It guarantees that threads will not become stuck
  * or deadlocked longer that its configured timeout and that idle threads will terminate themselves
  * if they spend more than its configure idle threshold idle.
+ *
+ * Tasks scheduled from a worker thread go onto that worker's local run queue, which the worker
+ * drains before it takes anything from the reactor. Idle workers steal from the local queues of
+ * busy workers before waiting on the reactor. New sessions and tasks scheduled from outside the
+ * pool go through the reactor, so sessions that are already running are serviced ahead of new
+ * ones.
+ *
+ * With NUMA-aware placement, workers are spread across the NUMA nodes in turn and bound to them,
+ * and idle workers steal from workers on their own node before looking at other nodes.
  */
 class ServiceExecutorAdaptive : public ServiceExecutor {
 public:
@@ -176,6 +185,53 @@ private:
     using MetricsArray =
         std::array<Metrics, static_cast<size_t>(ServiceExecutorTaskName::kMaxTaskName)>;
 
+    /**
+     * Counts how long tasks waited in a run queue before they started, bucketed by powers of four
+     * microseconds.
+     */
+    class QueueLatencyHistogram {
+    public:
+        static constexpr size_t kBuckets = 8;
+
+        void record(int64_t micros);
+        void add(const QueueLatencyHistogram& other);
+        void append(BSONObjBuilder* bob) const;
+
+    private:
+        std::array<AtomicWord<int64_t>, kBuckets> _counts;
+    };
+
+    /**
+     * A bounded work-stealing deque (Chase-Lev). Only the owning worker thread may push() and
+     * pop(), which operate on the bottom of the deque; any thread may steal() from the top. None
+     * of the operations take a lock.
+     */
+    class LocalQueue {
+    public:
+        static constexpr int64_t kCapacity = 256;
+
+        // Returns false if the queue is full, in which case the task is still owned by the caller.
+        bool push(Task* task);
+        Task* pop();
+        Task* steal();
+
+        int64_t depth() const {
+            return std::max<int64_t>(_bottom.load() - _top.load(), 0);
+        }
+
+        QueueLatencyHistogram latency;
+        AtomicWord<int64_t> totalQueued{0};
+        AtomicWord<int64_t> totalStolen{0};
+
+        // The NUMA node the owning worker is bound to, or -1 if it is not bound.
+        AtomicWord<int> numaNode{-1};
+
+    private:
+        AtomicWord<int64_t> _top{0};
+        AtomicWord<int64_t> _bottom{0};
+        std::array<AtomicWord<Task*>, kCapacity> _slots;
+    };
+
     enum class ThreadCreationReason { kStuckDetection, kStarvation, kReserveMinimum, kMax };
     enum class ThreadTimer { kRunning, kExecuting };
 
@@ -188,6 +244,12 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+
+        // This thread's run queue, or nullptr if every local queue was already taken.
+        LocalQueue* localQueue = nullptr;
+
+        // The NUMA node this thread is bound to, or -1 if it is not bound.
+        int numaNode = -1;
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -195,6 +257,10 @@ private:
     void _startWorkerThread(ThreadCreationReason reason);
     static StringData _threadStartedByToString(ThreadCreationReason reason);
     void _workerThreadRoutine(int threadId, ThreadList::iterator it);
+    bool _runLocalTask(ThreadState* state);
+    Task* _stealTask(LocalQueue* thief, int numaNode);
+    LocalQueue* _acquireLocalQueue();
+    void _releaseLocalQueue(LocalQueue* queue);
     void _controllerThreadRoutine();
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
@@ -244,6 +310,17 @@ private:
     stdx::condition_variable _scheduleCondition;
 
     MetricsArray _accumulatedMetrics;
+
+    // Worker run queues are never freed while the executor exists, so other workers may steal
+    // from any of the first _numLocalQueues entries without holding _threadsMutex.
+    static constexpr size_t kMaxLocalQueues = 256;
+    std::array<std::unique_ptr<LocalQueue>, kMaxLocalQueues> _localQueues;
+    AtomicWord<size_t> _numLocalQueues{0};
+    std::vector<LocalQueue*> _freeLocalQueues;
+
+    // Latency of tasks that went through the reactor rather than a worker's local queue.
+    QueueLatencyHistogram _sharedQueueLatency;
+    AtomicWord<int64_t> _totalSharedQueued{0};
 };
 
 }  // namespace transport
@@ -0,0 +1,297 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_reactor.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/numa.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The number of reactors (and therefore worker threads) the sessions are sharded across. If the
+// value is 0 (the default) then one reactor is started per available core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(reactorServiceExecutorThreads, int, 0);
+
+// Whether each reactor worker thread should be pinned to its own CPU.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(reactorServiceExecutorPinThreads, bool, true);
+
+// Tasks scheduled with MayRecurse may be called recursively if the recursion depth is below this
+// value.
+MONGO_EXPORT_SERVER_PARAMETER(reactorServiceExecutorRecursionLimit, int, 8);
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "reactor"_sd;
+
+/**
+ * Pins the calling thread to the index-th CPU (modulo their count) of those the thread is allowed
+ * to run on. Returns the CPU the thread was pinned to or -1 if pinning is not possible.
+ */
+int pinCurrentThread(size_t index) {
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        warning() << "Unable to retrieve the CPU affinity of the process: "
+                  << errnoWithDescription();
+        return -1;
+    }
+
+    const int numAllowed = CPU_COUNT(&allowed);
+    if (numAllowed == 0) {
+        return -1;
+    }
+
+    int target = static_cast<int>(index % numAllowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed) || target-- > 0)
+            continue;
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpu, &pinned);
+
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+        if (err != 0) {
+            warning() << "Unable to pin reactor thread to CPU " << cpu << ": "
+                      << errnoWithDescription(err);
+            return -1;
+        }
+
+        return cpu;
+    }
+#endif
+    return -1;
+}
+
+}  // namespace
+
+thread_local ServiceExecutorReactor::ReactorState* ServiceExecutorReactor::_localReactorState =
+    nullptr;
+thread_local int ServiceExecutorReactor::_localRecursionDepth = 0;
+
+ServiceExecutorReactor::ServiceExecutorReactor(ServiceContext* ctx,
+                                               std::vector<ReactorHandle> reactors) {
+    invariant(!reactors.empty());
+    for (auto& reactor : reactors) {
+        _reactors.emplace_back(stdx::make_unique<ReactorState>(std::move(reactor)));
+    }
+}
+
+ServiceExecutorReactor::~ServiceExecutorReactor() {
+    invariant(!_isRunning.load());
+}
+
+size_t ServiceExecutorReactor::getConfiguredReactorCount() {
+    const int value = reactorServiceExecutorThreads;
+    if (value > 0) {
+        return static_cast<size_t>(value);
+    }
+
+    return std::max(static_cast<size_t>(ProcessInfo::getNumAvailableCores()), size_t{1});
+}
+
+Status ServiceExecutorReactor::start() {
+    invariant(!_isRunning.load());
+    _isRunning.store(true);
+
+    for (size_t i = 0; i < _reactors.size(); i++) {
+        auto state = _reactors[i].get();
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            _threadsRunning++;
+        }
+
+        auto status =
+            launchServiceWorkerThread([this, state, i] { _workerThreadRoutine(state, i); });
+        if (!status.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            _threadsRunning--;
+            return status;
+        }
+    }
+
+    log() << "Started " << _reactors.size() << " reactor service executor threads";
+    return Status::OK();
+}
+
+Status ServiceExecutorReactor::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    _isRunning.store(false);
+
+    stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
+    for (auto& state : _reactors) {
+        state->reactor->stop();
+    }
+
+    bool result = _deathCondition.wait_for(
+        lk, timeout.toSystemDuration(), [&] { return _threadsRunning == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "reactor executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorReactor::schedule(Task task,
+                                        ScheduleFlags flags,
+                                        ServiceExecutorTaskName taskName) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    // Tasks scheduled from a reactor thread belong to a session owned by that reactor, so keep
+    // them there. Everything else gets spread across the reactors.
+    auto state = _localReactorState;
+    if (!state) {
+        state = _reactors[_nextReactor.fetchAndAdd(1) % _reactors.size()].get();
+    }
+
+    state->tasksQueued.addAndFetch(1);
+    state->totalQueued.addAndFetch(1);
+
+    auto wrappedTask = [ state, task = std::move(task) ] {
+        state->tasksQueued.subtractAndFetch(1);
+        ++_localRecursionDepth;
+        const auto guard = MakeGuard([state] {
+            --_localRecursionDepth;
+            state->totalExecuted.addAndFetch(1);
+        });
+
+        task();
+    };
+
+    // Dispatching runs the task immediately if the current thread is running the reactor, which
+    // avoids a round trip through the reactor's queue, so only do it while under the recursion
+    // limit.
+    if ((flags & kMayRecurse) && state == _localReactorState &&
+        (_localRecursionDepth + 1 < reactorServiceExecutorRecursionLimit.loadRelaxed())) {
+        state->reactor->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    } else {
+        state->reactor->schedule(Reactor::kPost, std::move(wrappedTask));
+    }
+
+    return Status::OK();
+}
+
+void ServiceExecutorReactor::_workerThreadRoutine(ReactorState* state, size_t index) {
+    setThreadName(str::stream() << "reactor-" << index);
+
+    const auto guard = MakeGuard([this] {
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        if (--_threadsRunning == 0) {
+            _deathCondition.notify_all();
+        }
+    });
+
+    // Reactors are dealt out to the NUMA nodes in turn, so each node ends up with its own set of
+    // reactors and the sessions on them. Pinning then picks a CPU among those of the node.
+    size_t cpuIndex = index;
+    if (numaAwareThreadPlacement) {
+        const auto& topology = NumaTopology::get();
+        auto swNode = topology.bindCurrentThreadToNode(index);
+        if (swNode.isOK()) {
+            state->numaNode.store(topology.nodes()[swNode.getValue()]->id);
+            cpuIndex = index / topology.numNodes();
+        } else {
+            warning() << swNode.getStatus();
+        }
+    }
+
+    if (reactorServiceExecutorPinThreads) {
+        state->cpu.store(pinCurrentThread(cpuIndex));
+    }
+
+    _localReactorState = state;
+    _localRecursionDepth = 0;
+
+    while (_isRunning.load()) {
+        state->reactor->run();
+    }
+
+    _localReactorState = nullptr;
+}
+
+void ServiceExecutorReactor::appendStats(BSONObjBuilder* bob) const {
+    int threadsRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        threadsRunning = _threadsRunning;
+    }
+
+    int64_t totalQueued = 0;
+    int64_t totalExecuted = 0;
+    for (const auto& state : _reactors) {
+        totalQueued += state->totalQueued.load();
+        totalExecuted += state->totalExecuted.load();
+    }
+
+    BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    section << kExecutorLabel << kExecutorName  //
+            << kTotalQueued << totalQueued      //
+            << kTotalExecuted << totalExecuted  //
+            << kThreadsRunning << threadsRunning;
+
+    BSONArrayBuilder reactors(section.subarrayStart("reactors"));
+    for (const auto& state : _reactors) {
+        BSONObjBuilder reactor(reactors.subobjStart());
+        reactor << "cpu" << state->cpu.load()                    //
+                << "numaNode" << state->numaNode.load()          //
+                << kTasksQueued << state->tasksQueued.load()     //
+                << kTotalQueued << state->totalQueued.load()     //
+                << kTotalExecuted << state->totalExecuted.load();
+    }
+    reactors.doneFast();
+    section.doneFast();
+}
+
+}  // namespace transport
+}  // namespace mongo
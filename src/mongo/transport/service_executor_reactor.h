@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A thread-per-core ServiceExecutor. Each of the reactors it is given gets exactly one worker
+ * thread, which is optionally pinned to its own CPU, and the transport layer shards the accepted
+ * sessions across the reactors. Because the session's socket is registered with its reactor, all
+ * of the session's network I/O completes on the owning thread, and tasks scheduled from that
+ * thread are queued back onto the same reactor. A session therefore never migrates between
+ * threads, avoiding the context switches and cross-core cache traffic of the other executors.
+ *
+ * Tasks scheduled from threads which do not own a reactor are distributed round-robin.
+ *
+ * Since a reactor thread is never replaced, a task which blocks delays every other session on
+ * that reactor. This executor is intended for workloads made of many short operations.
+ */
+class ServiceExecutorReactor final : public ServiceExecutor {
+public:
+    ServiceExecutorReactor(ServiceContext* ctx, std::vector<ReactorHandle> reactors);
+    ~ServiceExecutorReactor();
+
+    /**
+     * Returns the number of reactors the transport layer should shard sessions across, as
+     * configured through the reactorServiceExecutorThreads server parameter.
+     */
+    static size_t getConfiguredReactorCount();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+private:
+    struct ReactorState {
+        explicit ReactorState(ReactorHandle reactorHandle) : reactor(std::move(reactorHandle)) {}
+
+        ReactorHandle reactor;
+
+        // The CPU the worker thread of this reactor is pinned to or -1 if it is not pinned
+        AtomicWord<int> cpu{-1};
+
+        // The NUMA node the worker thread of this reactor is bound to or -1 if it is not bound
+        AtomicWord<int> numaNode{-1};
+
+        AtomicWord<int64_t> tasksQueued{0};
+        AtomicWord<int64_t> totalQueued{0};
+        AtomicWord<int64_t> totalExecuted{0};
+    };
+
+    void _workerThreadRoutine(ReactorState* state, size_t index);
+
+    std::vector<std::unique_ptr<ReactorState>> _reactors;
+
+    AtomicWord<bool> _isRunning{false};
+    AtomicWord<size_t> _nextReactor{0};
+
+    // Worker threads signal this condition variable when they exit so we can gracefully shutdown
+    // the executor.
+    mutable stdx::mutex _threadsMutex;
+    stdx::condition_variable _deathCondition;
+    int _threadsRunning = 0;
+
+    static thread_local ReactorState* _localReactorState;
+    static thread_local int _localRecursionDepth;
+};
+
+}  // namespace transport
+}  // namespace mongo
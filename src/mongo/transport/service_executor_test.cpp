@@ -34,6 +34,7 @@
 
 #include "mongo/db/service_context_noop.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_reactor.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/unittest/unittest.h"
@@ -86,7 +87,14 @@ public:
     ASIOReactor() : _ioContext() {}
 
     void run() noexcept final {
-        MONGO_UNREACHABLE;
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run();
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(50904);
+        }
     }
 
     void runFor(Milliseconds time) noexcept final {
@@ -100,6 +108,17 @@ public:
         }
     }
 
+    void runOneFor(Milliseconds time) noexcept final {
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run_one_for(time.toSystemDuration());
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(50907);
+        }
+    }
+
     void stop() final {
         _ioContext.stop();
     }
@@ -161,6 +180,23 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
+class ServiceExecutorReactorFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = stdx::make_unique<ServiceContextNoop>();
+        setGlobalServiceContext(std::move(scOwned));
+
+        std::vector<ReactorHandle> reactors;
+        for (int i = 0; i < 2; i++) {
+            reactors.push_back(std::make_shared<ASIOReactor>());
+        }
+        executor =
+            stdx::make_unique<ServiceExecutorReactor>(getGlobalServiceContext(), reactors);
+    }
+
+    std::unique_ptr<ServiceExecutorReactor> executor;
+};
+
 void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
@@ -191,6 +227,40 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorAdaptiveFixture, TasksScheduledByWorkersUseLocalQueues) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    constexpr int kTasks = 100;
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int remaining = kTasks;
+
+    stdx::function<void()> task = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (--remaining == 0) {
+            cond.notify_all();
+            return;
+        }
+        ASSERT_OK(executor->schedule(
+            task, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        task, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return remaining == 0; });
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj()["serviceExecutorTaskStats"]["runQueues"].Obj();
+
+    // The first task starts a session and must go through the reactor, everything it schedules
+    // afterwards stays on the worker that ran it.
+    ASSERT_EQ(stats["shared"]["totalQueued"].numberLong(), 1);
+    ASSERT_EQ(stats["local"]["totalQueued"].numberLong(), kTasks - 1);
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
@@ -202,6 +272,48 @@ TEST_F(ServiceExecutorSynchronousFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorReactorFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorReactorFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorReactorFixture, TasksStayOnTheSchedulingReactor) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    std::vector<stdx::thread::id> threadIds;
+    const size_t kNumTasks = 10;
+
+    // Each task reschedules the next one from within the executor, so all of them should run on
+    // the reactor thread that ran the first one.
+    stdx::function<void()> task = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        threadIds.push_back(stdx::this_thread::get_id());
+        if (threadIds.size() < kNumTasks) {
+            ASSERT_OK(executor->schedule(
+                task, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+        } else {
+            cond.notify_all();
+        }
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        task, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return threadIds.size() == kNumTasks; });
+
+    for (const auto& threadId : threadIds) {
+        ASSERT(threadId == threadIds.front());
+    }
+}
 
 }  // namespace
 }  // namespace mongo
@@ -35,6 +35,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
@@ -49,11 +50,23 @@
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
+
+// The maximum number of requests, that were already pipelined by the client, which a session will
+// process back-to-back before sending their replies. A value of 1 disables pipelining.
+MONGO_EXPORT_SERVER_PARAMETER(maxPipelinedRequests, int, 32);
+
+// Once the coalesced replies of pipelined requests reach this size, or the first of them has been
+// waiting this long, they are sent, even if more requests are already buffered.
+constexpr size_t kMaxCoalescedReplyBytes = 1024 * 1024;
+constexpr Milliseconds kMaxCoalescingDelay{5};
+
 // Set up proper headers for formatting an exhaust request, if we need to
 bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     MsgData::View header = dbresponse.response.header();
@@ -87,6 +100,22 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Builds the request for the next batch of an OP_MSG exhaust stream, if we need to
+bool setOpMsgExhaustMessage(Message* m, const DbResponse& dbresponse) {
+    if (!dbresponse.nextInvocation) {
+        return false;
+    }
+
+    OpMsg request;
+    request.body = *dbresponse.nextInvocation;
+    *m = request.serialize();
+    OpMsg::setFlag(m, OpMsg::kExhaustSupported);
+
+    // Each reply in the stream answers the reply before it.
+    m->header().setId(dbresponse.response.header().getId());
+    return true;
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -260,9 +289,10 @@ void ServiceStateMachine::_sourceMessage(ThreadGuard guard) {
     });
 }
 
-void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
-    // Sink our response to the client
+void ServiceStateMachine::_sinkMessages(ThreadGuard guard, std::vector<Message> toSink) {
+    // Sink our responses to the client
     invariant(_state.load() == State::Process);
+    invariant(!toSink.empty());
     _state.store(State::SinkWait);
     guard.release();
 
@@ -271,10 +301,16 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
             // We don't consider ourselves idle while sending the reply since we are still doing
             // work on behalf of the client. Contrast that with sourceMessage() where we are waiting
             // for the client to send us more work to do.
-            return Future<void>::makeReady(_session()->sinkMessage(std::move(toSink)));
+            if (toSink.size() == 1) {
+                return Future<void>::makeReady(_session()->sinkMessage(std::move(toSink.front())));
+            }
+            return Future<void>::makeReady(_session()->sinkMessages(std::move(toSink)));
         } else {
             invariant(_transportMode == transport::Mode::kAsynchronous);
-            return _session()->asyncSinkMessage(std::move(toSink));
+            if (toSink.size() == 1) {
+                return _session()->asyncSinkMessage(std::move(toSink.front()));
+            }
+            return _session()->asyncSinkMessages(std::move(toSink));
         }
     };
 
@@ -339,6 +375,10 @@ void ServiceStateMachine::_sinkCallback(Status status) {
               << _session()->remote() << " (connection id: " << _session()->id() << ")";
         _state.store(State::EndSession);
         return _runNextInGuard(std::move(guard));
+    } else if (_endSessionAfterSink) {
+        // A pipelined request failed after the replies just sunk had been produced.
+        _state.store(State::EndSession);
+        return _runNextInGuard(std::move(guard));
     } else if (_inExhaust) {
         _state.store(State::Process);
         return _scheduleNextWithGuard(std::move(guard),
@@ -355,6 +395,67 @@ void ServiceStateMachine::_sinkCallback(Status status) {
 }
 
 void ServiceStateMachine::_processMessage(ThreadGuard guard) {
+    const auto maxPipelined = maxPipelinedRequests.load();
+
+    std::vector<Message> replies;
+    size_t replyBytes = 0;
+    Timer coalescingTimer;
+    for (int processed = 1;; ++processed) {
+        Message reply;
+        try {
+            reply = _processOneMessage();
+        } catch (const DBException& e) {
+            if (replies.empty())
+                throw;
+
+            // The client still gets the replies of the requests that preceded the failed one,
+            // before the connection is closed.
+            log() << "DBException handling pipelined request, closing client connection after "
+                     "sending the preceding replies: "
+                  << redact(e);
+            _inExhaust = false;
+            _inMessage.reset();
+            _endSessionAfterSink = true;
+            break;
+        }
+
+        if (!reply.empty()) {
+            if (replies.empty()) {
+                coalescingTimer.reset();
+            }
+            replyBytes += reply.size();
+            replies.push_back(std::move(reply));
+        }
+
+        // Exhaust replies are sent before anything else is read from the client, and the replies
+        // collected so far are sent once they grow large or have been held back for long enough.
+        if (_inExhaust || processed >= maxPipelined || replyBytes >= kMaxCoalescedReplyBytes ||
+            (!replies.empty() && coalescingTimer.millis() >= kMaxCoalescingDelay.count())) {
+            break;
+        }
+
+        // Keep going as long as the client has already sent us the next request, so that one
+        // round of scheduling and a single write cover the whole pipelined batch.
+        auto next = _session()->sourceBufferedMessage();
+        if (!next) {
+            break;
+        }
+        _inMessage = std::move(*next);
+        invariant(!_inMessage.empty());
+    }
+
+    if (!replies.empty()) {
+        _sinkMessages(std::move(guard), std::move(replies));
+    } else {
+        _state.store(State::Source);
+        _inMessage.reset();
+        return _scheduleNextWithGuard(std::move(guard),
+                                      ServiceExecutor::kDeferredTask,
+                                      transport::ServiceExecutorTaskName::kSSMSourceMessage);
+    }
+}
+
+Message ServiceStateMachine::_processOneMessage() {
     invariant(!_inMessage.empty());
 
     auto& compressorMgr = MessageCompressorManager::forSession(_session());
@@ -383,35 +484,34 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
     // Format our response, if we have one
     Message& toSink = dbresponse.response;
-    if (!toSink.empty()) {
-        invariant(!OpMsg::isFlagSet(_inMessage, OpMsg::kMoreToCome));
-        toSink.header().setId(nextMessageId());
-        toSink.header().setResponseToMsgId(_inMessage.header().getId());
-
-        // If this is an exhaust cursor, don't source more Messages
-        if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
-            _inExhaust = true;
-        } else {
-            _inExhaust = false;
-            _inMessage.reset();
-        }
-
-        networkCounter.hitLogicalOut(toSink.size());
+    if (toSink.empty()) {
+        _inExhaust = false;
+        _inMessage.reset();
+        return Message();
+    }
 
-        if (_compressorId) {
-            auto swm = compressorMgr.compressMessage(toSink, &_compressorId.value());
-            uassertStatusOK(swm.getStatus());
-            toSink = swm.getValue();
-        }
-        _sinkMessage(std::move(guard), std::move(toSink));
+    invariant(!OpMsg::isFlagSet(_inMessage, OpMsg::kMoreToCome));
+    toSink.header().setId(nextMessageId());
+    toSink.header().setResponseToMsgId(_inMessage.header().getId());
 
+    // If this is an exhaust cursor, don't source more Messages
+    if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
+        _inExhaust = true;
+    } else if (setOpMsgExhaustMessage(&_inMessage, dbresponse)) {
+        _inExhaust = true;
     } else {
-        _state.store(State::Source);
+        _inExhaust = false;
         _inMessage.reset();
-        return _scheduleNextWithGuard(std::move(guard),
-                                      ServiceExecutor::kDeferredTask,
-                                      transport::ServiceExecutorTaskName::kSSMSourceMessage);
     }
+
+    networkCounter.hitLogicalOut(toSink.size());
+
+    if (_compressorId) {
+        auto swm = compressorMgr.compressMessage(toSink, &_compressorId.value());
+        uassertStatusOK(swm.getStatus());
+        toSink = swm.getValue();
+    }
+    return std::move(toSink);
 }
 
 void ServiceStateMachine::runNext() {
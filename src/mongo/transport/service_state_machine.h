@@ -29,6 +29,7 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -192,9 +193,19 @@ private:
     /*
      * This function actually calls into the database and processes a request. It's broken out
      * into its own inline function for better readability.
+     *
+     * After the sourced request has been handled, any further requests that the client has
+     * already pipelined onto the connection are processed back-to-back, and all of their replies
+     * are sunk together.
      */
     inline void _processMessage(ThreadGuard guard);
 
+    /*
+     * Processes the request in _inMessage and returns the reply to send for it, which is empty if
+     * the request has no reply.
+     */
+    Message _processOneMessage();
+
     /*
      * These get called by the TransportLayer when requested network I/O has completed.
      */
@@ -206,7 +217,7 @@ private:
      * before waiting on the TL.
      */
     void _sourceMessage(ThreadGuard guard);
-    void _sinkMessage(ThreadGuard guard, Message toSink);
+    void _sinkMessages(ThreadGuard guard, std::vector<Message> toSink);
 
     /*
      * Releases all the resources associated with the session and call the cleanupHook.
@@ -227,6 +238,10 @@ private:
     stdx::function<void()> _cleanupHook;
 
     bool _inExhaust = false;
+
+    // Set when a pipelined request failed, whose predecessors' replies are being sunk before the
+    // session gets ended
+    bool _endSessionAfterSink = false;
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
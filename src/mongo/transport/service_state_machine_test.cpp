@@ -79,6 +79,9 @@ public:
         if (_uassertInHandler)
             uassert(40469, "Synthetic uassert failure", false);
 
+        if (_requestsBeforeUassert && (*_requestsBeforeUassert)-- == 0)
+            uassert(40470, "Synthetic uassert failure in a pipelined request", false);
+
         return DbResponse{builder.finish()};
     }
 
@@ -100,6 +103,10 @@ public:
         _uassertInHandler = true;
     }
 
+    void setUassertAfterRequests(int requests) {
+        _requestsBeforeUassert = requests;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -108,6 +115,7 @@ public:
 
 private:
     bool _uassertInHandler = false;
+    boost::optional<int> _requestsBeforeUassert;
     bool _ranHandler = false;
 };
 
@@ -163,6 +171,26 @@ public:
 
             return out;
         }
+
+        boost::optional<Message> sourceBufferedMessage() override {
+            auto tl = checked_cast<MockTL*>(getTransportLayer());
+            ASSERT_EQ(tl->_ssm->state(), ServiceStateMachine::State::Process);
+
+            if (tl->_bufferedRequests == 0) {
+                return boost::none;
+            }
+            --tl->_bufferedRequests;
+
+            OpMsgBuilder builder;
+            builder.setBody(BSON("ping" << 1));
+            return builder.finish();
+        }
+
+        Status sinkMessages(std::vector<Message> messages) override {
+            auto tl = checked_cast<MockTL*>(getTransportLayer());
+            tl->_lastSunkBatchSize = messages.size();
+            return MockSession::sinkMessages(std::move(messages));
+        }
     };
 
     MockTL() {
@@ -195,12 +223,26 @@ public:
         _waitHook = std::move(hook);
     }
 
+    void setBufferedRequests(size_t count) {
+        _bufferedRequests = count;
+    }
+
+    size_t bufferedRequests() const {
+        return _bufferedRequests;
+    }
+
+    size_t lastSunkBatchSize() const {
+        return _lastSunkBatchSize;
+    }
+
 private:
     bool _lastTicketSource = true;
     bool _ranSink = false;
     bool _ranSource = false;
     FailureMode _nextShouldFail = Nothing;
     Message _lastSunk;
+    size_t _bufferedRequests = 0;
+    size_t _lastSunkBatchSize = 0;
     ServiceStateMachine* _ssm;
     stdx::function<void()> _waitHook;
 };
@@ -339,6 +381,25 @@ TEST_F(ServiceStateMachineFixture, TestOkaySimpleCommand) {
     checkPingOk();
 }
 
+TEST_F(ServiceStateMachineFixture, PipelinedRequestsAreProcessedTogether) {
+    _tl->setBufferedRequests(2);
+
+    runPingTest(State::Process, State::Source);
+    ASSERT_EQ(_tl->bufferedRequests(), 0UL);
+    ASSERT_EQ(_tl->lastSunkBatchSize(), 3UL);
+    checkPingOk();
+}
+
+TEST_F(ServiceStateMachineFixture, PipelinedFailureSendsPrecedingReplies) {
+    _tl->setBufferedRequests(2);
+    _sep->setUassertAfterRequests(1);
+
+    runPingTest(State::Process, State::Ended);
+    ASSERT_TRUE(_tl->ranSink());
+    ASSERT_EQ(_tl->bufferedRequests(), 1UL);
+    checkPingOk();
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
@@ -68,5 +68,27 @@ Session::TagMask Session::getTags() const {
     return _tags.load();
 }
 
+Status Session::sinkMessages(std::vector<Message> messages) {
+    for (auto& message : messages) {
+        auto status = sinkMessage(std::move(message));
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+Future<void> Session::asyncSinkMessages(std::vector<Message> messages,
+                                        const transport::BatonHandle& handle) {
+    auto future = Future<void>::makeReady();
+    for (auto& message : messages) {
+        future = std::move(future).then(
+            [ self = shared_from_this(), message = std::move(message), handle ]() mutable {
+                return self->asyncSinkMessage(std::move(message), handle);
+            });
+    }
+    return future;
+}
+
 }  // namespace transport
 }  // namespace mongo
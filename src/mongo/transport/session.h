@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/platform/atomic_word.h"
@@ -107,6 +108,16 @@ public:
     virtual StatusWith<Message> sourceMessage() = 0;
     virtual Future<Message> asyncSourceMessage(const transport::BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Returns the next Message if the remote host has already sent all of it, without waiting for
+     * the network. Returns boost::none if no complete Message is available right away, or if this
+     * Session doesn't support reading ahead; the Message will then be returned by the next call to
+     * sourceMessage() or asyncSourceMessage() instead.
+     */
+    virtual boost::optional<Message> sourceBufferedMessage() {
+        return boost::none;
+    }
+
     /**
      * Sink (send) a Message to the remote host for this Session.
      *
@@ -116,6 +127,16 @@ public:
     virtual Future<void> asyncSinkMessage(Message message,
                                           const transport::BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Sink (send) several Messages to the remote host for this Session, in order.
+     *
+     * The default implementations send the Messages one at a time, Sessions which are able to
+     * should coalesce them into a single write.
+     */
+    virtual Status sinkMessages(std::vector<Message> messages);
+    virtual Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                           const transport::BatonHandle& handle = nullptr);
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
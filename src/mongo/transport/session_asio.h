@@ -29,13 +29,17 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
+#include "mongo/transport/io_uring_context.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/zero_copy_sender.h"
 #include "mongo/util/net/sock.h"
 #ifdef MONGO_CONFIG_SSL
 #include "mongo/util/net/ssl_manager.h"
@@ -131,8 +135,52 @@ public:
         return sourceMessageImpl(baton);
     }
 
+    boost::optional<Message> sourceBufferedMessage() override {
+        if (!canReadAhead()) {
+            return boost::none;
+        }
+
+        // Only messages which fit into the read-ahead buffer are returned from here, anything
+        // else is left to the regular read path, which also reports malformed messages.
+        auto buffered = _readAheadEnd - _readAheadBegin;
+        auto msgLen = bufferedMessageLength();
+        if (!msgLen || *msgLen > buffered) {
+            if (_readAhead.empty()) {
+                _readAhead.resize(kReadAheadBytes);
+            } else if (_readAheadBegin > 0) {
+                memmove(_readAhead.data(), _readAhead.data() + _readAheadBegin, buffered);
+                _readAheadBegin = 0;
+                _readAheadEnd = buffered;
+            }
+
+            auto size = ::recv(getSocket().native_handle(),
+                               _readAhead.data() + _readAheadEnd,
+                               _readAhead.size() - _readAheadEnd,
+                               MSG_DONTWAIT);
+            if (size <= 0) {
+                return boost::none;
+            }
+            _readAheadEnd += size;
+            buffered += size;
+
+            msgLen = bufferedMessageLength();
+            if (!msgLen || *msgLen > buffered) {
+                return boost::none;
+            }
+        }
+
+        auto buffer = SharedBuffer::allocate(*msgLen);
+        memcpy(buffer.get(), _readAhead.data() + _readAheadBegin, *msgLen);
+        _readAheadBegin += *msgLen;
+        networkCounter.hitPhysicalIn(*msgLen);
+        return Message(std::move(buffer));
+    }
+
     Status sinkMessage(Message message) override {
         ensureSync();
+        if (shouldWriteZeroCopy(message, nullptr)) {
+            return writeMessages({std::move(message)}).getNoThrow();
+        }
 
         return write(asio::buffer(message.buf(), message.size()))
             .then([&message] { networkCounter.hitPhysicalOut(message.size()); })
@@ -142,18 +190,41 @@ public:
     Future<void> asyncSinkMessage(Message message,
                                   const transport::BatonHandle& baton = nullptr) override {
         ensureAsync();
+        if (shouldWriteZeroCopy(message, baton)) {
+            return writeMessages({std::move(message)});
+        }
         return write(asio::buffer(message.buf(), message.size()), baton)
             .then([message /*keep the buffer alive*/]() {
                 networkCounter.hitPhysicalOut(message.size());
             });
     }
 
+    Status sinkMessages(std::vector<Message> messages) override {
+        ensureSync();
+        if (!canWriteVectored(nullptr)) {
+            return Session::sinkMessages(std::move(messages));
+        }
+        return writeMessages(std::move(messages)).getNoThrow();
+    }
+
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const transport::BatonHandle& baton = nullptr) override {
+        ensureAsync();
+        if (!canWriteVectored(baton)) {
+            return Session::asyncSinkMessages(std::move(messages), baton);
+        }
+        return writeMessages(std::move(messages));
+    }
+
     void cancelAsyncOperations(const transport::BatonHandle& baton = nullptr) override {
         LOG(3) << "Cancelling outstanding I/O operations on connection to " << _remote;
         if (baton) {
             baton->cancelSession(*this);
         } else {
             getSocket().cancel();
+            if (_ioUring) {
+                _ioUring->cancel(getSocket().native_handle());
+            }
         }
     }
 
@@ -361,6 +432,21 @@ private:
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
+        if (_readAheadBegin != _readAheadEnd) {
+            // Anything that sourceBufferedMessage() has already received comes first.
+            auto copied = asio::buffer_copy(buffers,
+                                            asio::buffer(_readAhead.data() + _readAheadBegin,
+                                                         _readAheadEnd - _readAheadBegin));
+            _readAheadBegin += copied;
+            if (copied == asio::buffer_size(buffers)) {
+                return Future<void>::makeReady();
+            }
+
+            MutableBufferSequence remaining(buffers);
+            remaining += copied;
+            return opportunisticRead(_socket, remaining, baton);
+        }
+
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket) {
             return opportunisticRead(*_sslSocket, buffers, baton);
@@ -408,10 +494,191 @@ private:
         return opportunisticWrite(_socket, buffers, baton);
     }
 
+    /**
+     * Returns whether sourceBufferedMessage() may receive data ahead of the regular read path. This
+     * is only done on plain sockets, since the TLS stream keeps its own buffers, and not on sockets
+     * whose reads go through io_uring, which must not be bypassed by a direct recv.
+     */
+    bool canReadAhead() {
+#ifdef _WIN32
+        return false;
+#else
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket || !_ranHandshake)
+            return false;
+#endif
+        if (ioUringFor(_socket))
+            return false;
+        return getSocket().is_open();
+#endif
+    }
+
+    /**
+     * Returns the length of the message at the front of the read-ahead buffer, or boost::none if
+     * its header hasn't been received completely or the message can't be returned from there.
+     */
+    boost::optional<size_t> bufferedMessageLength() {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        if (_readAheadEnd - _readAheadBegin < kHeaderSize) {
+            return boost::none;
+        }
+
+        const auto header = asio::buffer(_readAhead.data() + _readAheadBegin, kHeaderSize);
+        if (checkForHTTPRequest(header)) {
+            return boost::none;
+        }
+
+        const auto msgLen = size_t(MSGHEADER::ConstView(_readAhead.data() + _readAheadBegin)
+                                       .getMessageLength());
+        if (msgLen < kHeaderSize || msgLen > _readAhead.size()) {
+            return boost::none;
+        }
+        return msgLen;
+    }
+
+    /**
+     * Returns whether several messages can be sent with a single gathering write on the socket.
+     * Otherwise they are written one after another through the regular write path.
+     */
+    bool canWriteVectored(const transport::BatonHandle& baton) {
+        if (baton || ioUringFor(_socket))
+            return false;
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket || !_ranHandshake)
+            return false;
+#endif
+        return true;
+    }
+
+    /**
+     * Sends the messages with a single gathering write. Large writes are sent without copying the
+     * messages into the kernel, if that is enabled and supported.
+     */
+    Future<void> writeMessages(std::vector<Message> messages) {
+        size_t totalSize = 0;
+        std::vector<ConstSharedBufferFragment> fragments;
+        fragments.reserve(messages.size());
+        for (const auto& message : messages) {
+            fragments.emplace_back(message.sharedBuffer(), 0, message.size());
+            totalSize += message.size();
+        }
+
+        std::error_code ec;
+        size_t size;
+        if (auto zeroCopy = zeroCopySenderFor(totalSize)) {
+            zeroCopy->reapCompletions();
+            size = zeroCopy->send(fragments, ec);
+        } else {
+            size = asio::write(_socket, toConstBuffers(fragments), ec);
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            // Skip over whatever was sent before the socket filled up.
+            auto it = fragments.begin();
+            while (size >= it->size()) {
+                size -= it->size();
+                ++it;
+            }
+            fragments.erase(fragments.begin(), it);
+            fragments.front().advance(size);
+
+            auto asyncBuffers = toConstBuffers(fragments);
+            return asio::async_write(_socket, asyncBuffers, UseFuture{})
+                .then([ fragments = std::move(fragments) /*keep the buffers alive*/, totalSize ](
+                    size_t) { networkCounter.hitPhysicalOut(totalSize); });
+        } else if (ec) {
+            return futurize(ec);
+        }
+
+        networkCounter.hitPhysicalOut(totalSize);
+        return Future<void>::makeReady();
+    }
+
+    static std::vector<asio::const_buffer> toConstBuffers(
+        const std::vector<ConstSharedBufferFragment>& fragments) {
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(fragments.size());
+        for (const auto& fragment : fragments) {
+            buffers.emplace_back(fragment.data(), fragment.size());
+        }
+        return buffers;
+    }
+
+    /**
+     * Returns whether a single message should be sent through writeMessages(), because it is large
+     * enough to be sent without copying.
+     */
+    bool shouldWriteZeroCopy(const Message& message, const transport::BatonHandle& baton) {
+        const auto threshold = ZeroCopySender::thresholdBytes();
+        return threshold && !_zeroCopyUnavailable && message.size() >= threshold &&
+            canWriteVectored(baton);
+    }
+
+    /**
+     * Returns the zero-copy sender to write 'size' bytes with, or nullptr if they should be copied
+     * into the kernel as usual. Zero-copy sends are turned off for the session if the kernel
+     * doesn't support them on this socket, or copies the data anyway.
+     */
+    ZeroCopySender* zeroCopySenderFor(size_t size) {
+        const auto threshold = ZeroCopySender::thresholdBytes();
+        if (!threshold || size < threshold || _zeroCopyUnavailable) {
+            return nullptr;
+        }
+
+        if (!_zeroCopySender) {
+            const auto family = endpointToSockAddr(_socket.local_endpoint()).getType();
+            auto sender = stdx::make_unique<ZeroCopySender>(_socket.native_handle());
+            if ((family != AF_INET && family != AF_INET6) || !sender->enable()) {
+                _zeroCopyUnavailable = true;
+                return nullptr;
+            }
+            _zeroCopySender = std::move(sender);
+        } else if (_zeroCopySender->kernelCopied()) {
+            LOG(2) << "Kernel copies zero-copy sends to " << _remote << ", disabling them";
+            _zeroCopyUnavailable = true;
+            return nullptr;
+        }
+
+        return _zeroCopySender.get();
+    }
+
+    /**
+     * Returns the io_uring context, which I/O on the specified stream should go through, or nullptr
+     * if it should go through ASIO. Only plain sockets in asynchronous mode use io_uring, because
+     * the TLS stream has to drive its own reads and writes.
+     */
+    IoUringContext* ioUringFor(GenericSocket& socket) {
+        if (_blockingMode != Async)
+            return nullptr;
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket)
+            return nullptr;
+#endif
+        return _ioUring;
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    IoUringContext* ioUringFor(asio::ssl::stream<GenericSocket>& socket) {
+        return nullptr;
+    }
+#endif
+
     template <typename Stream, typename MutableBufferSequence>
     Future<void> opportunisticRead(Stream& stream,
                                    const MutableBufferSequence& buffers,
                                    const transport::BatonHandle& baton = nullptr) {
+        // With io_uring the read is submitted right away instead of being attempted first, so
+        // that it gets batched with the other sessions' I/O.
+        if (auto ioUring = ioUringFor(stream)) {
+            if (!baton) {
+                return ioUring->recv(getSocket().native_handle(),
+                                     asio::buffer_cast<char*>(buffers),
+                                     asio::buffer_size(buffers));
+            }
+        }
+
         std::error_code ec;
         auto size = asio::read(stream, buffers, ec);
         if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
@@ -473,6 +740,14 @@ private:
     Future<void> opportunisticWrite(Stream& stream,
                                     const ConstBufferSequence& buffers,
                                     const transport::BatonHandle& baton = nullptr) {
+        if (auto ioUring = ioUringFor(stream)) {
+            if (!baton) {
+                return ioUring->send(getSocket().native_handle(),
+                                     asio::buffer_cast<const char*>(buffers),
+                                     asio::buffer_size(buffers));
+            }
+        }
+
         std::error_code ec;
         auto size = asio::write(stream, buffers, ec);
         if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
@@ -648,6 +923,22 @@ private:
 #endif
 
     TransportLayerASIO* const _tl;
+
+    // The io_uring context of the reactor owning this session, if network I/O should go through it
+    IoUringContext* _ioUring = nullptr;
+
+    // Data received by sourceBufferedMessage() which hasn't been consumed yet lives in
+    // [_readAheadBegin, _readAheadEnd) of _readAhead. The buffer is only allocated once a client
+    // actually pipelines requests.
+    static constexpr size_t kReadAheadBytes = 64 * 1024;
+    std::vector<char> _readAhead;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
+    // Created on the first write large enough to be sent without copying. It has to be destroyed
+    // before the socket it sends on, so it is declared after it.
+    std::unique_ptr<ZeroCopySender> _zeroCopySender;
+    bool _zeroCopyUnavailable = false;
 };
 
 }  // namespace transport
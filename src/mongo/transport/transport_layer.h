@@ -154,6 +154,11 @@ public:
      */
     virtual void run() noexcept = 0;
     virtual void runFor(Milliseconds time) noexcept = 0;
+
+    /*
+     * Run at most one handler of the event loop, waiting up to time for one to become ready.
+     */
+    virtual void runOneFor(Milliseconds time) noexcept = 0;
     virtual void stop() = 0;
 
     using Task = stdx::function<void()>;
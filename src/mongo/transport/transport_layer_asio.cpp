@@ -40,8 +40,10 @@
 
 #include "mongo/base/system_error.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/transport/asio_utils.h"
+#include "mongo/transport/io_uring_context.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostandport.h"
@@ -63,6 +65,13 @@
 
 namespace mongo {
 namespace transport {
+namespace {
+
+// Whether ingress sessions in asynchronous mode should perform their network I/O through io_uring
+// instead of epoll. Ignored, with a warning, if the kernel does not support io_uring.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(transportLayerASIOUseIoUring, bool, false);
+
+}  // namespace
 
 class ASIOReactorTimer final : public ReactorTimer {
 public:
@@ -222,6 +231,18 @@ public:
         }
     }
 
+    void runOneFor(Milliseconds time) noexcept override {
+        ThreadIdGuard threadIdGuard(this);
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run_one_for(time.toSystemDuration());
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(50906);
+        }
+    }
+
     void stop() override {
         _ioContext.stop();
     }
@@ -250,6 +271,32 @@ public:
         return _ioContext;
     }
 
+    /**
+     * Makes the sessions of this reactor perform their socket I/O through io_uring. Returns an
+     * error if io_uring cannot be used, in which case the sessions keep using epoll.
+     */
+    Status enableIoUring() {
+        auto swIoUring = IoUringContext::create(_ioContext);
+        if (!swIoUring.isOK()) {
+            return swIoUring.getStatus();
+        }
+
+        _ioUring = std::move(swIoUring.getValue());
+        return Status::OK();
+    }
+
+    /**
+     * Makes the sessions of this reactor go back to performing their socket I/O through epoll.
+     * Must be called before any session has been started on the reactor.
+     */
+    void disableIoUring() {
+        _ioUring.reset();
+    }
+
+    IoUringContext* ioUring() const {
+        return _ioUring.get();
+    }
+
 private:
     class ThreadIdGuard {
     public:
@@ -265,6 +312,9 @@ private:
     static thread_local ASIOReactor* _reactorForThread;
 
     asio::io_context _ioContext;
+
+    // Declared after the io_context, because it registers a descriptor with it
+    std::unique_ptr<IoUringContext> _ioUring;
 };
 
 thread_local TransportLayerASIO::ASIOReactor* TransportLayerASIO::ASIOReactor::_reactorForThread =
@@ -291,6 +341,27 @@ TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
 #endif
       _sep(sep),
       _listenerOptions(opts) {
+    _ingressReactors.push_back(_ingressReactor);
+    while (_ingressReactors.size() < _listenerOptions.ingressReactorCount) {
+        _ingressReactors.push_back(std::make_shared<ASIOReactor>());
+    }
+
+    if (transportLayerASIOUseIoUring && _listenerOptions.isIngress() &&
+        _listenerOptions.transportMode == Mode::kAsynchronous) {
+        // Either all the ingress reactors use io_uring or none of them do, so that the sessions
+        // behave the same regardless of which reactor they are assigned to.
+        for (auto& reactor : _ingressReactors) {
+            auto status = reactor->enableIoUring();
+            if (!status.isOK()) {
+                warning() << "Unable to use io_uring for network I/O, falling back to epoll: "
+                          << status;
+                for (auto& enabledReactor : _ingressReactors) {
+                    enabledReactor->disableIoUring();
+                }
+                break;
+            }
+        }
+    }
 }
 
 TransportLayerASIO::~TransportLayerASIO() = default;
@@ -742,8 +813,17 @@ ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
     MONGO_UNREACHABLE;
 }
 
+std::vector<ReactorHandle> TransportLayerASIO::getIngressReactors() {
+    return std::vector<ReactorHandle>(_ingressReactors.begin(), _ingressReactors.end());
+}
+
 void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
-    auto acceptCb = [this, &acceptor](const std::error_code& ec, GenericSocket peerSocket) mutable {
+    // The reactor the accepted socket gets registered with has to be chosen before the connection
+    // is accepted.
+    auto reactor = _ingressReactors[_nextIngressReactor++ % _ingressReactors.size()];
+
+    auto acceptCb = [this, &acceptor, reactor](const std::error_code& ec,
+                                               GenericSocket peerSocket) mutable {
         if (!_running.load())
             return;
 
@@ -756,7 +836,20 @@ void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
 
         try {
             std::shared_ptr<ASIOSession> session(new ASIOSession(this, std::move(peerSocket)));
-            _sep->startSession(std::move(session));
+            session->_ioUring = reactor->ioUring();
+            if (_ingressReactors.size() == 1) {
+                _sep->startSession(std::move(session));
+            } else {
+                // Start the session on the thread running its reactor, so that all of its work
+                // stays on the thread which owns it.
+                reactor->schedule(Reactor::kPost, [this, session]() mutable {
+                    try {
+                        _sep->startSession(std::move(session));
+                    } catch (const DBException& e) {
+                        warning() << "Error starting new session " << e;
+                    }
+                });
+            }
         } catch (const DBException& e) {
             warning() << "Error accepting new connection " << e;
         }
@@ -764,7 +857,7 @@ void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
         _acceptConnection(acceptor);
     };
 
-    acceptor.async_accept(*_ingressReactor, std::move(acceptCb));
+    acceptor.async_accept(*reactor, std::move(acceptCb));
 }
 
 #ifdef MONGO_CONFIG_SSL
@@ -30,6 +30,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/config.h"
@@ -99,6 +100,8 @@ public:
         Mode transportMode = Mode::kSynchronous;  // whether accepted sockets should be put into
                                                   // non-blocking mode after they're accepted
         size_t maxConns = DEFAULT_MAX_CONN;       // maximum number of active connections
+        size_t ingressReactorCount = 1;           // number of reactors accepted sockets are
+                                                  // sharded across
     };
 
     TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
@@ -117,6 +120,12 @@ public:
 
     ReactorHandle getReactor(WhichReactor which) final;
 
+    /**
+     * Returns the reactors across which accepted sessions are sharded. The first one is the
+     * reactor returned by getReactor(kIngress).
+     */
+    std::vector<ReactorHandle> getIngressReactors();
+
     Status start() final;
 
     void shutdown() final;
@@ -171,9 +180,16 @@ private:
     // state that is associated with the reactors), so that we destroy any existing acceptors or
     // other reactor associated state before we drop the refcount on the reactor, which may destroy
     // it.
+    //
+    // When more than one ingress reactor is configured, accepted sockets are assigned to the
+    // _ingressReactors round-robin and their sessions are started on the reactor that owns them.
     std::shared_ptr<ASIOReactor> _ingressReactor;
     std::shared_ptr<ASIOReactor> _egressReactor;
     std::shared_ptr<ASIOReactor> _acceptorReactor;
+    std::vector<std::shared_ptr<ASIOReactor>> _ingressReactors;
+
+    // Only accessed by the listener thread.
+    size_t _nextIngressReactor = 0;
 
 #ifdef MONGO_CONFIG_SSL
     std::unique_ptr<asio::ssl::context> _ingressSSLContext;
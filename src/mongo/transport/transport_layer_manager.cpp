@@ -35,6 +35,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_reactor.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
@@ -133,6 +134,9 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     transport::TransportLayerASIO::Options opts(config);
     if (config->serviceExecutor == "adaptive") {
         opts.transportMode = transport::Mode::kAsynchronous;
+    } else if (config->serviceExecutor == "reactor") {
+        opts.transportMode = transport::Mode::kAsynchronous;
+        opts.ingressReactorCount = ServiceExecutorReactor::getConfiguredReactorCount();
     } else if (config->serviceExecutor == "synchronous") {
         opts.transportMode = transport::Mode::kSynchronous;
     } else {
@@ -145,6 +149,9 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
         auto reactor = transportLayerASIO->getReactor(TransportLayer::kIngress);
         ctx->setServiceExecutor(
             stdx::make_unique<ServiceExecutorAdaptive>(ctx, std::move(reactor)));
+    } else if (config->serviceExecutor == "reactor") {
+        ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorReactor>(
+            ctx, transportLayerASIO->getIngressReactors()));
     } else if (config->serviceExecutor == "synchronous") {
         ctx->setServiceExecutor(stdx::make_unique<ServiceExecutorSynchronous>(ctx));
     }
@@ -0,0 +1,412 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/zero_copy_sender.h"
+
+#include <algorithm>
+#include <asio.hpp>
+
+#ifdef __linux__
+#include <ctime>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+#if defined(__linux__) && defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY) && \
+    defined(SO_EE_ORIGIN_ZEROCOPY)
+#define MONGO_HAVE_ZERO_COPY_SEND
+#endif
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Replies at least this large are sent without copying them into the kernel, on TCP connections
+// where the kernel supports it. Pinning the pages and reaping the completions only pays off for
+// large writes. The default of 0 disables zero-copy sends.
+MONGO_EXPORT_SERVER_PARAMETER(zeroCopySendThresholdBytes, int, 0);
+
+// The number of fragments passed to a single sendmsg call.
+constexpr size_t kMaxIovecs = 64;
+
+// How often the background reaper looks for completions of the sends, which are pending.
+constexpr Milliseconds kReapInterval{100};
+
+// How long the sends of a destroyed sender may wait for their completions. After that the socket is
+// closed and the buffers are released; the kernel holds on to the pinned pages by itself.
+constexpr Minutes kMaxLinger{10};
+
+}  // namespace
+
+struct ZeroCopySender::State {
+    explicit State(int fd) : fd(fd) {}
+
+    ~State() {
+#ifdef MONGO_HAVE_ZERO_COPY_SEND
+        if (fd >= 0)
+            ::close(fd);
+#endif
+    }
+
+    /**
+     * Releases the buffers of all the sends the kernel has reported as completed, without waiting.
+     */
+    void reap(WithLock);
+
+    void complete(WithLock, uint32_t first, uint32_t last);
+
+    mutable stdx::mutex mutex;
+
+    // A duplicate of the socket's descriptor. It keeps the socket open until the last completion
+    // has been reaped, even after the session has closed its own descriptor.
+    int fd;
+
+    std::deque<PendingSend> pending;
+    Stats stats;
+
+    // When the sender was destroyed, from which point on only the reaper refers to the state
+    boost::optional<Date_t> orphanedAt;
+};
+
+bool ZeroCopySender::isSupported() {
+#ifdef MONGO_HAVE_ZERO_COPY_SEND
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t ZeroCopySender::thresholdBytes() {
+    if (!isSupported()) {
+        return 0;
+    }
+    return std::max(zeroCopySendThresholdBytes.load(), 0);
+}
+
+ZeroCopySender::ZeroCopySender(int fd) : _fd(fd) {}
+
+size_t ZeroCopySender::pendingSends() const {
+    if (!_state)
+        return 0;
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->pending.size();
+}
+
+bool ZeroCopySender::kernelCopied() const {
+    return getStats().copiedByKernel > 0;
+}
+
+ZeroCopySender::Stats ZeroCopySender::getStats() const {
+    if (!_state)
+        return {};
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->stats;
+}
+
+void ZeroCopySender::reapCompletions() {
+    if (!_state)
+        return;
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    _state->reap(lk);
+}
+
+#ifdef MONGO_HAVE_ZERO_COPY_SEND
+
+/**
+ * Reaps the completions of the senders, which are not sending anything, and keeps the sends of the
+ * destroyed senders pinned until the kernel has completed them. Runs on a background thread, which
+ * is started when the first sender gets enabled.
+ */
+class ZeroCopySender::Reaper {
+public:
+    static Reaper& get() {
+        // Intentionally leaked, because the thread runs until the process exits.
+        static Reaper* reaper = new Reaper();
+        return *reaper;
+    }
+
+    void track(const std::shared_ptr<State>& state) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _tracked.push_back(state);
+    }
+
+    void adopt(std::shared_ptr<State> state) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _adopted.push_back(std::move(state));
+    }
+
+private:
+    Reaper() {
+        stdx::thread([this] {
+            setThreadName("ZeroCopySendReaper");
+            while (true) {
+                sleepFor(kReapInterval);
+                _reapAll();
+            }
+        }).detach();
+    }
+
+    void _reapAll() {
+        std::vector<std::shared_ptr<State>> states;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _tracked.erase(std::remove_if(_tracked.begin(),
+                                          _tracked.end(),
+                                          [](const std::weak_ptr<State>& state) {
+                                              return state.expired();
+                                          }),
+                           _tracked.end());
+            for (const auto& tracked : _tracked) {
+                if (auto state = tracked.lock()) {
+                    states.push_back(std::move(state));
+                }
+            }
+            states.insert(states.end(), _adopted.begin(), _adopted.end());
+        }
+
+        const auto now = Date_t::now();
+        for (const auto& state : states) {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            if (state->pending.empty())
+                continue;
+
+            state->reap(lk);
+            if (state->orphanedAt && !state->pending.empty() &&
+                now - *state->orphanedAt > kMaxLinger) {
+                warning() << "Releasing " << state->pending.size()
+                          << " zero-copy sends, which the kernel has not completed after "
+                          << kMaxLinger;
+                state->pending.clear();
+            }
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _adopted.erase(std::remove_if(_adopted.begin(),
+                                      _adopted.end(),
+                                      [](const std::shared_ptr<State>& state) {
+                                          stdx::lock_guard<stdx::mutex> stateLk(state->mutex);
+                                          return state->pending.empty();
+                                      }),
+                       _adopted.end());
+    }
+
+    stdx::mutex _mutex;
+
+    // The states of the live senders
+    std::vector<std::weak_ptr<State>> _tracked;
+
+    // The states of the destroyed senders, whose sends are still pending
+    std::vector<std::shared_ptr<State>> _adopted;
+};
+
+ZeroCopySender::~ZeroCopySender() {
+    if (!_state)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    _state->reap(lk);
+    if (_state->pending.empty())
+        return;
+
+    // The kernel may still transmit from the buffers, so the reaper keeps them pinned, along with
+    // the socket, until it reports the sends as completed.
+    LOG(3) << "Handing " << _state->pending.size() << " incomplete zero-copy sends to the reaper";
+    _state->orphanedAt = Date_t::now();
+    Reaper::get().adopt(_state);
+}
+
+bool ZeroCopySender::enable() {
+    int one = 1;
+    if (::setsockopt(_fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) != 0) {
+        LOG(2) << "Zero-copy sends are not available: " << errnoWithDescription();
+        return false;
+    }
+
+    const int errQueueFd = ::dup(_fd);
+    if (errQueueFd < 0) {
+        LOG(2) << "Zero-copy sends are not available, unable to duplicate the socket: "
+               << errnoWithDescription();
+        return false;
+    }
+
+    _state = std::make_shared<State>(errQueueFd);
+    Reaper::get().track(_state);
+    return true;
+}
+
+size_t ZeroCopySender::send(const std::vector<ConstSharedBufferFragment>& fragments,
+                            std::error_code& ec) {
+    invariant(_state);
+    ec = std::error_code();
+
+    size_t fragment = 0;
+    size_t offset = 0;
+    size_t sent = 0;
+    while (true) {
+        while (fragment < fragments.size() && fragments[fragment].size() == offset) {
+            ++fragment;
+            offset = 0;
+        }
+        if (fragment == fragments.size()) {
+            break;
+        }
+
+        std::vector<iovec> iovecs;
+        for (auto i = fragment; i < fragments.size() && iovecs.size() < kMaxIovecs; ++i) {
+            const auto skip = (i == fragment) ? offset : 0;
+            iovecs.push_back({const_cast<char*>(fragments[i].data()) + skip,
+                              fragments[i].size() - skip});
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iovecs.data();
+        msg.msg_iovlen = iovecs.size();
+
+        auto flags = MSG_NOSIGNAL | MSG_ZEROCOPY;
+        auto ret = ::sendmsg(_fd, &msg, flags);
+        if (ret < 0 && errno == ENOBUFS) {
+            // The kernel ran out of memory for tracking the pinned pages, so make room and send
+            // this part the regular way.
+            reapCompletions();
+            flags = MSG_NOSIGNAL;
+            ret = ::sendmsg(_fd, &msg, flags);
+        }
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ec = std::error_code(errno, asio::error::get_system_category());
+            break;
+        }
+
+        // Pin every buffer which the kernel may still be reading from.
+        PendingSend pending{_nextId, {}};
+        size_t remaining = ret;
+        while (remaining > 0) {
+            const auto available = fragments[fragment].size() - offset;
+            if (flags & MSG_ZEROCOPY) {
+                pending.pinned.push_back(fragments[fragment].buffer());
+            }
+            if (remaining < available) {
+                offset += remaining;
+                break;
+            }
+            remaining -= available;
+            offset = 0;
+            ++fragment;
+        }
+
+        if (flags & MSG_ZEROCOPY) {
+            ++_nextId;
+            stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+            ++_state->stats.sends;
+            _state->stats.bytes += ret;
+            _state->pending.push_back(std::move(pending));
+        }
+        sent += ret;
+    }
+
+    return sent;
+}
+
+void ZeroCopySender::State::reap(WithLock lk) {
+    while (!pending.empty()) {
+        char control[CMSG_SPACE(sizeof(sock_extended_err)) + 64];
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+
+        for (auto cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+                !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                continue;
+            }
+
+            const auto err = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+            if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                continue;
+            }
+            if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                ++stats.copiedByKernel;
+            }
+            complete(lk, err->ee_info, err->ee_data);
+        }
+    }
+}
+
+void ZeroCopySender::State::complete(WithLock, uint32_t first, uint32_t last) {
+    // The range may wrap around, which the unsigned arithmetic takes care of.
+    const auto inRange = [&](const PendingSend& pending) {
+        return uint32_t(pending.id - first) <= uint32_t(last - first);
+    };
+    const auto before = pending.size();
+    pending.erase(std::remove_if(pending.begin(), pending.end(), inRange), pending.end());
+    stats.completions += before - pending.size();
+}
+
+#else
+
+ZeroCopySender::~ZeroCopySender() = default;
+
+bool ZeroCopySender::enable() {
+    return false;
+}
+
+size_t ZeroCopySender::send(const std::vector<ConstSharedBufferFragment>& fragments,
+                            std::error_code& ec) {
+    MONGO_UNREACHABLE;
+}
+
+void ZeroCopySender::State::reap(WithLock) {}
+
+void ZeroCopySender::State::complete(WithLock, uint32_t first, uint32_t last) {}
+
+#endif
+
+}  // namespace transport
+}  // namespace mongo
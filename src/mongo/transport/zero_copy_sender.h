@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * Sends data on a TCP socket with MSG_ZEROCOPY, so that the kernel transmits it straight out of
+ * the sender's buffers instead of first copying it into the socket's send buffer.
+ *
+ * The kernel keeps referring to the sent bytes until it reports on the socket's error queue that
+ * it is done with them, so every send pins the buffers of the fragments it covered until then.
+ * Completions are reaped whenever more data is sent, and periodically by a background thread, so
+ * that the buffers of connections which have gone idle get released too. The sends which are still
+ * pending when the sender is destroyed are handed over to that thread, which keeps their buffers
+ * and a duplicate of the socket until the kernel has reported them as completed.
+ *
+ * This class is not thread-safe; it belongs to the session owning the socket.
+ */
+class ZeroCopySender {
+    MONGO_DISALLOW_COPYING(ZeroCopySender);
+
+public:
+    struct Stats {
+        int64_t sends = 0;
+        int64_t bytes = 0;
+        int64_t completions = 0;
+        int64_t copiedByKernel = 0;
+    };
+
+    /**
+     * Returns whether this build supports zero-copy sends at all. Whether the kernel does is only
+     * known once enable() is called on a socket.
+     */
+    static bool isSupported();
+
+    /**
+     * Returns the minimum size of a write for it to be worth sending without copying, or 0 if
+     * zero-copy sends are disabled.
+     */
+    static size_t thresholdBytes();
+
+    /**
+     * The socket is not owned, and has to outlive the sender. Once zero-copy sends are enabled the
+     * sender keeps its own duplicate of the socket's file descriptor for reaping the completions.
+     */
+    explicit ZeroCopySender(int fd);
+    ~ZeroCopySender();
+
+    /**
+     * Turns on zero-copy sends for the socket. Returns false if the kernel or the socket type
+     * doesn't support them, in which case send() must not be called.
+     */
+    bool enable();
+
+    /**
+     * Sends the fragments, in order, as far as the socket accepts them. Returns the number of bytes
+     * sent; if that is less than the total size of the fragments 'ec' tells why, e.g. that a
+     * non-blocking socket would block.
+     */
+    size_t send(const std::vector<ConstSharedBufferFragment>& fragments, std::error_code& ec);
+
+    /**
+     * Releases the buffers of all the sends the kernel has reported as completed, without waiting.
+     */
+    void reapCompletions();
+
+    /**
+     * Returns the number of sends whose buffers are still pinned.
+     */
+    size_t pendingSends() const;
+
+    /**
+     * Returns true once the kernel has reported that it had to copy the data after all, e.g.
+     * because the socket is a loopback connection. Sending without copying is only overhead then.
+     */
+    bool kernelCopied() const;
+
+    Stats getStats() const;
+
+private:
+    struct PendingSend {
+        uint32_t id;
+        std::vector<ConstSharedBuffer> pinned;
+    };
+
+    // The sends, which are pending, shared with the background reaper
+    struct State;
+    class Reaper;
+
+    const int _fd;
+
+    // The kernel numbers zero-copy sends consecutively, starting at 0, per socket.
+    uint32_t _nextId = 0;
+
+    // Set once zero-copy sends have been enabled
+    std::shared_ptr<State> _state;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/zero_copy_sender.h"
+
+#include <asio.hpp>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+class ZeroCopySenderTest : public unittest::Test {
+protected:
+    void setUp() override {
+        // Zero-copy sends are only supported on TCP sockets, so connect over the loopback.
+        int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_GTE(listener, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLen = sizeof(addr);
+        ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+        ASSERT_EQ(0, ::listen(listener, 1));
+        ASSERT_EQ(0, ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addrLen));
+
+        _localFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_EQ(0, ::connect(_localFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+        _remoteFd = ::accept(listener, nullptr, nullptr);
+        ASSERT_GTE(_remoteFd, 0);
+        ::close(listener);
+
+        _sender = stdx::make_unique<ZeroCopySender>(_localFd);
+        if (!_sender->enable()) {
+            log() << "Zero-copy sends are not supported, skipping test";
+            _sender.reset();
+        }
+    }
+
+    void tearDown() override {
+        _sender.reset();
+        if (_localFd >= 0)
+            ::close(_localFd);
+        if (_remoteFd >= 0)
+            ::close(_remoteFd);
+    }
+
+    bool supported() const {
+        return bool(_sender);
+    }
+
+    std::string receive(size_t size) {
+        std::string out(size, '\0');
+        size_t received = 0;
+        while (received < size) {
+            auto ret = ::recv(_remoteFd, &out[received], size - received, 0);
+            ASSERT_GT(ret, 0);
+            received += ret;
+        }
+        return out;
+    }
+
+    void waitForCompletions() {
+        while (_sender->pendingSends()) {
+            pollfd pfd{_localFd, 0, 0};
+            ::poll(&pfd, 1, 100);
+            _sender->reapCompletions();
+        }
+    }
+
+    static ConstSharedBufferFragment makeFragment(StringData data) {
+        auto buffer = SharedBuffer::allocate(data.size());
+        memcpy(buffer.get(), data.rawData(), data.size());
+        return {std::move(buffer), 0, data.size()};
+    }
+
+    std::unique_ptr<ZeroCopySender> _sender;
+    int _localFd = -1;
+    int _remoteFd = -1;
+};
+
+TEST_F(ZeroCopySenderTest, SendsFragmentsInOrder) {
+    if (!supported())
+        return;
+
+    std::vector<ConstSharedBufferFragment> fragments{makeFragment("hello "),
+                                                     makeFragment(""),
+                                                     makeFragment("zero-copy "),
+                                                     makeFragment("world")};
+    fragments[2].advance(5);
+
+    std::error_code ec;
+    ASSERT_EQ(16UL, _sender->send(fragments, ec));
+    ASSERT_FALSE(ec);
+    ASSERT_EQ("hello copy world", receive(16));
+}
+
+TEST_F(ZeroCopySenderTest, BuffersArePinnedUntilCompletion) {
+    if (!supported())
+        return;
+
+    std::vector<ConstSharedBufferFragment> fragments{makeFragment(std::string(64 * 1024, 'x'))};
+    ASSERT_FALSE(fragments.front().buffer().isShared());
+
+    std::error_code ec;
+    ASSERT_EQ(64UL * 1024, _sender->send(fragments, ec));
+    ASSERT_FALSE(ec);
+    ASSERT_EQ(1UL, _sender->pendingSends());
+    ASSERT_TRUE(fragments.front().buffer().isShared());
+
+    ASSERT_EQ(std::string(64 * 1024, 'x'), receive(64 * 1024));
+    waitForCompletions();
+    ASSERT_FALSE(fragments.front().buffer().isShared());
+
+    auto stats = _sender->getStats();
+    ASSERT_EQ(1, stats.sends);
+    ASSERT_EQ(64 * 1024, stats.bytes);
+    ASSERT_EQ(1, stats.completions);
+
+    // The loopback device can't transmit from the pinned pages, so the kernel copies the data
+    // after all and says so.
+    ASSERT_TRUE(_sender->kernelCopied());
+}
+
+TEST_F(ZeroCopySenderTest, PendingSendsOutliveTheSender) {
+    if (!supported())
+        return;
+
+    // Send more than the connection can take in, so that the tail of the data is still queued in
+    // the kernel when the sender goes away.
+    ASSERT_EQ(0, ::fcntl(_localFd, F_SETFL, ::fcntl(_localFd, F_GETFL) | O_NONBLOCK));
+    std::vector<ConstSharedBufferFragment> fragments{
+        makeFragment(std::string(64 * 1024 * 1024, 'x'))};
+
+    std::error_code ec;
+    const auto sent = _sender->send(fragments, ec);
+    ASSERT_TRUE(ec == asio::error::would_block || ec == asio::error::try_again);
+    ASSERT_GT(sent, 0UL);
+    ASSERT_GT(_sender->pendingSends(), 0UL);
+
+    // The kernel can't be done with the buffer yet, which must stay pinned after the sender and the
+    // session's descriptor are gone.
+    _sender.reset();
+    ::close(_localFd);
+    _localFd = -1;
+    ASSERT_TRUE(fragments.front().buffer().isShared());
+
+    // The background reaper releases the buffer once the kernel has completed the sends.
+    ASSERT_EQ(std::string(sent, 'x'), receive(sent));
+    for (int i = 0; i < 100 && fragments.front().buffer().isShared(); ++i) {
+        sleepmillis(100);
+    }
+    ASSERT_FALSE(fragments.front().buffer().isShared());
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/ticket_tuner.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+constexpr double TicketTuner::kWaitedThreshold;
+constexpr double TicketTuner::kThroughputDropThreshold;
+
+int TicketTuner::tune(int current, const Sample& sample) {
+    // Steps are proportional to the current number of tickets so that tuning converges in a
+    // similar number of intervals whatever the scale.
+    const int step = std::max(1, current / 8);
+
+    int target = current;
+    if (sample.storagePressure) {
+        target = current - step;
+        _lastDecision = Decision::kDecrease;
+    } else if (_lastChange > 0 &&
+               sample.acquired < _lastAcquired * (1 - kThroughputDropThreshold)) {
+        target = current - _lastChange;
+        _lastDecision = Decision::kRevert;
+    } else if (sample.acquired > 0 &&
+               static_cast<double>(sample.waited) / sample.acquired > kWaitedThreshold) {
+        target = current + step;
+        _lastDecision = Decision::kIncrease;
+    } else {
+        _lastDecision = Decision::kHold;
+    }
+
+    target = std::max(_minTickets, std::min(_maxTickets, target));
+    if (target == current) {
+        _lastDecision = Decision::kHold;
+    }
+
+    switch (_lastDecision) {
+        case Decision::kIncrease:
+            _increases++;
+            break;
+        case Decision::kDecrease:
+            _decreases++;
+            break;
+        case Decision::kRevert:
+            _reverts++;
+            break;
+        case Decision::kHold:
+            break;
+    }
+
+    _lastChange = target - current;
+    _lastAcquired = sample.acquired;
+    _lastTarget = target;
+    _lastAverageWaitMicros =
+        sample.waited > 0 ? durationCount<Microseconds>(sample.waitTime) / sample.waited : 0;
+    return target;
+}
+
+void TicketTuner::appendStats(BSONObjBuilder* bob) const {
+    bob->append("minTickets", _minTickets);
+    bob->append("maxTickets", _maxTickets);
+    bob->append("target", _lastTarget);
+    bob->append("lastDecision", decisionToString(_lastDecision));
+    bob->append("lastIntervalAcquired", _lastAcquired);
+    bob->append("lastIntervalAverageWaitMicros", _lastAverageWaitMicros);
+    bob->append("increases", _increases);
+    bob->append("decreases", _decreases);
+    bob->append("reverts", _reverts);
+}
+
+StringData TicketTuner::decisionToString(Decision decision) {
+    switch (decision) {
+        case Decision::kHold:
+            return "hold"_sd;
+        case Decision::kIncrease:
+            return "increase"_sd;
+        case Decision::kDecrease:
+            return "decrease"_sd;
+        case Decision::kRevert:
+            return "revert"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
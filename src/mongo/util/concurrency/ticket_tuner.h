@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/string_data.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Decides how many tickets a TicketHolder should have, one tuning interval at a time, from what
+ * was observed during the last interval.
+ *
+ * Tickets are added while operations queue for them and throughput keeps up, and an addition
+ * that made throughput drop is taken back. Tickets are removed whenever the storage engine is
+ * under pressure, since more concurrency then only makes operations compete for the same cache.
+ *
+ * Not thread safe.
+ */
+class TicketTuner {
+public:
+    struct Sample {
+        // Tickets handed out during the interval.
+        long long acquired = 0;
+
+        // Of those, the number that were not immediately available, and the time spent waiting.
+        long long waited = 0;
+        Microseconds waitTime{0};
+
+        // Whether the storage engine is struggling to keep up, e.g. application threads are
+        // doing cache eviction.
+        bool storagePressure = false;
+    };
+
+    enum class Decision { kHold, kIncrease, kDecrease, kRevert };
+
+    TicketTuner(int minTickets, int maxTickets)
+        : _minTickets(minTickets), _maxTickets(maxTickets) {}
+
+    void setBounds(int minTickets, int maxTickets) {
+        _minTickets = minTickets;
+        _maxTickets = maxTickets;
+    }
+
+    /**
+     * Returns the number of tickets to use for the next interval, given the number used during the
+     * interval that 'sample' describes.
+     */
+    int tune(int current, const Sample& sample);
+
+    Decision lastDecision() const {
+        return _lastDecision;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const;
+
+    static StringData decisionToString(Decision decision);
+
+private:
+    // Below this share of acquisitions having to wait, queueing is not worth more tickets.
+    static constexpr double kWaitedThreshold = 0.01;
+
+    // Throughput has to drop by more than this for an increase to be taken back.
+    static constexpr double kThroughputDropThreshold = 0.05;
+
+    int _minTickets;
+    int _maxTickets;
+
+    long long _lastAcquired = 0;
+    int _lastChange = 0;
+    Decision _lastDecision = Decision::kHold;
+    int _lastTarget = 0;
+    long long _lastAverageWaitMicros = 0;
+
+    long long _increases = 0;
+    long long _decreases = 0;
+    long long _reverts = 0;
+};
+
+}  // namespace mongo
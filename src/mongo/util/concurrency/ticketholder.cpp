@@ -35,9 +35,17 @@
 
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+void TicketHolder::_recordWaited(Date_t start) {
+    // Waits that ended without a ticket still count towards the time spent waiting, as they are
+    // just as much a sign of too few tickets.
+    _totalWaited.add(1);
+    _totalWaitMicros.add(durationCount<Microseconds>(Date_t::now() - start));
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -77,6 +85,30 @@ TicketHolder::~TicketHolder() {
 }
 
 bool TicketHolder::tryAcquire() {
+    if (!_trywait())
+        return false;
+    _recordAcquired();
+    return true;
+}
+
+void TicketHolder::waitForTicket(OperationContext* opCtx) {
+    waitForTicketUntil(opCtx, Date_t::max());
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    if (tryAcquire())
+        return true;
+
+    const Date_t start = Date_t::now();
+    ON_BLOCK_EXIT([&] { _recordWaited(start); });
+
+    if (!_timedwait(opCtx, until))
+        return false;
+    _recordAcquired();
+    return true;
+}
+
+bool TicketHolder::_trywait() {
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -86,11 +118,7 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_timedwait(OperationContext* opCtx, Date_t until) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -143,8 +171,10 @@ Status TicketHolder::resize(int newSize) {
         _outof.fetchAndAdd(1);
     }
 
+    // Take the tickets to retire without going through waitForTicket(), so that resizing does not
+    // show up in the acquisition statistics.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        _timedwait(nullptr, Date_t::max());
         _outof.subtractAndFetch(1);
     }
 
@@ -174,29 +204,41 @@ TicketHolder::~TicketHolder() = default;
 
 bool TicketHolder::tryAcquire() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    return _tryAcquire();
+    if (!_tryAcquire())
+        return false;
+    _recordAcquired();
+    return true;
 }
 
 void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
-    }
+    waitForTicketUntil(opCtx, Date_t::max());
 }
 
 bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_tryAcquire()) {
+        _recordAcquired();
+        return true;
+    }
+
+    const Date_t start = Date_t::now();
+    ON_BLOCK_EXIT([&] { _recordWaited(start); });
 
+    bool acquired = false;
     if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
+        acquired = opCtx->waitForConditionOrInterruptUntil(
             _newTicket, lk, until, [this] { return _tryAcquire(); });
+    } else if (until == Date_t::max()) {
+        _newTicket.wait(lk, [this] { return _tryAcquire(); });
+        acquired = true;
     } else {
-        return _newTicket.wait_until(
+        acquired = _newTicket.wait_until(
             lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
     }
+
+    if (acquired)
+        _recordAcquired();
+    return acquired;
 }
 
 void TicketHolder::release() {
@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/sharded_counter.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -79,8 +80,40 @@ public:
 
     int outof() const;
 
+    /**
+     * Cumulative counts of the tickets handed out, of those that were not immediately available,
+     * and of the total time spent waiting for the latter, for tuning the number of tickets.
+     */
+    long long totalAcquired() const {
+        return _totalAcquired.load();
+    }
+
+    long long totalWaited() const {
+        return _totalWaited.load();
+    }
+
+    Microseconds totalWaitTime() const {
+        return Microseconds(_totalWaitMicros.load());
+    }
+
 private:
+    void _recordAcquired() {
+        _totalAcquired.add(1);
+    }
+
+    void _recordWaited(Date_t start);
+
+    ShardedCounter64 _totalAcquired;
+    ShardedCounter64 _totalWaited;
+    ShardedCounter64 _totalWaitMicros;
+
 #if defined(__linux__)
+    /**
+     * Take a ticket without counting it in the statistics above, for resize().
+     */
+    bool _trywait();
+    bool _timedwait(OperationContext* opCtx, Date_t until);
+
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
@@ -32,6 +32,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticket_tuner.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
 namespace {
@@ -71,4 +72,63 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, CountsAcquisitionsAndWaits) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(5)));
+    holder.release();
+    ASSERT(holder.waitForTicketUntil(Date_t::now() + Milliseconds(5)));
+    holder.release();
+
+    ASSERT_EQ(holder.totalAcquired(), 2);
+    ASSERT_EQ(holder.totalWaited(), 1);
+    ASSERT_GTE(holder.totalWaitTime(), Milliseconds(1));
+}
+
+TEST(TicketholderTest, ResizingIsNotCounted) {
+    TicketHolder holder(10);
+    ASSERT_OK(holder.resize(20));
+    ASSERT_OK(holder.resize(6));
+    ASSERT_EQ(holder.outof(), 6);
+
+    ASSERT_EQ(holder.totalAcquired(), 0);
+    ASSERT_EQ(holder.totalWaited(), 0);
+}
+
+TicketTuner::Sample makeSample(long long acquired, long long waited, bool pressure = false) {
+    TicketTuner::Sample sample;
+    sample.acquired = acquired;
+    sample.waited = waited;
+    sample.waitTime = Microseconds(waited * 100);
+    sample.storagePressure = pressure;
+    return sample;
+}
+
+TEST(TicketTunerTest, GrowsWhileOperationsQueue) {
+    TicketTuner tuner(8, 256);
+    ASSERT_EQ(tuner.tune(128, makeSample(1000, 100)), 144);
+    ASSERT(tuner.lastDecision() == TicketTuner::Decision::kIncrease);
+
+    // Nobody waited, so there is nothing to gain from more tickets.
+    ASSERT_EQ(tuner.tune(144, makeSample(1100, 0)), 144);
+    ASSERT(tuner.lastDecision() == TicketTuner::Decision::kHold);
+}
+
+TEST(TicketTunerTest, RevertsIncreaseThatLowersThroughput) {
+    TicketTuner tuner(8, 256);
+    ASSERT_EQ(tuner.tune(128, makeSample(1000, 100)), 144);
+    ASSERT_EQ(tuner.tune(144, makeSample(800, 100)), 128);
+    ASSERT(tuner.lastDecision() == TicketTuner::Decision::kRevert);
+}
+
+TEST(TicketTunerTest, ShrinksUnderStoragePressureWithinBounds) {
+    TicketTuner tuner(120, 256);
+    ASSERT_EQ(tuner.tune(128, makeSample(1000, 100, true)), 120);
+    ASSERT(tuner.lastDecision() == TicketTuner::Decision::kDecrease);
+
+    ASSERT_EQ(tuner.tune(120, makeSample(1000, 100, true)), 120);
+    ASSERT(tuner.lastDecision() == TicketTuner::Decision::kHold);
+}
 }  // namespace
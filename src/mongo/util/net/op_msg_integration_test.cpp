@@ -85,6 +85,53 @@ TEST(OpMsg, FireAndForgetInsertWorks) {
     ASSERT_EQ(conn->count("test.collection"), 1u);
 }
 
+TEST(OpMsg, ExhaustFindStreamsAllBatches) {
+    std::string errMsg;
+    auto conn = std::unique_ptr<DBClientBase>(
+        unittest::getFixtureConnectionString().connect("integration_test", errMsg));
+    uassert(ErrorCodes::SocketException, errMsg, conn);
+
+    conn->dropCollection("test.exhaust");
+    for (int i = 0; i < 5; i++) {
+        conn->insert("test.exhaust", BSON("_id" << i));
+    }
+
+    auto request = OpMsgRequest::fromDBAndBody("test",
+                                               BSON("find"
+                                                    << "exhaust"
+                                                    << "batchSize"
+                                                    << 2))
+                       .serialize();
+    OpMsg::setFlag(&request, OpMsg::kExhaustSupported);
+
+    Message reply;
+    ASSERT(conn->call(request, reply));
+
+    // The server keeps sending batches, each one answering the previous reply, until the cursor
+    // is exhausted.
+    int numBatches = 1;
+    int numDocs = 0;
+    while (true) {
+        auto body = OpMsg::parse(reply).body;
+        uassertStatusOK(getStatusFromCommandResult(body));
+        auto cursor = body["cursor"].Obj();
+        auto batch = cursor.hasField("firstBatch") ? cursor["firstBatch"] : cursor["nextBatch"];
+        numDocs += batch.Obj().nFields();
+
+        if (!OpMsg::isFlagSet(reply, OpMsg::kMoreToCome)) {
+            ASSERT_EQ(cursor["id"].numberLong(), 0);
+            break;
+        }
+
+        auto lastId = reply.header().getId();
+        ASSERT(conn->recv(reply, lastId));
+        numBatches++;
+    }
+
+    ASSERT_EQ(numDocs, 5);
+    ASSERT_EQ(numBatches, 3);
+}
+
 TEST(OpMsg, CloseConnectionOnFireAndForgetNotMasterError) {
     const auto connStr = unittest::getFixtureConnectionString();
 
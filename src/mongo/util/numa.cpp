@@ -0,0 +1,322 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaAwareThreadPlacement, bool, false);
+
+namespace {
+
+constexpr auto kDefaultNodeRoot = "/sys/devices/system/node";
+
+#ifdef __linux__
+// From <numaif.h>, which is only available where libnuma is installed. A preferred policy with an
+// empty node mask means "allocate on the node the thread is running on".
+constexpr int kMpolPreferred = 1;
+#endif
+
+bool readFirstLine(const std::string& path, std::string* line) {
+    std::ifstream in(path);
+    return in && std::getline(in, *line);
+}
+
+/**
+ * Counts the thread as bound to a node until it exits or gets bound to another node.
+ */
+class BoundThreadRegistration {
+public:
+    ~BoundThreadRegistration() {
+        reset(nullptr);
+    }
+
+    void reset(AtomicWord<int>* boundThreads) {
+        if (_boundThreads)
+            _boundThreads->subtractAndFetch(1);
+        _boundThreads = boundThreads;
+        if (_boundThreads)
+            _boundThreads->addAndFetch(1);
+    }
+
+private:
+    AtomicWord<int>* _boundThreads = nullptr;
+};
+
+thread_local BoundThreadRegistration boundThreadRegistration;
+
+}  // namespace
+
+StatusWith<std::vector<int>> NumaTopology::parseCpuList(StringData cpuList) {
+    std::vector<int> cpus;
+
+    auto parseNumber = [&](StringData str) -> StatusWith<int> {
+        if (str.empty() || str.size() > 9 ||
+            !std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid CPU number '" << str << "' in CPU list '" << cpuList
+                                  << "'"};
+        }
+        return std::stoi(str.toString());
+    };
+
+    StringData remaining = cpuList;
+    while (!remaining.empty() && (remaining.endsWith("\n") || remaining.endsWith(" "))) {
+        remaining = remaining.substr(0, remaining.size() - 1);
+    }
+
+    while (!remaining.empty()) {
+        const auto comma = remaining.find(',');
+        const auto range = remaining.substr(0, comma);
+        remaining = comma == std::string::npos ? StringData() : remaining.substr(comma + 1);
+
+        const auto dash = range.find('-');
+        auto first = parseNumber(range.substr(0, dash));
+        if (!first.isOK())
+            return first.getStatus();
+
+        int last = first.getValue();
+        if (dash != std::string::npos) {
+            auto swLast = parseNumber(range.substr(dash + 1));
+            if (!swLast.isOK())
+                return swLast.getStatus();
+            last = swLast.getValue();
+        }
+
+        if (last < first.getValue()) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid CPU range '" << range << "' in CPU list '" << cpuList
+                                  << "'"};
+        }
+
+        for (int cpu = first.getValue(); cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+NumaTopology NumaTopology::discover(const std::string& nodeRoot) {
+    NumaTopology topology;
+    topology._nodeRoot = nodeRoot;
+
+    try {
+        namespace fs = boost::filesystem;
+        if (fs::is_directory(nodeRoot)) {
+            for (fs::directory_iterator it(nodeRoot), end; it != end; ++it) {
+                const auto name = it->path().filename().string();
+                if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                    name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                    continue;
+                }
+
+                std::string cpuList;
+                if (!readFirstLine((it->path() / "cpulist").string(), &cpuList))
+                    continue;
+
+                auto swCpus = parseCpuList(cpuList);
+                if (!swCpus.isOK()) {
+                    warning() << "Ignoring NUMA node " << name << ": " << swCpus.getStatus();
+                    continue;
+                }
+
+                // Nodes without CPUs (memory-only nodes) cannot have threads placed on them.
+                if (swCpus.getValue().empty())
+                    continue;
+
+                auto node = stdx::make_unique<Node>();
+                node->id = std::stoi(name.substr(4));
+                node->cpus = std::move(swCpus.getValue());
+                topology._nodes.push_back(std::move(node));
+            }
+        }
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        warning() << "Unable to discover the NUMA topology from " << nodeRoot << ": "
+                  << ex.what();
+        topology._nodes.clear();
+    }
+
+    if (topology._nodes.empty()) {
+        auto node = stdx::make_unique<Node>();
+        node->id = 0;
+        for (int cpu = 0; cpu < static_cast<int>(stdx::thread::hardware_concurrency()); cpu++) {
+            node->cpus.push_back(cpu);
+        }
+        topology._nodes.push_back(std::move(node));
+    }
+
+    std::sort(topology._nodes.begin(),
+              topology._nodes.end(),
+              [](const std::unique_ptr<Node>& a, const std::unique_ptr<Node>& b) {
+                  return a->id < b->id;
+              });
+
+    for (size_t i = 0; i < topology._nodes.size(); i++) {
+        for (int cpu : topology._nodes[i]->cpus) {
+            if (static_cast<size_t>(cpu) >= topology._cpuToNodeIndex.size())
+                topology._cpuToNodeIndex.resize(cpu + 1, -1);
+            topology._cpuToNodeIndex[cpu] = static_cast<int>(i);
+        }
+    }
+
+    return topology;
+}
+
+const NumaTopology& NumaTopology::get() {
+    // Intentionally leaked, because the threads bound through it may exit after static destruction.
+    static const NumaTopology* topology = [] {
+        auto discovered = discover(kDefaultNodeRoot);
+        log() << "Discovered " << discovered.numNodes() << " NUMA node(s)";
+        return new NumaTopology(std::move(discovered));
+    }();
+    return *topology;
+}
+
+int NumaTopology::nodeIndexOfCpu(int cpu) const {
+    if (cpu < 0 || static_cast<size_t>(cpu) >= _cpuToNodeIndex.size())
+        return -1;
+    return _cpuToNodeIndex[cpu];
+}
+
+int NumaTopology::currentNodeIndex() const {
+#ifdef __linux__
+    return nodeIndexOfCpu(sched_getcpu());
+#else
+    return _nodes.size() == 1 ? 0 : -1;
+#endif
+}
+
+StatusWith<int> NumaTopology::bindCurrentThreadToNode(size_t nodeIndex) const {
+    invariant(!_nodes.empty());
+    const auto index = nodeIndex % _nodes.size();
+    auto& node = *_nodes[index];
+
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : node.cpus) {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpus);
+    }
+
+    const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err != 0) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Unable to bind thread to NUMA node " << node.id << ": "
+                              << errnoWithDescription(err)};
+    }
+
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, nullptr, 0) != 0) {
+        // The thread still runs on the node, so its memory is local unless the process policy
+        // says otherwise.
+        warning() << "Unable to set a node-local memory policy for thread on NUMA node " << node.id
+                  << ": " << errnoWithDescription();
+    }
+#else
+    if (_nodes.size() > 1) {
+        return {ErrorCodes::InternalErrorNotSupported,
+                "Binding threads to NUMA nodes is not supported on this platform"};
+    }
+#endif
+
+    boundThreadRegistration.reset(&node.boundThreads);
+    return static_cast<int>(index);
+}
+
+void NumaTopology::appendStats(BSONObjBuilder* bob) const {
+    bob->append("placementEnabled", numaAwareThreadPlacement);
+    bob->append("numNodes", static_cast<int>(_nodes.size()));
+
+    long long totalLocal = 0;
+    long long totalRemote = 0;
+    bool haveAllocationStats = false;
+
+    BSONArrayBuilder nodesBuilder(bob->subarrayStart("nodes"));
+    for (const auto& node : _nodes) {
+        BSONObjBuilder nodeBuilder(nodesBuilder.subobjStart());
+        nodeBuilder.append("id", node->id);
+        nodeBuilder.append("cpus", static_cast<int>(node->cpus.size()));
+        nodeBuilder.append("boundThreads", node->boundThreads.load());
+
+        // numastat counts pages allocated by every process on the host: local_node are pages
+        // allocated on this node by threads running on it, other_node are pages allocated here by
+        // threads running on another node.
+        std::ifstream numastat(str::stream() << _nodeRoot << "/node" << node->id << "/numastat");
+        std::string key;
+        long long value;
+        long long local = -1;
+        long long remote = -1;
+        while (numastat >> key >> value) {
+            if (key == "local_node")
+                local = value;
+            else if (key == "other_node")
+                remote = value;
+        }
+
+        if (local >= 0 && remote >= 0) {
+            haveAllocationStats = true;
+            nodeBuilder.append("localAllocations", local);
+            nodeBuilder.append("remoteAllocations", remote);
+            if (local + remote > 0)
+                nodeBuilder.append("localRatio", static_cast<double>(local) / (local + remote));
+            totalLocal += local;
+            totalRemote += remote;
+        }
+    }
+    nodesBuilder.done();
+
+    if (haveAllocationStats && totalLocal + totalRemote > 0) {
+        bob->append("localRatio", static_cast<double>(totalLocal) / (totalLocal + totalRemote));
+    }
+}
+
+}  // namespace mongo
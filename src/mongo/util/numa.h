@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Whether worker threads of the service executors and the replication writer pool are spread
+ * across the NUMA nodes of the host and restricted to the CPUs and memory of their node.
+ */
+extern bool numaAwareThreadPlacement;
+
+/**
+ * The NUMA nodes of the host and the CPUs that belong to each of them, as reported under
+ * /sys/devices/system/node. Hosts without NUMA support, or platforms other than Linux, are
+ * described as a single node that contains every CPU.
+ */
+class NumaTopology {
+public:
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+
+        // Number of threads currently bound to this node through bindCurrentThreadToNode(). A
+        // thread stops counting when it exits or gets bound to another node.
+        AtomicWord<int> boundThreads{0};
+    };
+
+    /**
+     * Returns the topology of this host, which is discovered the first time it is needed.
+     */
+    static const NumaTopology& get();
+
+    /**
+     * Discovers the topology from a sysfs tree rooted at 'nodeRoot', normally
+     * "/sys/devices/system/node".
+     */
+    static NumaTopology discover(const std::string& nodeRoot);
+
+    /**
+     * Parses a kernel CPU list such as "0-3,8-11" into the individual CPU numbers.
+     */
+    static StatusWith<std::vector<int>> parseCpuList(StringData cpuList);
+
+    size_t numNodes() const {
+        return _nodes.size();
+    }
+
+    /**
+     * True if the host has more than one node, i.e. placement makes a difference.
+     */
+    bool isNuma() const {
+        return _nodes.size() > 1;
+    }
+
+    const std::vector<std::unique_ptr<Node>>& nodes() const {
+        return _nodes;
+    }
+
+    /**
+     * Returns the index into nodes() of the node that owns 'cpu', or -1 if it is not known.
+     */
+    int nodeIndexOfCpu(int cpu) const;
+
+    /**
+     * Returns the index into nodes() of the node the calling thread is currently running on, or
+     * -1 if it cannot be determined.
+     */
+    int currentNodeIndex() const;
+
+    /**
+     * Restricts the calling thread to the CPUs of nodes()[nodeIndex % numNodes()] and makes its
+     * future memory allocations come from the node it runs on, so that per-thread caches (the
+     * allocator's thread cache, the thread's Client and its storage engine session) stay local
+     * even if the process as a whole was started with interleaved memory. Returns the index of
+     * the node the thread was bound to. The topology must outlive the thread.
+     */
+    StatusWith<int> bindCurrentThreadToNode(size_t nodeIndex) const;
+
+    /**
+     * Appends the topology and, where the kernel exposes them, per-node counts of local and remote
+     * memory allocations.
+     */
+    void appendStats(BSONObjBuilder* bob) const;
+
+private:
+    std::vector<std::unique_ptr<Node>> _nodes;
+    std::vector<int> _cpuToNodeIndex;
+    std::string _nodeRoot;
+};
+
+}  // namespace mongo
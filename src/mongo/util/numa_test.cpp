@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/numa.h"
+
+namespace mongo {
+namespace {
+
+void writeFile(const boost::filesystem::path& path, const std::string& contents) {
+    boost::filesystem::create_directories(path.parent_path());
+    std::ofstream out(path.string());
+    out << contents;
+}
+
+TEST(NumaTopology, ParseCpuList) {
+    ASSERT(NumaTopology::parseCpuList("0").getValue() == std::vector<int>({0}));
+    ASSERT(NumaTopology::parseCpuList("0-3,8-9,12\n").getValue() ==
+           std::vector<int>({0, 1, 2, 3, 8, 9, 12}));
+    ASSERT(NumaTopology::parseCpuList("\n").getValue().empty());
+
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("3-1").getStatus());
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("0,,1").getStatus());
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("a-b").getStatus());
+}
+
+TEST(NumaTopology, DiscoverFromSysfs) {
+    unittest::TempDir root("numa_test");
+    const boost::filesystem::path nodeRoot(root.path());
+    writeFile(nodeRoot / "node1" / "cpulist", "4-7\n");
+    writeFile(nodeRoot / "node0" / "cpulist", "0-3\n");
+    writeFile(nodeRoot / "node0" / "numastat", "numa_hit 100\nlocal_node 30\nother_node 10\n");
+    // Memory-only nodes and unrelated entries are skipped.
+    writeFile(nodeRoot / "node2" / "cpulist", "\n");
+    writeFile(nodeRoot / "possible", "0-2\n");
+
+    auto topology = NumaTopology::discover(root.path());
+    ASSERT_EQ(topology.numNodes(), 2u);
+    ASSERT(topology.isNuma());
+    ASSERT_EQ(topology.nodes()[0]->id, 0);
+    ASSERT_EQ(topology.nodes()[1]->id, 1);
+    ASSERT_EQ(topology.nodeIndexOfCpu(2), 0);
+    ASSERT_EQ(topology.nodeIndexOfCpu(5), 1);
+    ASSERT_EQ(topology.nodeIndexOfCpu(8), -1);
+
+    BSONObjBuilder bob;
+    topology.appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats["numNodes"].numberInt(), 2);
+    ASSERT_EQ(stats["nodes"].Array()[0]["localAllocations"].numberLong(), 30);
+    ASSERT_EQ(stats["nodes"].Array()[0]["remoteAllocations"].numberLong(), 10);
+    ASSERT_EQ(stats["localRatio"].numberDouble(), 0.75);
+}
+
+TEST(NumaTopology, MissingSysfsIsASingleNode) {
+    unittest::TempDir root("numa_test");
+    auto topology = NumaTopology::discover(root.path() + "/missing");
+    ASSERT_EQ(topology.numNodes(), 1u);
+    ASSERT_FALSE(topology.isNuma());
+}
+
+TEST(NumaTopology, BoundThreadsStopCountingWhenTheyExit) {
+    unittest::TempDir root("numa_test");
+    auto topology = NumaTopology::discover(root.path() + "/missing");
+    auto& node = *topology.nodes()[0];
+
+    stdx::thread([&] {
+        ASSERT_OK(topology.bindCurrentThreadToNode(0).getStatus());
+        ASSERT_EQ(node.boundThreads.load(), 1);
+
+        // Binding the thread again doesn't count it twice.
+        ASSERT_OK(topology.bindCurrentThreadToNode(0).getStatus());
+        ASSERT_EQ(node.boundThreads.load(), 1);
+    }).join();
+
+    ASSERT_EQ(node.boundThreads.load(), 0);
+}
+
+}  // namespace
+}  // namespace mongo
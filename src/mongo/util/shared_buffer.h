@@ -203,4 +203,43 @@ private:
 inline void swap(ConstSharedBuffer& one, ConstSharedBuffer& two) {
     one.swap(two);
 }
+
+/**
+ * A range of bytes within a ConstSharedBuffer, which keeps the whole buffer alive.
+ *
+ * A list of fragments describes data that is scattered over several buffers, so that it can be
+ * handed to a gathering write, or kept pinned until the kernel is done with it, without first
+ * being copied into one contiguous buffer.
+ */
+class ConstSharedBufferFragment {
+public:
+    ConstSharedBufferFragment(ConstSharedBuffer buffer, size_t offset, size_t size)
+        : _buffer(std::move(buffer)), _offset(offset), _size(size) {}
+
+    const char* data() const {
+        return _buffer.get() + _offset;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    const ConstSharedBuffer& buffer() const {
+        return _buffer;
+    }
+
+    /**
+     * Drops the first 'bytes' bytes from the fragment.
+     */
+    void advance(size_t bytes) {
+        invariant(bytes <= _size);
+        _offset += bytes;
+        _size -= bytes;
+    }
+
+private:
+    ConstSharedBuffer _buffer;
+    size_t _offset;
+    size_t _size;
+};
 }